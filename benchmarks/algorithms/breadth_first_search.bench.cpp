@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::any_node_store;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+void BM_BreadthFirstSearch(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  long visited = 0;
+  for (auto _ : state) {
+    dads::graphs::breadth_first_search(
+        G, 0, [&visited](int /*parent*/, int /*node*/) { visited++; });
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_BreadthFirstSearch)->Apply(bench::sizes_and_shapes);
+
+// a point query, which stops as soon as it reaches a node close to the
+// source, instead of walking everything that can be reached like
+// BreadthFirstSearch does
+void BM_BFSPointQuery(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  // the 100th node the search finds
+  std::vector<int> order;
+  dads::graphs::breadth_first_search(
+      G, 0, [&order](int /*parent*/, int node) { order.push_back(node); });
+  const int goal = order.empty() ? 0 : order[std::min<std::size_t>(
+                                           order.size() - 1, 99)];
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::breadth_first_search(
+        G, 0, [goal](int /*parent*/, int node) {
+          return node == goal ? dads::graphs::visit_control::stop
+                              : dads::graphs::visit_control::proceed;
+        }));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BFSPointQuery)->Apply(bench::sizes_and_shapes);
+
+// "how many hops from A to B", for random pairs of nodes, which used to take
+// a bfs_shortest_reach from A over the whole graph, see BM_BFSShortestReach
+void BM_BidirectionalBFS(benchmark::State &state) {
+  const int nodes = state.range(0);
+  const auto edges = bench::make_edges(bench::shape_arg(state), nodes);
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  std::mt19937 rng(nodes);
+  std::uniform_int_distribution<int> pick(0, nodes - 1);
+  std::vector<std::pair<int, int>> queries(64);
+  for (auto &[a, b] : queries) {
+    a = pick(rng);
+    b = pick(rng);
+  }
+
+  // the in-edges are indexed once, before the queries
+  G.keep_in_edges();
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto [a, b] = queries[i++ % queries.size()];
+    benchmark::DoNotOptimize(dads::graphs::bidirectional_bfs(G, a, b));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BidirectionalBFS)->Apply(bench::sizes_and_shapes);
+
+void BM_BFSShortestReach(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::bfs_shortest_reach(G, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_BFSShortestReach)->Apply(bench::sizes_and_shapes);
+
+// the flat-array version of BM_BFSShortestReach, the generated graphs have
+// dense ids
+void BM_BFSDistances(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::bfs_distances(G, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_BFSDistances)->Apply(bench::sizes_and_shapes);
+
+void BM_BreadthFirstSearch_CSR(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+
+  long visited = 0;
+  for (auto _ : state) {
+    dads::graphs::breadth_first_search(
+        G, 0, [&visited](int /*parent*/, int /*node*/) { visited++; });
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_BreadthFirstSearch_CSR)->Apply(bench::sizes_and_shapes);
+
+// the same traversal as BM_BreadthFirstSearch, but through the type-erased
+// store, where every call is virtual and the edges of each node are copied out
+void BM_BreadthFirstSearch_AnyNodeStore(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<any_node_store> G{any_node_store(adjacency_list())};
+  bench::fill_graph(G, edges);
+
+  long visited = 0;
+  for (auto _ : state) {
+    dads::graphs::breadth_first_search(
+        G, 0, [&visited](int /*parent*/, int /*node*/) { visited++; });
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_BreadthFirstSearch_AnyNodeStore)->Apply(bench::sizes_and_shapes);
+
+}  // namespace
@@ -0,0 +1,94 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <algorithms/connected_components.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+// the edges of a shape in both directions, so the components are the same
+// whichever way they are found
+graph<csr_graph> symmetric_graph(benchmark::State &state) {
+  auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  const std::size_t m = edges.size();
+  for (std::size_t i = 0; i < m; i++) {
+    const auto [u, v, w] = edges[i];
+    edges.emplace_back(v, u, w);
+  }
+  return graph<csr_graph>{csr_graph(std::move(edges))};
+}
+
+// what there was before, a search from every node that has not been seen
+void BM_ComponentsBySearching(benchmark::State &state) {
+  const auto G = symmetric_graph(state);
+  const int n = G.id_bound();
+
+  for (auto _ : state) {
+    std::vector<int> component(n, -1);
+    dads::graphs::seen_set seen(n);
+    for (int s = 0; s < n; s++) {
+      if (seen.contains(s)) {
+        continue;
+      }
+      component[s] = s;
+      dads::graphs::breadth_first_search(
+          G, s,
+          [&component, s](int /*parent*/, int node) { component[node] = s; },
+          seen);
+    }
+    benchmark::DoNotOptimize(component.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * G.id_bound());
+}
+BENCHMARK(BM_ComponentsBySearching)->Apply(bench::sizes_and_shapes);
+
+// afforest on one thread, and on every core, with and without skipping the
+// big component
+template <int Threads, bool Symmetric>
+void BM_ConnectedComponents(benchmark::State &state) {
+  const auto G = symmetric_graph(state);
+  dads::utils::thread_pool pool(
+      Threads > 0 ? Threads : std::thread::hardware_concurrency());
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        dads::graphs::connected_components(G, pool, Symmetric));
+  }
+
+  state.SetItemsProcessed(state.iterations() * G.id_bound());
+}
+BENCHMARK_TEMPLATE(BM_ConnectedComponents, 1, false)
+    ->Apply(bench::sizes_and_shapes);
+BENCHMARK_TEMPLATE(BM_ConnectedComponents, 1, true)
+    ->Apply(bench::sizes_and_shapes);
+BENCHMARK_TEMPLATE(BM_ConnectedComponents, 0, true)
+    ->Apply(bench::sizes_and_shapes)
+    ->UseRealTime();
+
+void BM_StronglyConnectedComponents(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::strongly_connected_components(G));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_StronglyConnectedComponents)->Apply(bench::sizes_and_shapes);
+
+}  // namespace
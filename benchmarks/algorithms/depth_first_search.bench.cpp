@@ -0,0 +1,101 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/depth_first_search.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::any_node_store;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+void BM_DepthFirstSearch(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  long visited = 0;
+  for (auto _ : state) {
+    dads::graphs::depth_first_search(
+        G, 0, [&visited](int /*parent*/, int /*node*/) { visited++; });
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DepthFirstSearch)->Apply(bench::sizes_and_shapes);
+
+void BM_DFSShortestReach(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::dfs_shortest_reach(G, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DFSShortestReach)->Apply(bench::sizes_and_shapes);
+
+// the flat-array version of BM_DFSShortestReach, the generated graphs have
+// dense ids
+void BM_DFSDistances(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::dfs_distances(G, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DFSDistances)->Apply(bench::sizes_and_shapes);
+
+void BM_DepthFirstSearch_CSR(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+
+  long visited = 0;
+  for (auto _ : state) {
+    dads::graphs::depth_first_search(
+        G, 0, [&visited](int /*parent*/, int /*node*/) { visited++; });
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DepthFirstSearch_CSR)->Apply(bench::sizes_and_shapes);
+
+// the same traversal as BM_DepthFirstSearch, but through the type-erased
+// store, where every call is virtual and the edges of each node are copied out
+void BM_DepthFirstSearch_AnyNodeStore(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<any_node_store> G{any_node_store(adjacency_list())};
+  bench::fill_graph(G, edges);
+
+  long visited = 0;
+  for (auto _ : state) {
+    dads::graphs::depth_first_search(
+        G, 0, [&visited](int /*parent*/, int /*node*/) { visited++; });
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DepthFirstSearch_AnyNodeStore)->Apply(bench::sizes_and_shapes);
+
+}  // namespace
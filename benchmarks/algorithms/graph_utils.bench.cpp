@@ -0,0 +1,113 @@
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/graph_utils.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+void BM_ToCsv(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    const std::string csv = dads::graphs::to_csv(G);
+    bytes = csv.size();
+    benchmark::DoNotOptimize(csv.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ToCsv)->Apply(bench::sizes_and_shapes);
+
+// streams the text into a sink that drops it, so only the formatting is
+// measured, not the growth of a string
+template <dads::graphs::csv_order Order>
+void BM_WriteCsv(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    bytes = 0;
+    dads::graphs::write_csv(
+        G, [&bytes](const char *data, std::size_t size) {
+          benchmark::DoNotOptimize(data);
+          bytes += size;
+        },
+        ' ', Order);
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK_TEMPLATE(BM_WriteCsv, dads::graphs::csv_order::sorted)
+    ->Apply(bench::sizes_and_shapes);
+BENCHMARK_TEMPLATE(BM_WriteCsv, dads::graphs::csv_order::unsorted)
+    ->Apply(bench::sizes_and_shapes);
+
+void BM_FromCsv(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  std::string csv;
+  {
+    graph<adjacency_list> G;
+    bench::fill_graph(G, edges);
+    csv = dads::graphs::to_csv(G);
+  }
+
+  for (auto _ : state) {
+    auto G = dads::graphs::from_csv<graph<adjacency_list>>(csv);
+    benchmark::DoNotOptimize(G.get());
+
+    // do not measure the teardown of the graph
+    state.PauseTiming();
+    G.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * csv.size());
+}
+BENCHMARK(BM_FromCsv)->Apply(bench::sizes_and_shapes);
+
+// the parsing part of FromCsv, on one thread, and on every core
+template <int Threads>
+void BM_ParseEdges(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  std::string csv;
+  {
+    graph<adjacency_list> G;
+    bench::fill_graph(G, edges);
+    csv = dads::graphs::to_csv(G);
+  }
+  dads::utils::thread_pool pool(
+      Threads > 0 ? Threads : std::thread::hardware_concurrency());
+
+  for (auto _ : state) {
+    auto parsed = dads::graphs::parse_edges(csv, ' ', pool);
+    benchmark::DoNotOptimize(parsed.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * csv.size());
+}
+BENCHMARK_TEMPLATE(BM_ParseEdges, 1)->Apply(bench::sizes_and_shapes);
+BENCHMARK_TEMPLATE(BM_ParseEdges, 0)
+    ->Apply(bench::sizes_and_shapes)
+    ->UseRealTime();
+
+}  // namespace
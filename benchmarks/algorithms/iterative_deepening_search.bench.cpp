@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <algorithms/iterative_deepening_search.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+// the depth used by the benchmarks that are not about depth
+constexpr int max_depth = 6;
+
+void BM_IterativeDeepeningBFS(benchmark::State &state) {
+  const int nodes = state.range(0);
+  const auto edges = bench::make_edges(bench::shape_arg(state), nodes);
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  // the last node is rarely within the depth bound, so this measures the
+  // cost of exhausting every round
+  const int goal = nodes - 1;
+
+  long visited = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::iterative_deepening_bfs(
+        G, 0, goal, max_depth,
+        [&visited](int /*parent*/, int /*node*/) { visited++; }));
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(visited);
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_IterativeDeepeningBFS)->Apply(bench::sizes_and_shapes);
+
+// a goal that is within the depth bound, where the search ends as soon as
+// it is visited, instead of finishing the round it was found in
+void BM_IterativeDeepeningBFS_NearGoal(benchmark::State &state) {
+  const int nodes = state.range(0);
+  const auto edges = bench::make_edges(bench::shape_arg(state), nodes);
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  // the 100th node a breadth first search finds, a few edges out
+  std::vector<int> order;
+  dads::graphs::breadth_first_search(
+      G, 0, [&order](int /*parent*/, int node) { order.push_back(node); });
+  const int goal = order.empty() ? 0 : order[std::min<std::size_t>(
+                                           order.size() - 1, 99)];
+
+  long visited = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::iterative_deepening_bfs(
+        G, 0, goal, max_depth,
+        [&visited](int /*parent*/, int /*node*/) { visited++; }));
+  }
+  benchmark::DoNotOptimize(visited);
+
+  state.SetItemsProcessed(visited);
+}
+BENCHMARK(BM_IterativeDeepeningBFS_NearGoal)->Apply(bench::sizes_and_shapes);
+
+// a goal that can not be reached, with no depth bound, so the search goes
+// as deep as the graph does, on the grid and chain shapes hundreds or
+// thousands of levels. compare with BM_BreadthFirstSearch
+void BM_IterativeDeepeningBFS_Unbounded(benchmark::State &state) {
+  const int nodes = state.range(0);
+  const auto edges = bench::make_edges(bench::shape_arg(state), nodes);
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::iterative_deepening_bfs(
+        G, 0, -1, nodes, [](int /*parent*/, int /*node*/) {}));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_IterativeDeepeningBFS_Unbounded)->Apply(bench::sizes_and_shapes);
+
+}  // namespace
@@ -0,0 +1,50 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/parallel_breadth_first_search.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+void BM_DirectionOptimizingBFS(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+  G.keep_in_edges();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::direction_optimizing_bfs(G, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DirectionOptimizingBFS)->Apply(bench::sizes_and_shapes);
+
+void BM_DirectionOptimizingBFS_CSR(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+  // built once, and shared by every search
+  const auto reverse = dads::graphs::transpose(G);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        dads::graphs::direction_optimizing_bfs(G, *reverse, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DirectionOptimizingBFS_CSR)->Apply(bench::sizes_and_shapes);
+
+}  // namespace
@@ -0,0 +1,79 @@
+#include <memory>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithms/shortest_paths.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <graph_generators.hpp>
+
+using dads::graphs::csr_graph;
+using dads::graphs::dijkstra_heap;
+using dads::graphs::graph;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+void BM_Dijkstra_RadixHeap(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        dads::graphs::dijkstra(G, 0, dijkstra_heap::radix));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_Dijkstra_RadixHeap)->Apply(bench::sizes_and_shapes);
+
+void BM_Dijkstra_DAryHeap(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        dads::graphs::dijkstra(G, 0, dijkstra_heap::d_ary));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_Dijkstra_DAryHeap)->Apply(bench::sizes_and_shapes);
+
+void BM_DeltaStepping(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::delta_stepping(G, 0));
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_DeltaStepping)->Apply(bench::sizes_and_shapes);
+
+// point-to-point queries between random pairs of nodes, the reverse graph is
+// built once up front, like it would be for a stream of queries
+void BM_BidirectionalDijkstra(benchmark::State &state) {
+  const int nodes = state.range(0);
+  const auto edges = bench::make_edges(bench::shape_arg(state), nodes);
+  graph<csr_graph> G{csr_graph(edges)};
+  const auto reverse = dads::graphs::transpose(G);
+
+  std::mt19937 rng(nodes);
+  std::uniform_int_distribution<int> pick(0, G.id_bound() - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dads::graphs::bidirectional_dijkstra(
+        G, *reverse, pick(rng), pick(rng)));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BidirectionalDijkstra)->Apply(bench::sizes_and_shapes);
+
+}  // namespace
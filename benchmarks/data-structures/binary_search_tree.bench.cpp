@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <data-structures/binary_search_tree.hpp>
+#include <graph_generators.hpp>
+#include <utils/node_allocator.hpp>
+
+using dads::trees::avl_tree;
+using dads::trees::binary_search_tree;
+namespace augment = dads::trees::augment;
+namespace balance = dads::trees::balance;
+using dads::utils::heap_allocator;
+using dads::utils::pool_allocator;
+
+namespace {
+
+// a random permutation of 0..n-1, random insertion order keeps the
+// unbalanced tree at an expected depth of O(log n)
+std::vector<int> shuffled_keys(int n) {
+  std::vector<int> keys(n);
+  std::iota(std::begin(keys), std::end(keys), 0);
+  std::shuffle(std::begin(keys), std::end(keys), std::mt19937(n));
+  return keys;
+}
+
+template <typename Tree>
+void fill_tree(Tree &bst, const std::vector<int> &keys) {
+  for (const int k : keys) {
+    bst.insert(k, k);
+  }
+}
+
+template <template <typename> class Allocator>
+void BM_BinarySearchTree_Insert(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+
+  for (auto _ : state) {
+    auto bst = std::make_unique<binary_search_tree<int, int, Allocator>>();
+    fill_tree(*bst, keys);
+    benchmark::DoNotOptimize(bst->size());
+
+    // do not measure the teardown of the tree
+    state.PauseTiming();
+    bst.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.SetBytesProcessed(state.iterations() * keys.size() * 2 * sizeof(int));
+}
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_Insert, heap_allocator)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_Insert, pool_allocator)
+    ->Apply(dads::benchmarks::sizes);
+
+// only the teardown of a filled tree is measured
+template <template <typename> class Allocator>
+void BM_BinarySearchTree_Destroy(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto bst = std::make_unique<binary_search_tree<int, int, Allocator>>();
+    fill_tree(*bst, keys);
+    state.ResumeTiming();
+
+    bst.reset();
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_Destroy, heap_allocator)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_Destroy, pool_allocator)
+    ->Apply(dads::benchmarks::sizes);
+
+// keys that arrive in order, like timestamps or sequential ids. the
+// unbalanced tree degenerates into a list, so it is quadratic, and only run up
+// to 1e5 keys
+template <typename Balance>
+void BM_BinarySearchTree_SortedInsert(benchmark::State &state) {
+  std::vector<int> keys(state.range(0));
+  std::iota(std::begin(keys), std::end(keys), 0);
+
+  for (auto _ : state) {
+    auto bst = std::make_unique<
+        binary_search_tree<int, int, pool_allocator, Balance>>();
+    fill_tree(*bst, keys);
+    benchmark::DoNotOptimize(bst->height());
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.SetBytesProcessed(state.iterations() * keys.size() * 2 * sizeof(int));
+}
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_SortedInsert, balance::none)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_SortedInsert, balance::avl)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_SortedInsert, balance::red_black)
+    ->Apply(dads::benchmarks::sizes);
+
+// building the tree from sorted (key, value) pairs in one go, compare with
+// inserting them one at a time, in SortedInsert and Insert
+void BM_BinarySearchTree_BulkLoad(benchmark::State &state) {
+  std::vector<std::pair<int, int>> elements;
+  for (int k = 0; k < state.range(0); k++) {
+    elements.emplace_back(k, k);
+  }
+
+  for (auto _ : state) {
+    auto bst = std::make_unique<binary_search_tree<int, int>>(
+        dads::trees::sorted_unique, std::begin(elements), std::end(elements));
+    benchmark::DoNotOptimize(bst->height());
+  }
+
+  state.SetItemsProcessed(state.iterations() * elements.size());
+  state.SetBytesProcessed(state.iterations() * elements.size() * 2 *
+                          sizeof(int));
+}
+BENCHMARK(BM_BinarySearchTree_BulkLoad)->Apply(dads::benchmarks::sizes);
+
+// the same, from pairs in random order, which have to be sorted first
+void BM_BinarySearchTree_BulkLoadUnsorted(benchmark::State &state) {
+  std::vector<std::pair<int, int>> elements;
+  for (const int k : shuffled_keys(state.range(0))) {
+    elements.emplace_back(k, k);
+  }
+
+  for (auto _ : state) {
+    auto bst = std::make_unique<binary_search_tree<int, int>>(
+        std::begin(elements), std::end(elements));
+    benchmark::DoNotOptimize(bst->height());
+  }
+
+  state.SetItemsProcessed(state.iterations() * elements.size());
+  state.SetBytesProcessed(state.iterations() * elements.size() * 2 *
+                          sizeof(int));
+}
+BENCHMARK(BM_BinarySearchTree_BulkLoadUnsorted)
+    ->Apply(dads::benchmarks::sizes);
+
+void BM_BinarySearchTree_Find(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  binary_search_tree<int, int> bst;
+  fill_tree(bst, keys);
+
+  // look the keys up in a different order than they were inserted
+  auto lookups = keys;
+  std::shuffle(std::begin(lookups), std::end(lookups), std::mt19937(1));
+
+  for (auto _ : state) {
+    for (const int k : lookups) {
+      benchmark::DoNotOptimize(bst.find(k));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * lookups.size());
+  state.SetBytesProcessed(state.iterations() * lookups.size() * sizeof(int));
+}
+BENCHMARK(BM_BinarySearchTree_Find)->Apply(dads::benchmarks::sizes);
+
+// string keys, long enough not to fit in the small string buffer, and
+// values that are expensive to copy
+std::vector<std::string> string_keys(int n) {
+  std::vector<std::string> keys;
+  for (const int k : shuffled_keys(n)) {
+    keys.push_back("some/fairly/long/path/to/key/" + std::to_string(k));
+  }
+  return keys;
+}
+
+void BM_BinarySearchTree_StringInsert(benchmark::State &state) {
+  const auto keys = string_keys(state.range(0));
+  const std::vector<int> payload(16, 1);
+
+  for (auto _ : state) {
+    auto bst =
+        std::make_unique<binary_search_tree<std::string, std::vector<int>>>();
+    for (const auto &k : keys) {
+      bst->try_emplace(k, payload);
+    }
+    benchmark::DoNotOptimize(bst->size());
+
+    state.PauseTiming();
+    bst.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_BinarySearchTree_StringInsert)->Apply(dads::benchmarks::sizes);
+
+// looks the keys up through string_views, so no strings are built
+void BM_BinarySearchTree_StringFind(benchmark::State &state) {
+  const auto keys = string_keys(state.range(0));
+  binary_search_tree<std::string, std::vector<int>> bst;
+  for (const auto &k : keys) {
+    bst.try_emplace(k, 16, 1);
+  }
+
+  std::vector<std::string_view> lookups(std::begin(keys), std::end(keys));
+  std::shuffle(std::begin(lookups), std::end(lookups), std::mt19937(1));
+
+  for (auto _ : state) {
+    for (const auto k : lookups) {
+      benchmark::DoNotOptimize(bst.find(k));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(BM_BinarySearchTree_StringFind)->Apply(dads::benchmarks::sizes);
+
+void BM_BinarySearchTree_Remove(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  auto removals = keys;
+  std::shuffle(std::begin(removals), std::end(removals), std::mt19937(1));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto bst = std::make_unique<binary_search_tree<int, int>>();
+    fill_tree(*bst, keys);
+    state.ResumeTiming();
+
+    for (const int k : removals) {
+      benchmark::DoNotOptimize(bst->remove(k));
+    }
+
+    state.PauseTiming();
+    bst.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * removals.size());
+  state.SetBytesProcessed(state.iterations() * removals.size() * sizeof(int));
+}
+BENCHMARK(BM_BinarySearchTree_Remove)->Apply(dads::benchmarks::sizes);
+
+void BM_BinarySearchTree_Inorder(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  binary_search_tree<int, int> bst;
+  fill_tree(bst, keys);
+
+  for (auto _ : state) {
+    long sum = 0;
+    bst.inorder([&sum](const int &, int &v) { sum += v; });
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.SetBytesProcessed(state.iterations() * keys.size() * 2 * sizeof(int));
+}
+BENCHMARK(BM_BinarySearchTree_Inorder)->Apply(dads::benchmarks::sizes);
+
+void BM_BinarySearchTree_Iterate(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  binary_search_tree<int, int> bst;
+  fill_tree(bst, keys);
+
+  for (auto _ : state) {
+    long sum = 0;
+    for (const auto &[k, v] : bst) {
+      sum += v;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.SetBytesProcessed(state.iterations() * keys.size() * 2 * sizeof(int));
+}
+BENCHMARK(BM_BinarySearchTree_Iterate)->Apply(dads::benchmarks::sizes);
+
+// scans of 100 keys, starting at random keys
+void BM_BinarySearchTree_Range(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  binary_search_tree<int, int> bst;
+  fill_tree(bst, keys);
+
+  const int scans = 1000;
+  const int length = 100;
+  for (auto _ : state) {
+    long sum = 0;
+    for (int i = 0; i < scans; i++) {
+      const int lo = keys[i % keys.size()];
+      bst.range(lo, lo + length, [&sum](const int &, int &v) { sum += v; });
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * scans * length);
+}
+BENCHMARK(BM_BinarySearchTree_Range)->Apply(dads::benchmarks::sizes);
+
+// what keeping the subtree sizes and sums up to date costs the inserts
+template <typename Augment>
+void BM_BinarySearchTree_AugmentedInsert(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+
+  for (auto _ : state) {
+    auto bst = std::make_unique<
+        avl_tree<int, int, pool_allocator, Augment>>();
+    fill_tree(*bst, keys);
+    benchmark::DoNotOptimize(bst->size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_AugmentedInsert, augment::none)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_AugmentedInsert, augment::order)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_BinarySearchTree_AugmentedInsert,
+                   augment::aggregate<augment::sum<long>>)
+    ->Apply(dads::benchmarks::sizes);
+
+// the 99th percentile key, by walking the tree in order, and by select
+void BM_BinarySearchTree_PercentileByWalk(benchmark::State &state) {
+  avl_tree<int, int> bst;
+  fill_tree(bst, shuffled_keys(state.range(0)));
+
+  for (auto _ : state) {
+    int i = 0;
+    const int target = bst.size() * 99 / 100;
+    for (auto it = bst.begin(); it != bst.end(); ++it, ++i) {
+      if (i == target) {
+        benchmark::DoNotOptimize(it->first);
+        break;
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BinarySearchTree_PercentileByWalk)
+    ->Apply(dads::benchmarks::sizes);
+
+void BM_BinarySearchTree_PercentileBySelect(benchmark::State &state) {
+  avl_tree<int, int, pool_allocator, augment::order> bst;
+  fill_tree(bst, shuffled_keys(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bst.select(bst.size() * 99 / 100)->first);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BinarySearchTree_PercentileBySelect)
+    ->Apply(dads::benchmarks::sizes);
+
+// sums of 100 keys, compare with Range, which visits them
+void BM_BinarySearchTree_AggregateRange(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  avl_tree<int, int, pool_allocator, augment::aggregate<augment::sum<long>>>
+      bst;
+  fill_tree(bst, keys);
+
+  const int scans = 1000;
+  const int length = 100;
+  for (auto _ : state) {
+    long sum = 0;
+    for (int i = 0; i < scans; i++) {
+      const int lo = keys[i % keys.size()];
+      sum += bst.aggregate_range(lo, lo + length);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * scans * length);
+}
+BENCHMARK(BM_BinarySearchTree_AggregateRange)->Apply(dads::benchmarks::sizes);
+
+}  // namespace
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <data-structures/binary_search_tree.hpp>
+#include <data-structures/btree.hpp>
+#include <graph_generators.hpp>
+
+using dads::trees::avl_tree;
+using dads::trees::binary_search_tree;
+using dads::trees::btree;
+
+namespace {
+
+std::vector<int> shuffled_keys(int n) {
+  std::vector<int> keys(n);
+  std::iota(std::begin(keys), std::end(keys), 0);
+  std::shuffle(std::begin(keys), std::end(keys), std::mt19937(n));
+  return keys;
+}
+
+template <typename Tree>
+void fill_tree(Tree &tree, const std::vector<int> &keys) {
+  for (const int k : keys) {
+    tree.insert(k, k);
+  }
+}
+
+template <typename Tree>
+void BM_OrderedMap_Insert(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+
+  for (auto _ : state) {
+    auto tree = std::make_unique<Tree>();
+    fill_tree(*tree, keys);
+    benchmark::DoNotOptimize(tree->size());
+
+    state.PauseTiming();
+    tree.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.SetBytesProcessed(state.iterations() * keys.size() * 2 * sizeof(int));
+}
+BENCHMARK_TEMPLATE(BM_OrderedMap_Insert, btree<int, int>)
+    ->Apply(dads::benchmarks::sizes);
+
+// random lookups of keys in the tree, compared against the binary search
+// trees, which take a cache miss for every level
+template <typename Tree>
+void BM_OrderedMap_Find(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  Tree tree;
+  fill_tree(tree, keys);
+
+  auto lookups = keys;
+  std::shuffle(std::begin(lookups), std::end(lookups), std::mt19937(1));
+
+  for (auto _ : state) {
+    for (const int k : lookups) {
+      benchmark::DoNotOptimize(tree.find(k));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * lookups.size());
+  state.SetBytesProcessed(state.iterations() * lookups.size() * sizeof(int));
+}
+BENCHMARK_TEMPLATE(BM_OrderedMap_Find, btree<int, int>)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_OrderedMap_Find, btree<int, int, 16>)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_OrderedMap_Find, btree<int, int, 256>)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_OrderedMap_Find, binary_search_tree<int, int>)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_OrderedMap_Find, avl_tree<int, int>)
+    ->Apply(dads::benchmarks::sizes);
+
+// scans a range of 1000 keys starting at random keys
+void BM_BTree_Range(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  btree<int, int> tree;
+  fill_tree(tree, keys);
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> pick(0, keys.size() - 1);
+  for (auto _ : state) {
+    const int lo = pick(rng);
+    long sum = 0;
+    tree.range(lo, lo + 1000, [&sum](int, int v) { sum += v; });
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_BTree_Range)->Apply(dads::benchmarks::sizes);
+
+}  // namespace
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <data-structures/binary_search_tree.hpp>
+#include <data-structures/concurrent_skip_list.hpp>
+
+using dads::trees::concurrent_skip_list;
+
+namespace {
+
+// what we had before: a balanced tree behind one lock
+class locked_tree {
+ private:
+  std::mutex mutex;
+  dads::trees::avl_tree<int, int> tree;
+
+ public:
+  bool insert(int key, int value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tree.insert(key, value);
+  }
+  bool remove(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tree.remove(key);
+  }
+  std::optional<int> find(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const int *value = tree.find(key);
+    return value != nullptr ? std::optional<int>(*value) : std::nullopt;
+  }
+};
+
+// the keys are drawn from [0, key_range), and half of them are in the map
+// when the benchmark starts, inserts and removes are balanced, so it stays
+// about half full
+constexpr int key_range = 1 << 20;
+constexpr int operations = 1000;
+
+// percentages of the operations that are finds, the rest are split evenly
+// between inserts and removes
+constexpr int read_heavy = 90;
+constexpr int write_heavy = 50;
+
+template <typename Map>
+std::unique_ptr<Map> shared_map;
+
+template <typename Map, int Reads>
+void BM_ConcurrentMap(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    shared_map<Map> = std::make_unique<Map>();
+    std::mt19937 rng(1);
+    for (int i = 0; i < key_range / 2; i++) {
+      shared_map<Map>->insert(rng() % key_range, i);
+    }
+  }
+
+  std::mt19937 rng(state.thread_index() + 1);
+  for (auto _ : state) {
+    for (int i = 0; i < operations; i++) {
+      const std::uint32_t r = rng();
+      const int key = r % key_range;
+      const int op = (r >> 20) % 100;
+      if (op < Reads) {
+        benchmark::DoNotOptimize(shared_map<Map>->find(key));
+      } else if (op % 2 == 0) {
+        benchmark::DoNotOptimize(shared_map<Map>->insert(key, op));
+      } else {
+        benchmark::DoNotOptimize(shared_map<Map>->remove(key));
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * operations);
+
+  if (state.thread_index() == 0) {
+    shared_map<Map>.reset();
+  }
+}
+BENCHMARK_TEMPLATE(BM_ConcurrentMap, locked_tree, read_heavy)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentMap, concurrent_skip_list<int, int>, read_heavy)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentMap, locked_tree, write_heavy)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentMap, concurrent_skip_list<int, int>,
+                   write_heavy)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
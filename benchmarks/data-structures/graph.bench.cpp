@@ -0,0 +1,229 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <data-structures/mapped_csr_graph.hpp>
+#include <graph_generators.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::adjacency_matrix;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+using dads::graphs::mapped_csr_graph;
+using dads::graphs::write_csr_file;
+
+namespace bench = dads::benchmarks;
+
+namespace {
+
+template <typename T>
+void construct(benchmark::State &state, int nodes, bench::shape shape) {
+  const auto edges = bench::make_edges(shape, nodes);
+
+  for (auto _ : state) {
+    auto G = std::make_unique<graph<T>>();
+    bench::fill_graph(*G, edges);
+    benchmark::DoNotOptimize(G.get());
+
+    // do not measure the teardown of the graph
+    state.PauseTiming();
+    G.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+
+template <typename T>
+void neighbours(benchmark::State &state, graph<T> &G,
+                const bench::edge_list &edges) {
+  const auto ns = G.nodes();
+
+  for (auto _ : state) {
+    for (const int n : ns) {
+      benchmark::DoNotOptimize(G.neighbours(n));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * edges.size() * sizeof(int));
+}
+
+// walks the same edges as neighbours(), through the non-allocating view
+template <typename T>
+void edges(benchmark::State &state, graph<T> &G, const bench::edge_list &es) {
+  const auto ns = G.nodes();
+
+  for (auto _ : state) {
+    long sum = 0;
+    for (const int n : ns) {
+      for (const auto e : G.edges(n)) {
+        sum += e.node + e.weight;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * es.size());
+  state.SetBytesProcessed(state.iterations() * es.size() * sizeof(int) * 2);
+}
+
+void BM_AdjacencyList_Construct(benchmark::State &state) {
+  construct<adjacency_list>(state, state.range(0), bench::shape_arg(state));
+}
+BENCHMARK(BM_AdjacencyList_Construct)->Apply(bench::sizes_and_shapes);
+
+// like Construct, with the whole batch handed to add_edges, on one thread,
+// and sharded over every core
+template <int Threads>
+void BM_AdjacencyList_AddEdges(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  dads::utils::thread_pool pool(
+      Threads > 0 ? Threads : std::thread::hardware_concurrency());
+
+  for (auto _ : state) {
+    auto G = std::make_unique<graph<adjacency_list>>();
+    G->add_edges(edges, pool);
+    benchmark::DoNotOptimize(G.get());
+
+    // do not measure the teardown of the graph
+    state.PauseTiming();
+    G.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK_TEMPLATE(BM_AdjacencyList_AddEdges, 1)
+    ->Apply(bench::sizes_and_shapes);
+BENCHMARK_TEMPLATE(BM_AdjacencyList_AddEdges, 0)
+    ->Apply(bench::sizes_and_shapes)
+    ->UseRealTime();
+
+void BM_AdjacencyList_Neighbours(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, edges);
+  neighbours(state, G, edges);
+}
+BENCHMARK(BM_AdjacencyList_Neighbours)->Apply(bench::sizes_and_shapes);
+
+void BM_AdjacencyList_Edges(benchmark::State &state) {
+  const auto es = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<adjacency_list> G;
+  bench::fill_graph(G, es);
+  edges(state, G, es);
+}
+BENCHMARK(BM_AdjacencyList_Edges)->Apply(bench::sizes_and_shapes);
+
+void BM_CSRGraph_Construct(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+
+  for (auto _ : state) {
+    graph<csr_graph> G{csr_graph(edges)};
+    benchmark::DoNotOptimize(&G);
+  }
+
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_CSRGraph_Construct)->Apply(bench::sizes_and_shapes);
+
+void BM_CSRGraph_Neighbours(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(edges)};
+  neighbours(state, G, edges);
+}
+BENCHMARK(BM_CSRGraph_Neighbours)->Apply(bench::sizes_and_shapes);
+
+void BM_CSRGraph_Edges(benchmark::State &state) {
+  const auto es = bench::make_edges(bench::shape_arg(state), state.range(0));
+  graph<csr_graph> G{csr_graph(es)};
+  edges(state, G, es);
+}
+BENCHMARK(BM_CSRGraph_Edges)->Apply(bench::sizes_and_shapes);
+
+// opening a graph saved in the csr file format, compare with Construct, which
+// builds it from an edge list. the file is in the page cache, so this is the
+// cost of mapping it, and of the page faults of walking every edge once
+void BM_MappedCSRGraph_Open(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), state.range(0));
+  const std::string path = "/tmp/dads_bench_mapped_csr_graph.csr";
+  write_csr_file(graph<csr_graph>{csr_graph(edges)}, path);
+
+  for (auto _ : state) {
+    graph<mapped_csr_graph> G{mapped_csr_graph(path)};
+    long sum = 0;
+    for (int n = 0; n < G.id_bound(); n++) {
+      for (const auto e : G.edges(n)) {
+        sum += e.weight;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations() * edges.size());
+  state.SetBytesProcessed(state.iterations() * bench::edge_bytes(edges));
+}
+BENCHMARK(BM_MappedCSRGraph_Open)->Apply(bench::sizes_and_shapes);
+
+void BM_MappedCSRGraph_Edges(benchmark::State &state) {
+  const auto es = bench::make_edges(bench::shape_arg(state), state.range(0));
+  const std::string path = "/tmp/dads_bench_mapped_csr_graph.csr";
+  write_csr_file(graph<csr_graph>{csr_graph(es)}, path);
+
+  graph<mapped_csr_graph> G{mapped_csr_graph(path)};
+  edges(state, G, es);
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_MappedCSRGraph_Edges)->Apply(bench::sizes_and_shapes);
+
+// the matrix size is a compile-time constant, and it takes N^2 space, so it
+// is only benchmarked for node counts that fit comfortably in memory
+template <std::size_t N>
+void BM_AdjacencyMatrix_Construct(benchmark::State &state) {
+  construct<adjacency_matrix<N>>(state, N, bench::shape_arg(state));
+}
+
+template <std::size_t N>
+void BM_AdjacencyMatrix_Neighbours(benchmark::State &state) {
+  const auto edges = bench::make_edges(bench::shape_arg(state), N);
+  graph<adjacency_matrix<N>> G;
+  bench::fill_graph(G, edges);
+  neighbours(state, G, edges);
+}
+
+template <std::size_t N>
+void BM_AdjacencyMatrix_Edges(benchmark::State &state) {
+  const auto es = bench::make_edges(bench::shape_arg(state), N);
+  graph<adjacency_matrix<N>> G;
+  bench::fill_graph(G, es);
+  edges(state, G, es);
+}
+
+void matrix_shapes(benchmark::internal::Benchmark *b) {
+  for (int s = 0; s < 4; s++) {
+    b->Args({0, s});
+  }
+  b->ArgNames({"", "shape"});
+  b->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(BM_AdjacencyMatrix_Construct, 1000)->Apply(matrix_shapes);
+BENCHMARK_TEMPLATE(BM_AdjacencyMatrix_Construct, 4000)->Apply(matrix_shapes);
+BENCHMARK_TEMPLATE(BM_AdjacencyMatrix_Neighbours, 1000)->Apply(matrix_shapes);
+BENCHMARK_TEMPLATE(BM_AdjacencyMatrix_Neighbours, 4000)->Apply(matrix_shapes);
+BENCHMARK_TEMPLATE(BM_AdjacencyMatrix_Edges, 1000)->Apply(matrix_shapes);
+BENCHMARK_TEMPLATE(BM_AdjacencyMatrix_Edges, 4000)->Apply(matrix_shapes);
+
+}  // namespace
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <data-structures/binary_search_tree.hpp>
+#include <data-structures/persistent_tree.hpp>
+#include <graph_generators.hpp>
+
+using dads::trees::avl_tree;
+using dads::trees::persistent_tree;
+using dads::trees::sorted_unique;
+
+namespace {
+
+std::vector<int> shuffled_keys(int n) {
+  std::vector<int> keys(n);
+  std::iota(std::begin(keys), std::end(keys), 0);
+  std::shuffle(std::begin(keys), std::end(keys), std::mt19937(n));
+  return keys;
+}
+
+// path copying allocates O(log n) nodes per insert, where the avl_tree
+// allocates one
+template <typename Tree>
+void BM_PersistentTree_Insert(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+
+  for (auto _ : state) {
+    Tree tree;
+    for (const int k : keys) {
+      tree.insert(k, k);
+    }
+    benchmark::DoNotOptimize(tree.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_PersistentTree_Insert, persistent_tree<int, int>)
+    ->Apply(dads::benchmarks::sizes);
+BENCHMARK_TEMPLATE(BM_PersistentTree_Insert, avl_tree<int, int>)
+    ->Apply(dads::benchmarks::sizes);
+
+void BM_PersistentTree_Find(benchmark::State &state) {
+  const auto keys = shuffled_keys(state.range(0));
+  persistent_tree<int, int> tree;
+  for (const int k : keys) {
+    tree.insert(k, k);
+  }
+
+  auto lookups = keys;
+  std::shuffle(std::begin(lookups), std::end(lookups), std::mt19937(1));
+
+  for (auto _ : state) {
+    for (const int k : lookups) {
+      benchmark::DoNotOptimize(tree.find(k));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(BM_PersistentTree_Find)->Apply(dads::benchmarks::sizes);
+
+// a reader that wants a stable view of a tree, either takes a snapshot, or
+// copies the whole tree
+void BM_PersistentTree_Snapshot(benchmark::State &state) {
+  persistent_tree<int, int> tree;
+  for (const int k : shuffled_keys(state.range(0))) {
+    tree.insert(k, k);
+  }
+
+  for (auto _ : state) {
+    auto snapshot = tree.snapshot();
+    benchmark::DoNotOptimize(snapshot.size());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PersistentTree_Snapshot)->Apply(dads::benchmarks::sizes);
+
+void BM_PersistentTree_CopyAvlTree(benchmark::State &state) {
+  avl_tree<int, int> tree;
+  for (const int k : shuffled_keys(state.range(0))) {
+    tree.insert(k, k);
+  }
+
+  for (auto _ : state) {
+    avl_tree<int, int> copy(sorted_unique, tree.begin(), tree.end());
+    benchmark::DoNotOptimize(copy.size());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PersistentTree_CopyAvlTree)->Apply(dads::benchmarks::sizes);
+
+}  // namespace
@@ -0,0 +1,188 @@
+#ifndef GRAPH_GENERATORS_HPP
+#define GRAPH_GENERATORS_HPP
+/*
+  Generators for the graph shapes used by the benchmarks.
+  Every generator is deterministic for a given size, so runs of the same
+  benchmark can be compared against each other.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace dads::benchmarks {
+
+// a (from, to, weight) record
+using edge_list = std::vector<std::tuple<int, int, int>>;
+
+enum class shape : int { random = 0, grid = 1, power_law = 2, chain = 3 };
+
+inline const char *shape_name(shape s) {
+  switch (s) {
+    case shape::random:
+      return "random";
+    case shape::grid:
+      return "grid";
+    case shape::power_law:
+      return "power-law";
+    case shape::chain:
+      return "chain";
+  }
+  return "unknown";
+}
+
+// the average out-degree used by the random and power-law shapes
+constexpr int average_degree = 4;
+
+inline int random_weight(std::mt19937 &rng) {
+  return std::uniform_int_distribution<int>(1, 100)(rng);
+}
+
+// each node gets edges to `average_degree` uniformly chosen nodes
+inline edge_list random_graph(int nodes) {
+  std::mt19937 rng(nodes);
+  std::uniform_int_distribution<int> pick(0, nodes - 1);
+
+  edge_list edges;
+  edges.reserve(static_cast<std::size_t>(nodes) * average_degree);
+  for (int u = 0; u < nodes; u++) {
+    for (int i = 0; i < average_degree; i++) {
+      edges.emplace_back(u, pick(rng), random_weight(rng));
+    }
+  }
+
+  return edges;
+}
+
+// a square grid where each cell has edges to its four neighbours
+inline edge_list grid_graph(int nodes) {
+  std::mt19937 rng(nodes);
+  const int side = std::max(1, static_cast<int>(std::sqrt(nodes)));
+
+  edge_list edges;
+  edges.reserve(static_cast<std::size_t>(side) * side * 4);
+  for (int r = 0; r < side; r++) {
+    for (int c = 0; c < side; c++) {
+      const int u = r * side + c;
+      if (c + 1 < side) {
+        const int w = random_weight(rng);
+        edges.emplace_back(u, u + 1, w);
+        edges.emplace_back(u + 1, u, w);
+      }
+      if (r + 1 < side) {
+        const int w = random_weight(rng);
+        edges.emplace_back(u, u + side, w);
+        edges.emplace_back(u + side, u, w);
+      }
+    }
+  }
+
+  return edges;
+}
+
+// preferential attachment, new nodes connect to existing nodes with a
+// probability proportional to their degree, which gives a few very
+// high-degree hubs and a long tail of low-degree nodes
+inline edge_list power_law_graph(int nodes) {
+  std::mt19937 rng(nodes);
+
+  edge_list edges;
+  edges.reserve(static_cast<std::size_t>(nodes) * average_degree * 2);
+
+  // every endpoint of every edge, picking uniformly from this list is the
+  // same as picking a node proportional to its degree
+  std::vector<int> endpoints;
+  endpoints.reserve(edges.capacity());
+  endpoints.push_back(0);
+
+  for (int u = 1; u < nodes; u++) {
+    const int links = std::min(u, average_degree);
+    for (int i = 0; i < links; i++) {
+      std::uniform_int_distribution<std::size_t> pick(0, endpoints.size() - 1);
+      const int v = endpoints[pick(rng)];
+      const int w = random_weight(rng);
+      edges.emplace_back(u, v, w);
+      edges.emplace_back(v, u, w);
+      endpoints.push_back(v);
+    }
+    endpoints.push_back(u);
+  }
+
+  return edges;
+}
+
+// a single long path, the worst case for the depth of a traversal
+inline edge_list chain_graph(int nodes) {
+  std::mt19937 rng(nodes);
+
+  edge_list edges;
+  edges.reserve(static_cast<std::size_t>(nodes) * 2);
+  for (int u = 0; u + 1 < nodes; u++) {
+    const int w = random_weight(rng);
+    edges.emplace_back(u, u + 1, w);
+    edges.emplace_back(u + 1, u, w);
+  }
+
+  return edges;
+}
+
+inline edge_list make_edges(shape s, int nodes) {
+  switch (s) {
+    case shape::random:
+      return random_graph(nodes);
+    case shape::grid:
+      return grid_graph(nodes);
+    case shape::power_law:
+      return power_law_graph(nodes);
+    case shape::chain:
+      return chain_graph(nodes);
+  }
+  return {};
+}
+
+// reads the shape from the second benchmark argument, and labels the run
+inline shape shape_arg(::benchmark::State &state) {
+  const auto s = static_cast<shape>(state.range(1));
+  state.SetLabel(shape_name(s));
+  return s;
+}
+
+template <typename G>
+inline void fill_graph(G &graph, const edge_list &edges) {
+  for (const auto &[u, v, w] : edges) {
+    graph.add_edge(u, v, w);
+  }
+}
+
+// the byte size of an edge list, used when reporting bytes/sec
+inline int64_t edge_bytes(const edge_list &edges) {
+  return static_cast<int64_t>(edges.size() * sizeof(edges[0]));
+}
+
+// registers every combination of node count (1e3 .. 1e7) and graph shape
+inline void sizes_and_shapes(::benchmark::internal::Benchmark *b) {
+  for (int nodes = 1000; nodes <= 10000000; nodes *= 10) {
+    for (int s = 0; s < 4; s++) {
+      b->Args({nodes, s});
+    }
+  }
+  b->ArgNames({"nodes", "shape"});
+  b->Unit(::benchmark::kMillisecond);
+}
+
+// node counts only, for benchmarks that do not depend on a graph shape
+inline void sizes(::benchmark::internal::Benchmark *b) {
+  b->RangeMultiplier(10)->Range(1000, 10000000);
+  b->ArgNames({"nodes"});
+  b->Unit(::benchmark::kMillisecond);
+}
+
+}  // namespace dads::benchmarks
+
+#endif
@@ -4,39 +4,57 @@
   Breadth first search, and related algorithms.
 */
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <queue>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
+#include <algorithms/traversal.hpp>
 #include <data-structures/graph.hpp>
 
 namespace dads::graphs {
 
-template <typename T>
-static void breadth_first_search(
-    T& graph, int source, std::function<void(int parent, int node)> visit) {
-  std::unordered_map<int, bool> seen;
-
+// the visitor is called as visit(parent, node) or visit(parent, node, weight)
+// for every node reached from the source. nodes already in `seen` are not
+// visited. the visitor can return a visit_control to prune the search at a
+// node, or to stop it. returns true if the visitor stopped the search
+template <typename T, typename Visitor>
+static bool breadth_first_search(T& graph, int source, Visitor visit,
+                                 seen_set& seen) {
   std::queue<int> queue;
   queue.push(source);
 
-  seen[source] = true;
+  seen.insert(source);
 
   while (!queue.empty()) {
     const int c = queue.front();
     queue.pop();
 
-    for (const int n : graph.neighbours(c)) {
+    for (const auto [n, w] : graph.edges(c)) {
       // if we have not visited this node yet, the distance is not set
-      if (!seen[n]) {
-        visit(c, n);
-        seen[n] = true;
-        queue.push(n);
+      if (seen.insert(n)) {
+        const visit_control next = visit_edge(visit, c, n, w);
+        if (next == visit_control::stop) {
+          return true;
+        }
+        if (next == visit_control::proceed) {
+          queue.push(n);
+        }
       }
     }
   }
+
+  return false;
+}
+
+template <typename T, typename Visitor>
+static bool breadth_first_search(T& graph, int source, Visitor visit) {
+  seen_set seen = make_seen_set(graph, source);
+  return breadth_first_search(graph, source, visit, seen);
 }
 
 // finds the shortest reach from some node to all other nodes in the
@@ -45,14 +63,155 @@ template <typename T>
 static std::unordered_map<int, int> bfs_shortest_reach(T& graph, int source) {
   std::unordered_map<int, int> distances;
 
-  breadth_first_search(
-      graph, source, [&distances, &graph](int parent, int node) {
-        distances[node] = distances[parent] + graph.weight(parent, node);
-      });
+  breadth_first_search(graph, source,
+                       [&distances](int parent, int node, int weight) {
+                         distances[node] = distances[parent] + weight;
+                       });
 
   return distances;
 }
 
+// the distance to nodes that can not be reached from the source
+constexpr int unreachable = std::numeric_limits<int>::max();
+
+// like bfs_shortest_reach, but for graphs with dense node ids, so the
+// distances are a flat array indexed by node id. nodes that are not reached
+// have distance `unreachable`.
+// the id bound is taken from the graph, unless one is given. graphs with
+// sparse ids can be remapped to dense ids with remap_ids
+template <typename T>
+static std::vector<int> bfs_distances(T& graph, int source, int id_bound = -1) {
+  if (id_bound < 0) {
+    id_bound = dense_id_bound(graph);
+  }
+  if (id_bound < 0 or source < 0) {
+    throw std::invalid_argument("bfs_distances needs dense node ids");
+  }
+  id_bound = std::max(id_bound, source + 1);
+
+  std::vector<int> distances(id_bound, unreachable);
+  distances[source] = 0;
+
+  seen_set seen(id_bound);
+  breadth_first_search(graph, source,
+                       [&distances](int parent, int node, int weight) {
+                         distances[node] = distances[parent] + weight;
+                       },
+                       seen);
+
+  return distances;
+}
+
+// a path between two nodes, counted in edges
+struct hop_path {
+  // the number of edges on the path, or unreachable if there is none
+  int hops{unreachable};
+  // the nodes on the path, from the source to the target. empty if there is
+  // no path, or if it was not asked for
+  std::vector<int> path;
+};
+
+// the fewest hops from the source to the target, found by searching forward
+// from the source, and backward from the target, along the edges of
+// `reverse`, a level at a time, always growing the search with the smaller
+// frontier. the searches stop as soon as they meet, so a query only pays for
+// the nodes around the two ends. paths longer than max_hops are not looked
+// for. the state of the searches is hashed, so the node ids do not have to
+// be dense
+template <typename T, typename R>
+static hop_path bidirectional_bfs(
+    const T& graph, const R& reverse, int source, int target,
+    int max_hops = std::numeric_limits<int>::max(), bool with_path = true) {
+  hop_path result;
+  if (source == target) {
+    result.hops = 0;
+    if (with_path) {
+      result.path = {source};
+    }
+    return result;
+  }
+
+  struct search {
+    // the node every reached node was reached from
+    std::unordered_map<int, int> parent;
+    std::vector<int> frontier;
+    int depth{0};
+  };
+  search forward;
+  search backward;
+  forward.parent[source] = source;
+  forward.frontier = {source};
+  backward.parent[target] = target;
+  backward.frontier = {target};
+
+  // expands a level of one search, and returns the node where it met the
+  // other one, or -1
+  std::vector<int> next;
+  const auto expand = [&next](const auto& g, search& self,
+                              const search& other) {
+    next.clear();
+    self.depth++;
+    for (const int u : self.frontier) {
+      for (const auto e : g.edges(u)) {
+        if (!self.parent.emplace(e.node, u).second) {
+          continue;
+        }
+        if (other.parent.count(e.node) != 0) {
+          return e.node;
+        }
+        next.push_back(e.node);
+      }
+    }
+    std::swap(self.frontier, next);
+    return -1;
+  };
+
+  int meet = -1;
+  while (meet == -1 and !forward.frontier.empty() and
+         !backward.frontier.empty() and
+         forward.depth + backward.depth < max_hops) {
+    if (forward.frontier.size() <= backward.frontier.size()) {
+      meet = expand(graph, forward, backward);
+    } else {
+      meet = expand(reverse, backward, forward);
+    }
+  }
+
+  if (meet == -1) {
+    return result;
+  }
+
+  // nothing was found on the levels before, so the other search has to have
+  // reached the meeting node on its last level
+  result.hops = forward.depth + backward.depth;
+  if (with_path) {
+    for (int n = meet; n != source; n = forward.parent[n]) {
+      result.path.push_back(n);
+    }
+    result.path.push_back(source);
+    std::reverse(std::begin(result.path), std::end(result.path));
+    for (int n = meet; n != target;) {
+      n = backward.parent[n];
+      result.path.push_back(n);
+    }
+  }
+  return result;
+}
+
+// searches backward along the in-edges of the graph itself, for stores that
+// keep them, see has_in_edges. an adjacency_list has to be told to keep them
+// first, with keep_in_edges
+template <typename T>
+static hop_path bidirectional_bfs(
+    const T& graph, int source, int target,
+    int max_hops = std::numeric_limits<int>::max(), bool with_path = true) {
+  static_assert(has_in_edges<T>::value,
+                "the store has no in-edges, pass a reversed graph instead");
+
+  return bidirectional_bfs(graph, in_edges_view<T>(graph), source, target,
+                           max_hops, with_path);
+}
+
 }  // namespace dads::graphs
 
 #endif
@@ -0,0 +1,202 @@
+#ifndef CONNECTED_COMPONENTS_HPP
+#define CONNECTED_COMPONENTS_HPP
+/*
+  Connected components, in parallel, and strongly connected components.
+  connected_components is Afforest, from Sutton, Ben-Nun and Barak,
+  "Optimizing Parallel Graph Connectivity Computation via Subgraph Sampling",
+  on top of a lock-free union-find:
+  - first every node is joined with its first couple of neighbours, which is
+    usually enough to put most of the graph in one big component
+  - then the biggest component is guessed from a sample of the nodes
+  - and the rest of the edges are joined, skipping the nodes that are already
+    in the big component, since their edges can not join anything new
+  Skipping is only right if every edge is there in both directions, so it is
+  only done when the caller says the graph is symmetric. Otherwise the edges
+  are taken to be undirected, and the result is the weakly connected
+  components of the graph.
+  strongly_connected_components is Tarjan's algorithm, with an explicit stack
+  instead of recursion, so long paths do not run out of stack.
+  Nodes are expected to have ids in a dense range [0, n).
+  Time Complexity:
+  - connected_components: O(n + m) work, times the cost of the union-find
+  - strongly_connected_components: O(n + m)
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <algorithms/traversal.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
+#include <utils/union_find.hpp>
+
+namespace dads::graphs {
+
+// the component of every node id, as the smallest node id in it. ids that
+// are not in the graph are components of their own. set symmetric if every
+// edge is also there in reverse, like in graphs built with add_bi_edge
+template <typename T>
+static std::vector<int> connected_components(
+    const T& graph, utils::thread_pool& pool = utils::default_thread_pool(),
+    bool symmetric = false) {
+  // the number of neighbours every node is joined with before sampling
+  constexpr int neighbour_rounds = 2;
+  constexpr int samples = 1024;
+
+  const int n = node_id_bound(graph);
+  utils::concurrent_union_find sets(n);
+
+  const auto compress = [&] {
+    pool.parallel_chunks(0, n, 4096,
+                         [&sets](std::size_t, std::size_t first,
+                                 std::size_t last) {
+                           sets.compress(first, last);
+                         });
+  };
+
+  for (int r = 0; r < neighbour_rounds; r++) {
+    pool.parallel_for(0, n, [&](std::size_t u) {
+      int i = 0;
+      for (const auto e : graph.edges(u)) {
+        if (i++ == r) {
+          sets.unite(u, e.node);
+          break;
+        }
+      }
+    });
+    compress();
+  }
+
+  // the most common root in the sample is most likely the big component,
+  // -1 if nothing can be skipped
+  int big = -1;
+  if (symmetric and n > 0) {
+    std::minstd_rand rng(n);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    std::unordered_map<int, int> counts;
+    int most = 0;
+    for (int i = 0; i < samples; i++) {
+      const int root = sets.parent_of(pick(rng));
+      if (++counts[root] > most) {
+        most = counts[root];
+        big = root;
+      }
+    }
+  }
+
+  pool.parallel_for(
+      0, n,
+      [&](std::size_t u) {
+        if (big != -1 and sets.find(u) == big) {
+          return;
+        }
+        int i = 0;
+        for (const auto e : graph.edges(u)) {
+          if (i++ >= neighbour_rounds) {
+            sets.unite(u, e.node);
+          }
+        }
+      },
+      256);
+  compress();
+
+  std::vector<int> component(n);
+  pool.parallel_for(0, n, [&](std::size_t u) {
+    component[u] = sets.parent_of(u);
+  });
+  return component;
+}
+
+// connected_components on the default thread pool
+template <typename T>
+static std::vector<int> connected_components(const T& graph, bool symmetric) {
+  return connected_components(graph, utils::default_thread_pool(), symmetric);
+}
+
+// the strongly connected component of every node id. the components are
+// numbered from 0 in the order they are completed, which is a reverse
+// topological order: an edge from one component to another always goes to a
+// smaller number
+template <typename T>
+static std::vector<int> strongly_connected_components(const T& graph) {
+  constexpr int unvisited = -1;
+
+  const int n = node_id_bound(graph);
+  std::vector<int> index(n, unvisited);
+  std::vector<int> low(n);
+  // a node is on tarjan's stack if it has been visited, and is not in a
+  // component yet
+  std::vector<int> component(n, -1);
+  std::vector<int> stack;
+
+  // a call of the recursive version, the node and how far through its edges
+  // it has come. moving a frame keeps the iterator valid, also for stores
+  // whose edges(n) returns a container
+  using range = decltype(graph.edges(0));
+  using iterator = decltype(std::declval<const range&>().begin());
+  struct frame {
+    int node;
+    range edges;
+    iterator it;
+  };
+  std::vector<frame> calls;
+
+  int next_index = 0;
+  int components = 0;
+  const auto enter = [&](int u) {
+    index[u] = low[u] = next_index++;
+    stack.push_back(u);
+    calls.push_back({u, graph.edges(u), iterator()});
+    calls.back().it = calls.back().edges.begin();
+  };
+
+  for (int root = 0; root < n; root++) {
+    if (index[root] != unvisited) {
+      continue;
+    }
+
+    enter(root);
+    while (!calls.empty()) {
+      frame& f = calls.back();
+      if (f.it != f.edges.end()) {
+        const int v = (*f.it).node;
+        ++f.it;
+        if (index[v] == unvisited) {
+          enter(v);
+        } else if (component[v] == -1) {
+          low[f.node] = std::min(low[f.node], index[v]);
+        }
+        continue;
+      }
+
+      const int u = f.node;
+      calls.pop_back();
+      if (!calls.empty()) {
+        const int parent = calls.back().node;
+        low[parent] = std::min(low[parent], low[u]);
+      }
+
+      // u is the first node of its component that was visited, everything
+      // above it on the stack belongs with it
+      if (low[u] == index[u]) {
+        int v;
+        do {
+          v = stack.back();
+          stack.pop_back();
+          component[v] = components;
+        } while (v != u);
+        components++;
+      }
+    }
+  }
+
+  return component;
+}
+
+}  // namespace dads::graphs
+
+#endif
@@ -4,49 +4,72 @@
   Depth first search, and related algorithms.
 */
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <queue>
 #include <stack>
+#include <stdexcept>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
+#include <algorithms/traversal.hpp>
 #include <data-structures/graph.hpp>
 
 namespace dads::graphs {
 
-template <typename T>
-static void depth_first_search(
-    T& graph, int source, std::function<void(int parent, int node)> visit,
-    int max_depth = std::numeric_limits<int>::max()) {
+// the visitor is called as visit(parent, node) or visit(parent, node, weight)
+// for every node reached from the source, the source included. nodes already
+// in `seen` are not visited. the visitor can return a visit_control to prune
+// the search at a node, or to stop it. returns true if the visitor stopped
+// the search
+template <typename T, typename Visitor>
+static bool depth_first_search(T& graph, int source, Visitor visit,
+                               int max_depth, seen_set& seen) {
   // push first element to stack, and everytime we find a new
   // undiscovered vertex, we push it to the stack as well, typical
   // rewrite of a recursive program to use stacks instead of recursion
 
-  // each element is a (parent, node, depth) tuple
-  std::stack<std::tuple<int, int, int>> stack;
-  stack.push({source, source, 0});
-
-  std::unordered_map<int, bool> seen;
+  // each element is a (parent, node, weight, depth) tuple, where weight is
+  // the weight of the edge from parent to node
+  std::stack<std::tuple<int, int, int, int>> stack;
+  stack.push({source, source, 0, 0});
 
   // keep looking at nodes as long as we have some in the stack
   while (!stack.empty()) {
-    auto[parent, node, depth] = stack.top();
+    auto[parent, node, weight, depth] = stack.top();
     stack.pop();
 
     // if a node is not yet seen, examine it
-    if (!seen[node] and depth <= max_depth) {
-      seen[node] = true;
-      visit(parent, node);
+    if (depth <= max_depth and seen.insert(node)) {
+      const visit_control next = visit_edge(visit, parent, node, weight);
+      if (next == visit_control::stop) {
+        return true;
+      }
+      if (next == visit_control::prune) {
+        continue;
+      }
 
       // add all neighbours that are not yet seen to the stack
-      for (const int& n : graph.neighbours(node)) {
-        stack.push({node, n, depth + 1});
+      for (const auto [n, w] : graph.edges(node)) {
+        if (!seen.contains(n)) {
+          stack.push({node, n, w, depth + 1});
+        }
       }
     }
   }
+
+  return false;
+}
+
+template <typename T, typename Visitor>
+static bool depth_first_search(
+    T& graph, int source, Visitor visit,
+    int max_depth = std::numeric_limits<int>::max()) {
+  seen_set seen = make_seen_set(graph, source);
+  return depth_first_search(graph, source, visit, max_depth, seen);
 }
 
 // finds the shortest reach from some node to all other nodes in the
@@ -55,12 +78,42 @@ template <typename T>
 static std::unordered_map<int, int> dfs_shortest_reach(T& graph, int source) {
   std::unordered_map<int, int> distances;
 
-  depth_first_search(graph, source, [&distances, &graph](int parent, int node) {
-    const int dist = distances[parent] + graph.weight(parent, node);
-    if (!distances[node] or distances[node] > dist) {
-      distances[node] = distances[parent] + graph.weight(parent, node);
-    }
-  });
+  depth_first_search(graph, source,
+                     [&distances](int parent, int node, int weight) {
+                       const int dist = distances[parent] + weight;
+                       if (!distances[node] or distances[node] > dist) {
+                         distances[node] = dist;
+                       }
+                     });
+
+  return distances;
+}
+
+// like dfs_shortest_reach, but for graphs with dense node ids, so the
+// distances are a flat array indexed by node id. nodes that are not reached
+// have distance std::numeric_limits<int>::max().
+// the id bound is taken from the graph, unless one is given. graphs with
+// sparse ids can be remapped to dense ids with remap_ids
+template <typename T>
+static std::vector<int> dfs_distances(T& graph, int source, int id_bound = -1) {
+  if (id_bound < 0) {
+    id_bound = dense_id_bound(graph);
+  }
+  if (id_bound < 0 or source < 0) {
+    throw std::invalid_argument("dfs_distances needs dense node ids");
+  }
+  id_bound = std::max(id_bound, source + 1);
+
+  std::vector<int> distances(id_bound, std::numeric_limits<int>::max());
+  distances[source] = 0;
+
+  seen_set seen(id_bound);
+  depth_first_search(graph, source,
+                     [&distances](int parent, int node, int weight) {
+                       distances[node] = std::min(distances[node],
+                                                  distances[parent] + weight);
+                     },
+                     std::numeric_limits<int>::max(), seen);
 
   return distances;
 }
@@ -2,60 +2,459 @@
 #define GRAPH_UTILS_HPP
 /*
   Utilities for working with graphs
+  Graphs are read from and written to text as "u,v,w" edge records, with a
+  separator (or line breaks) between them. Both directions work on chunks,
+  in parallel if a thread pool is given, and neither builds the text up in
+  a stringstream.
 */
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
+#include <unistd.h>
+
+#include <data-structures/csr_graph.hpp>
 #include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
 
 using dads::graphs::graph;
 
 namespace dads::graphs {
 
-template <typename T>
-static std::string to_csv(T& graph, const char seperator = ' ') {
-  std::ostringstream ss;
+// the order write_csv writes the edges in. sorted is by node, and then by
+// the node the edge goes to, which makes the output the same for every store
+// of the same graph. unsorted is whatever order the store keeps them in
+enum class csv_order { sorted, unsorted };
 
-  // we store all nodes and their neighbours in sorted order, just to make
-  // testing easier.
-  auto nodes = graph.nodes();
-  std::sort(std::begin(nodes), std::end(nodes));
+// sinks for write_csv, which takes any callable sink(const char *, size)
+
+// writes to a file descriptor, throws std::system_error if it can not
+struct fd_sink {
+  int fd;
+
+  void operator()(const char* data, std::size_t size) const {
+    while (size > 0) {
+      const ssize_t written = ::write(fd, data, size);
+      if (written == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::system_error(errno, std::generic_category(),
+                                "could not write the csv");
+      }
+      data += written;
+      size -= written;
+    }
+  }
+};
+
+struct ostream_sink {
+  std::ostream& out;
+
+  void operator()(const char* data, std::size_t size) const {
+    out.write(data, size);
+  }
+};
+
+struct string_sink {
+  std::string& out;
+
+  void operator()(const char* data, std::size_t size) const {
+    out.append(data, size);
+  }
+};
+
+// formats edge records into a fixed size buffer, and hands the buffer to the
+// sink whenever it fills up, so the output is never all in memory
+template <typename Sink>
+class csv_writer {
+ private:
+  // "-2147483648," three times, and a separator
+  static constexpr std::size_t max_record = 3 * 12 + 1;
+
+  Sink& sink;
+  const char seperator;
+  std::vector<char> buffer;
+  std::size_t used{0};
+  bool first{true};
+
+ public:
+  csv_writer(Sink& sink, char seperator, std::size_t buffer_size = 1 << 16)
+      : sink(sink),
+        seperator(seperator),
+        buffer(std::max(buffer_size, max_record)) {}
+  csv_writer(const csv_writer&) = delete;
+  csv_writer& operator=(const csv_writer&) = delete;
+
+  void record(int u, int v, int w) {
+    if (buffer.size() - used < max_record) {
+      flush();
+    }
+
+    char* p = buffer.data() + used;
+    char* end = buffer.data() + buffer.size();
+    if (!first) {
+      *p++ = seperator;
+    }
+    first = false;
+    p = std::to_chars(p, end, u).ptr;
+    *p++ = ',';
+    p = std::to_chars(p, end, v).ptr;
+    *p++ = ',';
+    p = std::to_chars(p, end, w).ptr;
+    used = p - buffer.data();
+  }
+
+  // the records of node u, in the given order. scratch is reused between
+  // nodes, for sorting the edges
+  template <typename G>
+  void node(const G& graph, int u, csv_order order,
+            std::vector<edge>& scratch) {
+    if (order == csv_order::unsorted) {
+      for (const auto e : graph.edges(u)) {
+        record(u, e.node, e.weight);
+      }
+      return;
+    }
 
-  for (auto u : nodes) {
-    auto neighbours = graph.neighbours(u);
-    std::sort(std::begin(neighbours), std::end(neighbours));
+    scratch.clear();
+    for (const auto e : graph.edges(u)) {
+      scratch.push_back(e);
+    }
+    std::sort(std::begin(scratch), std::end(scratch),
+              [](const edge& a, const edge& b) { return a.node < b.node; });
+    for (const auto& e : scratch) {
+      record(u, e.node, e.weight);
+    }
+  }
 
-    for (auto v : neighbours) {
-      ss << u << "," << v << "," << graph.weight(u, v) << seperator;
+  void flush() {
+    if (used > 0) {
+      sink(buffer.data(), used);
+      used = 0;
     }
   }
 
-  // don't include the trailing space
-  std::string csv = ss.str();
-  return csv.substr(0, csv.size() - 1);
+  // true if no record has been written yet
+  bool empty() const { return first; }
+};
+
+// writes the edges of a graph, or a node store, to the sink as "u,v,w"
+// records with the separator between them, the format from_csv reads.
+// the weights come with the edges, so there is no lookup per edge
+template <typename G, typename Sink>
+static void write_csv(const G& graph, Sink&& sink, const char seperator = ' ',
+                      csv_order order = csv_order::sorted) {
+  auto nodes = graph.nodes();
+  if (order == csv_order::sorted) {
+    std::sort(std::begin(nodes), std::end(nodes));
+  }
+
+  csv_writer<std::remove_reference_t<Sink>> out(sink, seperator);
+  std::vector<edge> scratch;
+  for (const int u : nodes) {
+    out.node(graph, u, order, scratch);
+  }
+  out.flush();
+}
+
+// like write_csv, with the nodes formatted on the pool, a range of nodes per
+// worker, into text that is handed to the sink in order. the workers only
+// get so far ahead of the sink, so the text waiting for it is bounded by
+// about the size of the pool times nodes_per_range nodes
+template <typename G, typename Sink>
+static void parallel_write_csv(
+    const G& graph, Sink&& sink, const char seperator = ' ',
+    csv_order order = csv_order::sorted,
+    utils::thread_pool& pool = utils::default_thread_pool(),
+    std::size_t nodes_per_range = 1 << 14) {
+  auto nodes = graph.nodes();
+  if (order == csv_order::sorted) {
+    std::sort(std::begin(nodes), std::end(nodes));
+  }
+
+  nodes_per_range = std::max<std::size_t>(nodes_per_range, 1);
+  std::vector<std::string> texts(pool.size());
+  bool first = true;
+
+  for (std::size_t at = 0; at < nodes.size();
+       at += texts.size() * nodes_per_range) {
+    pool.parallel_for(
+        0, texts.size(),
+        [&](std::size_t i) {
+          const std::size_t begin =
+              std::min(at + i * nodes_per_range, nodes.size());
+          const std::size_t end =
+              std::min(begin + nodes_per_range, nodes.size());
+
+          std::string& text = texts[i];
+          text.clear();
+          string_sink to_text{text};
+          csv_writer<string_sink> out(to_text, seperator);
+          std::vector<edge> scratch;
+          for (std::size_t n = begin; n < end; n++) {
+            out.node(graph, nodes[n], order, scratch);
+          }
+          out.flush();
+        },
+        1);
+
+    for (const auto& text : texts) {
+      if (text.empty()) {
+        continue;
+      }
+      if (!first) {
+        sink(&seperator, 1);
+      }
+      first = false;
+      sink(text.data(), text.size());
+    }
+  }
 }
 
+// the edges of a graph as csv text, sorted by node, see write_csv
 template <typename T>
-static std::unique_ptr<T> from_csv(std::string& csv,
-                                   const char seperator = ' ') {
-  auto G = std::make_unique<T>();
+static std::string to_csv(const T& graph, const char seperator = ' ') {
+  std::string csv;
+  write_csv(graph, string_sink{csv}, seperator);
+  return csv;
+}
+
+// the edge records of a csv text, (from, to, weight), a list per chunk of the
+// text, in the order they appear. a record is "u,v,w", and records are
+// separated by the separator, or by line breaks, so files with one record per
+// line parse as well.
+// the text is cut into chunks of about chunk_bytes at record boundaries, and
+// the chunks are parsed on the pool, each into its own list. throws
+// std::invalid_argument on a malformed record
+inline std::vector<std::vector<std::tuple<int, int, int>>> parse_edge_chunks(
+    std::string_view csv, const char seperator = ' ',
+    utils::thread_pool& pool = utils::default_thread_pool(),
+    std::size_t chunk_bytes = std::size_t{1} << 20) {
+  const auto is_delimiter = [seperator](char c) {
+    return c == seperator or c == '\n' or c == '\r';
+  };
+
+  // chunk i is [starts[i], starts[i + 1]), every chunk but the first starts
+  // right after a delimiter
+  std::vector<std::size_t> starts{0};
+  chunk_bytes = std::max<std::size_t>(chunk_bytes, 1);
+  for (std::size_t at = chunk_bytes; at < csv.size(); at += chunk_bytes) {
+    at = std::max(at, starts.back());
+    while (at < csv.size() and !is_delimiter(csv[at])) {
+      at++;
+    }
+    if (at >= csv.size()) {
+      break;
+    }
+    starts.push_back(++at);
+  }
+  starts.push_back(csv.size());
+
+  // the records in the text are about as long as the ones at the start of
+  // it, which tells the chunks how many records to make room for
+  std::size_t record_bytes = 6;
+  {
+    const std::size_t sample = std::min<std::size_t>(csv.size(), 4096);
+    std::size_t records = 0;
+    bool in_record = false;
+    for (std::size_t i = 0; i < sample; i++) {
+      const bool delimiter = is_delimiter(csv[i]);
+      records += !delimiter and !in_record;
+      in_record = !delimiter;
+    }
+    if (records > 0) {
+      record_bytes = std::max<std::size_t>(sample / records, 6);
+    }
+  }
+
+  // like std::from_chars, which does not know that the numbers are short, and
+  // takes a while to get going. takes a sign, and leading zeros, like the
+  // std::stoi it replaces. returns null if there is no int at p
+  const auto parse_int = [](const char* p, const char* end,
+                            int& out) -> const char* {
+    const bool negative = p != end and *p == '-';
+    p += p != end and (*p == '-' or *p == '+');
+
+    const char* first = p;
+    while (p != end and *p == '0') {
+      p++;
+    }
+
+    // an int has at most 10 digits, besides the leading zeros. reading at
+    // most 11 finds the numbers that are too long, without the value
+    // overflowing the int64_t it is built up in
+    const char* digits = p;
+    const char* last = end - p > 11 ? p + 11 : end;
+    std::int64_t value = 0;
+    for (; p != last and static_cast<unsigned>(*p - '0') < 10; p++) {
+      value = value * 10 + (*p - '0');
+    }
+
+    value = negative ? -value : value;
+    if (p == first or p - digits > 10 or
+        value < std::numeric_limits<int>::min() or
+        value > std::numeric_limits<int>::max()) {
+      return nullptr;
+    }
+    out = static_cast<int>(value);
+    return p;
+  };
+
+  std::vector<std::vector<std::tuple<int, int, int>>> parts(starts.size() - 1);
+  pool.parallel_for(
+      0, parts.size(),
+      [&](std::size_t i) {
+        const char* p = csv.data() + starts[i];
+        const char* end = csv.data() + starts[i + 1];
+        auto& edges = parts[i];
+        // with a little room for records that are shorter than the sample
+        const std::size_t expected = (end - p) / record_bytes;
+        edges.reserve(expected + expected / 8 + 1);
+
+        while (true) {
+          while (p != end and is_delimiter(*p)) {
+            p++;
+          }
+          if (p == end) {
+            break;
+          }
 
-  std::istringstream ss(csv);
-  std::string token;
-  while (std::getline(ss, token, seperator)) {
-    // the node record saves is on the form (from, to, weight)
-    std::vector<int> record(3);
+          const char* record = p;
+          int u = 0, v = 0, w = 0;
+          p = parse_int(p, end, u);
+          p = p != nullptr and p != end and *p == ',' ? parse_int(p + 1, end, v)
+                                                       : nullptr;
+          p = p != nullptr and p != end and *p == ',' ? parse_int(p + 1, end, w)
+                                                       : nullptr;
+          if (p == nullptr or (p != end and !is_delimiter(*p))) {
+            throw std::invalid_argument(
+                "malformed edge record at byte " +
+                std::to_string(record - csv.data()));
+          }
 
-    std::istringstream line(token);
+          edges.emplace_back(u, v, w);
+        }
+      },
+      1);
 
-    for (int i = 0; i < 3; i++) {
-      std::getline(line, token, ',');
-      record[i] = std::stoi(token);
+  return parts;
+}
+
+// the records of the chunks from parse_edge_chunks, one chunk after the
+// other, as a single range that does not copy them
+class chunked_edges {
+ private:
+  using record = std::tuple<int, int, int>;
+  const std::vector<std::vector<record>>* parts;
+
+ public:
+  class iterator {
+   private:
+    const std::vector<std::vector<record>>* chunks{nullptr};
+    std::size_t chunk{0};
+    std::size_t at{0};
+
+    void skip_empty() {
+      while (chunk < chunks->size() and at == (*chunks)[chunk].size()) {
+        chunk++;
+        at = 0;
+      }
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = record;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const record*;
+    using reference = const record&;
+
+    iterator() = default;
+    iterator(const std::vector<std::vector<record>>* chunks, std::size_t chunk)
+        : chunks(chunks), chunk(chunk) {
+      skip_empty();
+    }
+
+    reference operator*() const { return (*chunks)[chunk][at]; }
+    iterator& operator++() {
+      at++;
+      skip_empty();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
     }
+    bool operator==(const iterator& o) const {
+      return chunk == o.chunk and at == o.at;
+    }
+    bool operator!=(const iterator& o) const { return !(*this == o); }
+  };
+
+  explicit chunked_edges(const std::vector<std::vector<record>>& chunks)
+      : parts(&chunks) {}
+
+  iterator begin() const { return iterator(parts, 0); }
+  iterator end() const { return iterator(parts, parts->size()); }
+
+  // the chunks, so add_edges can read them in parallel
+  const std::vector<std::vector<record>>& chunks() const { return *parts; }
+};
+
+// the edge records of a csv text, like parse_edge_chunks, joined into one list
+inline std::vector<std::tuple<int, int, int>> parse_edges(
+    std::string_view csv, const char seperator = ' ',
+    utils::thread_pool& pool = utils::default_thread_pool(),
+    std::size_t chunk_bytes = std::size_t{1} << 20) {
+  auto parts = parse_edge_chunks(csv, seperator, pool, chunk_bytes);
+  if (parts.size() == 1) {
+    return std::move(parts[0]);
+  }
 
-    G->add_edge(record[0], record[1], record[2]);
+  std::size_t total = 0;
+  for (const auto& part : parts) {
+    total += part.size();
+  }
+  std::vector<std::tuple<int, int, int>> edges;
+  edges.reserve(total);
+  for (const auto& part : parts) {
+    edges.insert(std::end(edges), std::begin(part), std::end(part));
   }
+  return edges;
+}
 
-  return G;
+// builds a graph from csv text, see parse_edges. graphs whose store is built
+// in one go, like graph<csr_graph>, are built from the whole edge list.
+// others get the parsed chunks handed to add_edges as they are, in the order
+// they appear in the text, so stores that add batches in parallel do, on the
+// same pool
+template <typename T>
+static std::unique_ptr<T> from_csv(
+    std::string_view csv, const char seperator = ' ',
+    utils::thread_pool& pool = utils::default_thread_pool()) {
+  if constexpr (std::is_constructible_v<T, csr_graph&&>) {
+    return std::make_unique<T>(
+        csr_graph(parse_edges(csv, seperator, pool)));
+  } else {
+    const auto chunks = parse_edge_chunks(csv, seperator, pool);
+    auto G = std::make_unique<T>();
+    G->add_edges(chunked_edges(chunks), pool);
+    return G;
+  }
 }
 
 }  // namespace dads::graphs
@@ -1,41 +1,204 @@
 #ifndef ITERATIVE_DEEPENING_SEARCH_HPP
 #define ITERATIVE_DEEPENING_SEARCH_HPP
 /*
-  Depth first search, and related algorithms.
+  Iterative deepening search.
+  The search is deepened one bound at a time, but does not start over for
+  every bound: the nodes the last bound stopped at are kept as a frontier,
+  and the next bound carries on from them. Within a bound the search is
+  depth first, and every node keeps the smallest depth it was reached at. A
+  node reached again at a strictly smaller depth is visited and expanded
+  again, so a node is never missed because it was first found along a
+  longer path.
+  The depths, the stack, and the frontiers are kept between bounds, and
+  between searches, so a search allocates nothing once they have grown.
+  Time Complexity: O(n + m) over all the bounds, when deepened one level at a
+  time, like a breadth first search. Deeper steps can expand a node more than
+  once within a step.
 */
 
-#include <functional>
-#include <limits>
-#include <memory>
-#include <queue>
-#include <stack>
-#include <tuple>
+#include <algorithm>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include <algorithms/depth_first_search.hpp>
+#include <algorithms/traversal.hpp>
 #include <data-structures/graph.hpp>
 
 namespace dads::graphs {
 
 template <typename T>
-static bool iterative_deepening_bfs(
-    T& graph, int source, int goal, int max_depth,
-    std::function<void(int parent, int node)> visit) {
+class iterative_deepening {
+ private:
+  const T& graph;
+
+  // the depth of every node reached so far, in a flat array if the ids are
+  // dense, and hashed otherwise. touched remembers which entries of the array
+  // to clear for the next search
+  const int id_bound;
+  std::vector<int> depths;
+  std::unordered_map<int, int> hashed;
+  std::vector<int> touched;
+
+  // (node, depth) pairs waiting to be expanded within the current bound
+  std::vector<std::pair<int, int>> stack;
+  // the nodes at the current bound, whose edges have not been followed yet
+  std::vector<int> frontier;
+  std::vector<int> next_frontier;
+
+  int source{0};
+  int bound{-1};
+
+  // records a depth for a node, if it is better than the one it had
+  bool improve(int n, int depth) {
+    if (id_bound >= 0 and n >= 0 and n < id_bound) {
+      int& d = depths[n];
+      if (d != -1 and d <= depth) {
+        return false;
+      }
+      if (d == -1) {
+        touched.push_back(n);
+      }
+      d = depth;
+      return true;
+    }
+
+    auto [it, inserted] = hashed.try_emplace(n, depth);
+    if (!inserted) {
+      if (it->second <= depth) {
+        return false;
+      }
+      it->second = depth;
+    }
+    return true;
+  }
+
+ public:
+  iterative_deepening(const T& graph, int source)
+      : graph(graph),
+        id_bound(dense_id_bound(graph)),
+        depths(std::max(id_bound, 0), -1),
+        source(source) {}
+
+  // starts a new search from a source, keeping the buffers
+  void reset(int source) {
+    for (const int n : touched) {
+      depths[n] = -1;
+    }
+    touched.clear();
+    hashed.clear();
+    frontier.clear();
+    this->source = source;
+    bound = -1;
+  }
+
+  // the smallest depth a node has been reached at, or -1 if it has not
+  int depth(int n) const {
+    if (id_bound >= 0 and n >= 0 and n < id_bound) {
+      return depths[n];
+    }
+    auto it = hashed.find(n);
+    return it != hashed.end() ? it->second : -1;
+  }
+
+  // the bound searched to so far, -1 before the first call to deepen
+  int searched_to() const { return bound; }
+
+  // true if the last bound reached no new nodes, so deepening further will
+  // not find any
+  bool exhausted() const { return bound >= 0 and frontier.empty(); }
+
+  // carries the search on to a new bound, calling visit(parent, node), or
+  // visit(parent, node, weight), for every node reached within it at a
+  // better depth than before. the source is visited as its own parent. the
+  // visitor can prune or stop the search like in depth_first_search. returns
+  // true if the visitor stopped it, after which the search has to be reset
+  // before it can be deepened again
+  template <typename Visitor>
+  bool deepen(int new_bound, Visitor visit) {
+    if (new_bound <= bound) {
+      return false;
+    }
+
+    next_frontier.clear();
+    // reaches n from parent, and queues it to be expanded, or to wait for
+    // the next bound. returns false if the visitor stopped the search
+    const auto reach = [&](int parent, int n, int weight, int depth) {
+      if (!improve(n, depth)) {
+        return true;
+      }
+      const visit_control next = visit_edge(visit, parent, n, weight);
+      if (next == visit_control::stop) {
+        return false;
+      }
+      if (next == visit_control::proceed) {
+        if (depth < new_bound) {
+          stack.emplace_back(n, depth);
+        } else {
+          next_frontier.push_back(n);
+        }
+      }
+      return true;
+    };
+
+    stack.clear();
+    if (bound < 0) {
+      if (!reach(source, source, 0, 0)) {
+        bound = new_bound;
+        return true;
+      }
+    } else {
+      // a frontier node that was reached at a better depth since has been
+      // expanded already
+      for (const int n : frontier) {
+        if (depth(n) == bound) {
+          stack.emplace_back(n, bound);
+        }
+      }
+    }
+    bound = new_bound;
+
+    while (!stack.empty()) {
+      const auto [u, d] = stack.back();
+      stack.pop_back();
+      // u was reached at a better depth after it was pushed
+      if (depth(u) < d) {
+        continue;
+      }
+
+      for (const auto [n, w] : graph.edges(u)) {
+        if (!reach(u, n, w, d + 1)) {
+          return true;
+        }
+      }
+    }
+
+    std::swap(frontier, next_frontier);
+    return false;
+  }
+};
+
+// searches for the goal one depth at a time, and returns true if it was found
+// within max_depth. the visitor is called like in iterative_deepening::deepen,
+// once for every node, in order of depth, and can prune or stop the search.
+// the search ends as soon as the goal is visited
+template <typename T, typename Visitor>
+static bool iterative_deepening_bfs(const T& graph, int source, int goal,
+                                    int max_depth, Visitor visit) {
+  iterative_deepening<T> search(graph, source);
+
   bool found = false;
-  int depth;
-  for (depth = 0; depth <= max_depth; depth++) {
-    dads::graphs::depth_first_search(
-        graph, source,
-        [&graph, &goal, &visit, &found](int parent, int node) {
-          visit(parent, node);
-          if (node == goal) {
-            found = true;
-          }
-        },
-        depth);
-
-    if (found) {
+  const auto until_goal = [goal, &visit, &found](int parent, int node,
+                                                 int weight) {
+    const visit_control next = visit_edge(visit, parent, node, weight);
+    if (node == goal) {
+      found = true;
+      return visit_control::stop;
+    }
+    return next;
+  };
+
+  for (int depth = 0; depth <= max_depth and !search.exhausted(); depth++) {
+    if (search.deepen(depth, until_goal)) {
       break;
     }
   }
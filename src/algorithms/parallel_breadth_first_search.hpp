@@ -0,0 +1,294 @@
+#ifndef PARALLEL_BREADTH_FIRST_SEARCH_HPP
+#define PARALLEL_BREADTH_FIRST_SEARCH_HPP
+/*
+  Direction-optimizing parallel breadth first search.
+  The search is level-synchronous: all nodes of one level are expanded before
+  any node of the next level. Each level is expanded in one of two ways
+  - top-down: every node in the frontier claims its unvisited neighbours
+  - bottom-up: every unvisited node looks for a parent in the frontier
+  Top-down is cheap while the frontier is small, bottom-up is cheap when the
+  frontier holds a large part of the graph, since an unvisited node can stop
+  looking as soon as it finds a parent. The switch between the two follows
+  Beamer, Asanović and Patterson, "Direction-Optimizing Breadth-First Search".
+  Bottom-up steps walk the edges into the nodes, from the store if it keeps
+  them, or from a reversed copy of the graph, e.g. from transpose. Either is
+  built once, and only read by the searches, so any number of searches can
+  share it. The in-edges of an adjacency_list are hashed maps, which are a lot
+  slower to walk than the flat rows of a csr_graph, so a caller that searches
+  a large adjacency_list more than once should build *transpose(G) once, and
+  pass it as the reversed graph instead.
+  Nodes are expected to have ids in a dense range [0, n).
+  Time Complexity: O(n + m) work.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <algorithms/traversal.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/bitmap.hpp>
+#include <utils/thread_pool.hpp>
+
+namespace dads::graphs {
+
+// the result of a parallel breadth first search, indexed by node id
+struct bfs_tree {
+  // the node each node was discovered from, the source is its own parent, and
+  // nodes that can not be reached have parent -1
+  std::vector<int> parent;
+  // the number of edges on the path from the source, -1 if not reachable
+  std::vector<int> level;
+};
+
+// searches from the source, going bottom-up along the edges of `reverse`,
+// the graph with every edge reversed
+template <typename T, typename R>
+static bfs_tree direction_optimizing_bfs(
+    const T& graph, const R& reverse, int source,
+    utils::thread_pool& pool = utils::default_thread_pool()) {
+  // tuning constants from the paper, switch to bottom-up when the frontier has
+  // more than 1/alpha of the unexplored edges, and back to top-down when it
+  // has less than 1/beta of the nodes
+  constexpr int64_t alpha = 14;
+  constexpr int64_t beta = 24;
+
+  if (source < 0) {
+    throw std::invalid_argument("node ids can not be negative");
+  }
+  const int n = std::max(node_id_bound(graph), source + 1);
+
+  // the out-degrees steer the switch between the directions, they are
+  // counted on the pool, along with the number of edges
+  std::vector<int> out_degree(n, 0);
+  std::vector<int64_t> worker_edges(pool.size(), 0);
+  pool.parallel_chunks(
+      0, n, 1024,
+      [&](std::size_t worker, std::size_t first, std::size_t last) {
+        int64_t edges = 0;
+        for (std::size_t u = first; u < last; u++) {
+          const auto es = graph.edges(u);
+          out_degree[u] = std::distance(es.begin(), es.end());
+          edges += out_degree[u];
+        }
+        worker_edges[worker] += edges;
+      });
+
+  // parents are claimed with a compare-and-swap, the level of a node is only
+  // written by the thread that claimed it
+  auto parent = std::make_unique<std::atomic<int>[]>(n);
+  std::vector<int> level(n, -1);
+  pool.parallel_for(0, n, [&parent](std::size_t v) {
+    parent[v].store(-1, std::memory_order_relaxed);
+  });
+  parent[source].store(source, std::memory_order_relaxed);
+  level[source] = 0;
+
+  // the frontier is a list of nodes while going top-down, and a bitmap while
+  // going bottom-up
+  std::vector<int> frontier{source};
+  utils::bitmap frontier_bits(n);
+  utils::bitmap next_bits(n);
+  std::vector<std::vector<int>> next_local(pool.size());
+
+  int64_t frontier_nodes = 1;
+  int64_t frontier_edges = out_degree[source];
+  int64_t unexplored_edges = 0;
+  for (const int64_t edges : worker_edges) {
+    unexplored_edges += edges;
+  }
+  bool bottom_up = false;
+
+  for (int depth = 0; frontier_nodes > 0; depth++) {
+    unexplored_edges -= frontier_edges;
+
+    if (!bottom_up and frontier_edges > unexplored_edges / alpha) {
+      frontier_bits.clear();
+      for (const int u : frontier) {
+        frontier_bits.set(u);
+      }
+      bottom_up = true;
+    } else if (bottom_up and frontier_nodes < n / beta) {
+      frontier.clear();
+      frontier_bits.for_each_set(
+          [&frontier](std::size_t u) { frontier.push_back(u); });
+      bottom_up = false;
+    }
+
+    std::atomic<int64_t> awake_nodes{0};
+    std::atomic<int64_t> awake_edges{0};
+
+    if (bottom_up) {
+      // the chunks are whole words of the bitmap, so no two threads write to
+      // the same word of next_bits
+      next_bits.clear();
+      pool.parallel_chunks(
+          0, next_bits.word_count(), 16,
+          [&](std::size_t /*worker*/, std::size_t first, std::size_t last) {
+            int64_t nodes = 0;
+            int64_t edges = 0;
+            const int end = std::min<int64_t>(last * 64, n);
+            for (int v = first * 64; v < end; v++) {
+              if (parent[v].load(std::memory_order_relaxed) != -1) {
+                continue;
+              }
+              for (const auto e : reverse.edges(v)) {
+                const int u = e.node;
+                if (frontier_bits.test(u)) {
+                  parent[v].store(u, std::memory_order_relaxed);
+                  level[v] = depth + 1;
+                  next_bits.set(v);
+                  nodes++;
+                  edges += out_degree[v];
+                  break;
+                }
+              }
+            }
+            awake_nodes += nodes;
+            awake_edges += edges;
+          });
+      std::swap(frontier_bits, next_bits);
+    } else {
+      pool.parallel_chunks(
+          0, frontier.size(), 64,
+          [&](std::size_t worker, std::size_t first, std::size_t last) {
+            auto& next = next_local[worker];
+            int64_t edges = 0;
+            for (std::size_t i = first; i < last; i++) {
+              const int u = frontier[i];
+              for (const auto e : graph.edges(u)) {
+                const int v = e.node;
+                int unclaimed = -1;
+                if (parent[v].load(std::memory_order_relaxed) == -1 and
+                    parent[v].compare_exchange_strong(
+                        unclaimed, u, std::memory_order_relaxed)) {
+                  level[v] = depth + 1;
+                  next.push_back(v);
+                  edges += out_degree[v];
+                }
+              }
+            }
+            awake_edges += edges;
+          });
+
+      frontier.clear();
+      for (auto& next : next_local) {
+        frontier.insert(std::end(frontier), std::begin(next), std::end(next));
+        next.clear();
+      }
+      awake_nodes = frontier.size();
+    }
+
+    frontier_nodes = awake_nodes;
+    frontier_edges = awake_edges;
+  }
+
+  bfs_tree tree;
+  tree.parent.resize(n);
+  for (int v = 0; v < n; v++) {
+    tree.parent[v] = parent[v].load(std::memory_order_relaxed);
+  }
+  tree.level = std::move(level);
+
+  return tree;
+}
+
+// searches from the source, going bottom-up along the in-edges of the graph
+// itself, for stores that keep them, see has_in_edges. an adjacency_list has
+// to be told to keep them first, with keep_in_edges, and is slower to search
+// this way than with a transposed copy, see above
+template <typename T>
+static bfs_tree direction_optimizing_bfs(
+    const T& graph, int source,
+    utils::thread_pool& pool = utils::default_thread_pool()) {
+  static_assert(has_in_edges<T>::value,
+                "the store has no in-edges, pass a reversed graph instead");
+
+  return direction_optimizing_bfs(graph, in_edges_view<T>(graph), source,
+                                  pool);
+}
+
+// runs a direction-optimizing search, and then calls visit(parent, node), or
+// visit(parent, node, weight), for every reached node in the order of their
+// levels, like breadth_first_search does. the visitor can stop the replay, or
+// prune a node, which skips every node below it in the search tree. the tree
+// is already built when the visitor is called, so a node below a pruned node
+// is skipped even if another parent could have reached it. returns true if
+// the visitor stopped the replay
+template <typename T, typename R, typename Visitor>
+static bool parallel_breadth_first_search(
+    const T& graph, const R& reverse, int source, Visitor visit,
+    utils::thread_pool& pool = utils::default_thread_pool()) {
+  const bfs_tree tree = direction_optimizing_bfs(graph, reverse, source, pool);
+  const int n = tree.level.size();
+
+  // bucket the nodes by level
+  const int levels = *std::max_element(std::begin(tree.level),
+                                       std::end(tree.level)) + 1;
+  std::vector<int> offsets(levels + 1, 0);
+  for (const int l : tree.level) {
+    if (l >= 0) {
+      offsets[l + 1]++;
+    }
+  }
+  for (int l = 0; l < levels; l++) {
+    offsets[l + 1] += offsets[l];
+  }
+  std::vector<int> order(offsets[levels]);
+  for (int v = 0; v < n; v++) {
+    if (tree.level[v] >= 0) {
+      order[offsets[tree.level[v]]++] = v;
+    }
+  }
+
+  // the nodes whose edges are not followed, because they, or a node above
+  // them, were pruned. parents come before their children in level order
+  std::vector<char> pruned(n, 0);
+  for (const int v : order) {
+    if (v == source) {
+      continue;
+    }
+    const int p = tree.parent[v];
+    if (pruned[p]) {
+      pruned[v] = 1;
+      continue;
+    }
+
+    int weight = 0;
+    if constexpr (std::is_invocable_v<Visitor&, int, int, int>) {
+      weight = graph.weight(p, v);
+    }
+    const visit_control next = visit_edge(visit, p, v, weight);
+    if (next == visit_control::stop) {
+      return true;
+    }
+    if (next == visit_control::prune) {
+      pruned[v] = 1;
+    }
+  }
+
+  return false;
+}
+
+// like above, along the in-edges of the graph itself
+template <typename T, typename Visitor>
+static bool parallel_breadth_first_search(
+    const T& graph, int source, Visitor visit,
+    utils::thread_pool& pool = utils::default_thread_pool()) {
+  static_assert(has_in_edges<T>::value,
+                "the store has no in-edges, pass a reversed graph instead");
+
+  return parallel_breadth_first_search(graph, in_edges_view<T>(graph), source,
+                                       visit, pool);
+}
+
+}  // namespace dads::graphs
+
+#endif
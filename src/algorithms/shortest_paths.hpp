@@ -0,0 +1,406 @@
+#ifndef SHORTEST_PATHS_HPP
+#define SHORTEST_PATHS_HPP
+/*
+  Shortest paths in graphs with non-negative edge weights.
+  - dijkstra: single source, sequential. uses a radix heap, since the weights
+    are integers, or a 4-ary heap
+  - delta_stepping: single source, parallel. nodes are put in buckets of width
+    delta by their tentative distance, and all nodes in the smallest bucket
+    are relaxed at the same time, see Meyer and Sanders, "Delta-stepping: a
+    parallelizable shortest path algorithm"
+  - bidirectional_dijkstra: a single pair of nodes. searches forward from the
+    source and backward from the target, until the two searches meet
+  Time Complexity:
+  - dijkstra: O(m + n log C) with the radix heap, where C is the biggest
+    distance, O(m log n) with the 4-ary heap
+  - delta_stepping: O(n + m + L / delta) work, where L is the biggest
+    distance, plus the nodes that are relaxed more than once
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <algorithms/traversal.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/d_ary_heap.hpp>
+#include <utils/radix_heap.hpp>
+#include <utils/thread_pool.hpp>
+
+namespace dads::graphs {
+
+// the distance to nodes that can not be reached from the source. distances
+// are 64-bit, so long paths of big weights do not overflow
+constexpr int64_t infinite_distance = std::numeric_limits<int64_t>::max();
+
+// the result of a single source search, indexed by node id
+struct shortest_path_tree {
+  // the length of the shortest path from the source, or infinite_distance
+  std::vector<int64_t> distance;
+  // the node before each node on its shortest path, the source is its own
+  // parent, and nodes that can not be reached have parent -1
+  std::vector<int> parent;
+};
+
+// a single shortest path
+struct shortest_path {
+  // the length of the path, or infinite_distance if there is none
+  int64_t distance{infinite_distance};
+  // the nodes on the path, from the source to the target, empty if there is
+  // no path
+  std::vector<int> path;
+};
+
+enum class dijkstra_heap { radix, d_ary };
+
+// the id bound used by the single source searches, they keep their state in
+// flat arrays, so they need dense ids
+template <typename T>
+static int shortest_paths_id_bound(const T& graph, int source, int id_bound) {
+  if (id_bound < 0) {
+    id_bound = dense_id_bound(graph);
+  }
+  if (id_bound < 0 or source < 0) {
+    throw std::invalid_argument("shortest paths need dense node ids");
+  }
+  return std::max(id_bound, source + 1);
+}
+
+// a 4-ary heap of (distance, node) pairs, with the same interface as the
+// radix heap, so dijkstra can use either
+class dijkstra_d_ary_queue {
+ private:
+  utils::d_ary_heap<std::pair<int64_t, int>> heap;
+
+ public:
+  bool empty() const { return heap.empty(); }
+  void push(int64_t distance, int node) { heap.emplace(distance, node); }
+  std::pair<int64_t, int> pop() { return heap.pop(); }
+};
+
+template <typename T, typename Queue>
+static void dijkstra_search(const T& graph, int source, Queue& queue,
+                            shortest_path_tree& tree) {
+  auto& distance = tree.distance;
+  auto& parent = tree.parent;
+
+  distance[source] = 0;
+  parent[source] = source;
+  queue.push(0, source);
+
+  while (!queue.empty()) {
+    const auto [d, u] = queue.pop();
+
+    // nodes are pushed again when their distance improves, instead of
+    // updating their key, so skip the stale entries
+    if (static_cast<int64_t>(d) > distance[u]) {
+      continue;
+    }
+
+    for (const auto [v, w] : graph.edges(u)) {
+      if (w < 0) {
+        throw std::invalid_argument("shortest paths need non-negative weights");
+      }
+
+      const int64_t dv = static_cast<int64_t>(d) + w;
+      if (dv < distance[v]) {
+        distance[v] = dv;
+        parent[v] = u;
+        queue.push(dv, v);
+      }
+    }
+  }
+}
+
+// the shortest paths from the source to every node in the graph. the id bound
+// is taken from the graph, unless one is given. graphs with sparse ids can be
+// remapped to dense ids with remap_ids
+template <typename T>
+static shortest_path_tree dijkstra(const T& graph, int source,
+                                   dijkstra_heap heap = dijkstra_heap::radix,
+                                   int id_bound = -1) {
+  const int n = shortest_paths_id_bound(graph, source, id_bound);
+
+  shortest_path_tree tree;
+  tree.distance.assign(n, infinite_distance);
+  tree.parent.assign(n, -1);
+
+  if (heap == dijkstra_heap::radix) {
+    utils::radix_heap<int> queue;
+    dijkstra_search(graph, source, queue, tree);
+  } else {
+    dijkstra_d_ary_queue queue;
+    dijkstra_search(graph, source, queue, tree);
+  }
+
+  return tree;
+}
+
+// the distances from the source to every node in the graph. delta is the
+// width of the buckets, with 0 it is picked from the weights of the graph.
+// small buckets do less wasted work, big buckets give more parallelism
+template <typename T>
+static std::vector<int64_t> delta_stepping(
+    const T& graph, int source, int64_t delta = 0,
+    utils::thread_pool& pool = utils::default_thread_pool(),
+    int id_bound = -1) {
+  const int n = shortest_paths_id_bound(graph, source, id_bound);
+  const std::vector<int> nodes = graph.nodes();
+
+  // check the weights up front, and find the biggest one for picking delta
+  {
+    std::vector<int> max_weight(pool.size(), 0);
+    std::vector<int64_t> edge_count(pool.size(), 0);
+    std::atomic<bool> negative{false};
+    pool.parallel_chunks(
+        0, nodes.size(), 256,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i < last; i++) {
+            for (const auto e : graph.edges(nodes[i])) {
+              if (e.weight < 0) {
+                negative = true;
+              }
+              max_weight[worker] = std::max(max_weight[worker], e.weight);
+              edge_count[worker]++;
+            }
+          }
+        });
+    if (negative) {
+      throw std::invalid_argument("shortest paths need non-negative weights");
+    }
+
+    // the heuristic from the paper, the biggest weight over the average
+    // degree
+    if (delta <= 0) {
+      int64_t edges = 0;
+      for (const int64_t c : edge_count) {
+        edges += c;
+      }
+      const int64_t degree = std::max<int64_t>(
+          1, edges / std::max<int64_t>(1, nodes.size()));
+      delta = std::max<int64_t>(
+          1, *std::max_element(std::begin(max_weight), std::end(max_weight)) /
+                 degree);
+    }
+  }
+
+  auto distance = std::make_unique<std::atomic<int64_t>[]>(n);
+  pool.parallel_for(0, n, [&distance](std::size_t v) {
+    distance[v].store(infinite_distance, std::memory_order_relaxed);
+  });
+  distance[source].store(0, std::memory_order_relaxed);
+
+  // buckets hold nodes by their tentative distance, a node is not removed from
+  // its old bucket when its distance improves, so the buckets are checked
+  // against the distances when they are emptied
+  std::vector<std::vector<int>> buckets(1, std::vector<int>{source});
+  auto bucket_of = [&distance, delta](int v) {
+    return static_cast<std::size_t>(
+        distance[v].load(std::memory_order_relaxed) / delta);
+  };
+
+  // nodes whose distance improved, found by each worker
+  std::vector<std::vector<int>> improved(pool.size());
+
+  auto relax = [&distance, &improved](std::size_t worker, int v, int64_t dv) {
+    int64_t old = distance[v].load(std::memory_order_relaxed);
+    while (dv < old) {
+      if (distance[v].compare_exchange_weak(old, dv,
+                                            std::memory_order_relaxed)) {
+        improved[worker].push_back(v);
+        return;
+      }
+    }
+  };
+
+  auto relax_edges = [&](const std::vector<int>& from, bool light) {
+    pool.parallel_chunks(
+        0, from.size(), 64,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i < last; i++) {
+            const int u = from[i];
+            const int64_t du = distance[u].load(std::memory_order_relaxed);
+            for (const auto [v, w] : graph.edges(u)) {
+              if ((w <= delta) == light) {
+                relax(worker, v, du + w);
+              }
+            }
+          }
+        });
+
+    for (auto& found : improved) {
+      for (const int v : found) {
+        const std::size_t b = bucket_of(v);
+        if (b >= buckets.size()) {
+          buckets.resize(b + 1);
+        }
+        buckets[b].push_back(v);
+      }
+      found.clear();
+    }
+  };
+
+  // the last round a node was put in the frontier, and the last bucket it was
+  // settled in, so duplicates are only handled once
+  std::vector<std::size_t> in_frontier(n, 0);
+  std::vector<std::size_t> in_settled(n, 0);
+  std::size_t round = 0;
+
+  std::vector<int> current;
+  std::vector<int> frontier;
+  std::vector<int> settled;
+
+  for (std::size_t i = 0; i < buckets.size(); i++) {
+    settled.clear();
+
+    // relaxing light edges can put nodes back into the same bucket, so keep
+    // going until it stays empty
+    while (!buckets[i].empty()) {
+      round++;
+      current.clear();
+      std::swap(current, buckets[i]);
+
+      frontier.clear();
+      for (const int v : current) {
+        if (bucket_of(v) == i and in_frontier[v] != round) {
+          in_frontier[v] = round;
+          frontier.push_back(v);
+          if (in_settled[v] != i + 1) {
+            in_settled[v] = i + 1;
+            settled.push_back(v);
+          }
+        }
+      }
+
+      relax_edges(frontier, true);
+    }
+
+    // heavy edges can not lead back into this bucket, so they are relaxed once
+    // the bucket is settled
+    relax_edges(settled, false);
+  }
+
+  std::vector<int64_t> result(n);
+  pool.parallel_for(0, n, [&result, &distance](std::size_t v) {
+    result[v] = distance[v].load(std::memory_order_relaxed);
+  });
+
+  return result;
+}
+
+// the shortest path from the source to the target. `reverse` is the graph
+// with every edge reversed, e.g. from transpose(graph), it can be built once
+// and reused for many queries. the state of the searches is hashed, so the
+// node ids do not have to be dense, and a query only pays for the nodes it
+// explores
+template <typename T, typename R>
+static shortest_path bidirectional_dijkstra(const T& graph, const R& reverse,
+                                            int source, int target) {
+  struct search {
+    std::unordered_map<int, int64_t> distance;
+    std::unordered_map<int, int> parent;
+    utils::d_ary_heap<std::pair<int64_t, int>> queue;
+
+    int64_t distance_to(int n) const {
+      auto it = distance.find(n);
+      return it != distance.end() ? it->second : infinite_distance;
+    }
+
+    // skips stale entries, so the top is the next node to settle
+    bool prune() {
+      while (!queue.empty() and
+             queue.top().first > distance[queue.top().second]) {
+        queue.pop();
+      }
+      return !queue.empty();
+    }
+  };
+
+  shortest_path result;
+  if (source == target) {
+    result.distance = 0;
+    result.path = {source};
+    return result;
+  }
+
+  search forward;
+  search backward;
+  forward.distance[source] = 0;
+  forward.queue.emplace(0, source);
+  backward.distance[target] = 0;
+  backward.queue.emplace(0, target);
+
+  // the shortest path found so far goes over the edge (meet_from, meet_to)
+  int64_t best = infinite_distance;
+  int meet_from = -1;
+  int meet_to = -1;
+
+  // settles the closest node of one search, and checks if its edges connect to
+  // the other search
+  auto step = [&best, &meet_from, &meet_to](const auto& g, search& self,
+                                            const search& other,
+                                            bool is_forward) {
+    const auto [d, u] = self.queue.pop();
+    for (const auto [v, w] : g.edges(u)) {
+      if (w < 0) {
+        throw std::invalid_argument("shortest paths need non-negative weights");
+      }
+
+      const int64_t dv = d + w;
+      auto it = self.distance.find(v);
+      if (it == self.distance.end() or dv < it->second) {
+        self.distance[v] = dv;
+        self.parent[v] = u;
+        self.queue.emplace(dv, v);
+      }
+
+      const int64_t rest = other.distance_to(v);
+      if (rest != infinite_distance and dv + rest < best) {
+        best = dv + rest;
+        meet_from = is_forward ? u : v;
+        meet_to = is_forward ? v : u;
+      }
+    }
+  };
+
+  while (forward.prune() and backward.prune()) {
+    // no path through an unsettled node can be shorter than the best one
+    if (forward.queue.top().first + backward.queue.top().first >= best) {
+      break;
+    }
+
+    if (forward.queue.top().first <= backward.queue.top().first) {
+      step(graph, forward, backward, true);
+    } else {
+      step(reverse, backward, forward, false);
+    }
+  }
+
+  if (best == infinite_distance) {
+    return result;
+  }
+
+  result.distance = best;
+  for (int n = meet_from; n != source; n = forward.parent[n]) {
+    result.path.push_back(n);
+  }
+  result.path.push_back(source);
+  std::reverse(std::begin(result.path), std::end(result.path));
+  for (int n = meet_to; n != target; n = backward.parent[n]) {
+    result.path.push_back(n);
+  }
+  result.path.push_back(target);
+
+  return result;
+}
+
+}  // namespace dads::graphs
+
+#endif
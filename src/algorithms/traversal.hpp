@@ -0,0 +1,123 @@
+#ifndef TRAVERSAL_HPP
+#define TRAVERSAL_HPP
+/*
+  Helpers shared by the graph traversals.
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
+#include <data-structures/graph.hpp>
+#include <utils/bitmap.hpp>
+
+namespace dads::graphs {
+
+// what a visitor wants the traversal to do after visiting a node
+// - proceed: carry on as usual
+// - prune: do not follow the edges leaving the node
+// - stop: end the traversal right away
+enum class visit_control { proceed, prune, stop };
+
+// visitors are called with (parent, node), or with (parent, node, weight) if
+// they want to know the weight of the edge that led to the node. they can
+// return a visit_control, visitors that return nothing always proceed
+template <typename Visitor>
+static visit_control visit_edge(Visitor& visit, int parent, int node,
+                                int weight) {
+  if constexpr (std::is_invocable_v<Visitor&, int, int, int>) {
+    if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, int, int, int>,
+                                 visit_control>) {
+      return visit(parent, node, weight);
+    } else {
+      visit(parent, node, weight);
+      return visit_control::proceed;
+    }
+  } else {
+    if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, int, int>,
+                                 visit_control>) {
+      return visit(parent, node);
+    } else {
+      visit(parent, node);
+      return visit_control::proceed;
+    }
+  }
+}
+
+// one past the biggest node id of a graph whose ids are dense, or -1 if the
+// graph does not know its ids, or they are too sparse to index arrays by
+template <typename T>
+static int dense_id_bound(const T& graph) {
+  if constexpr (has_id_bound<T>::value) {
+    return graph.id_bound();
+  } else {
+    return -1;
+  }
+}
+
+// one past the biggest node id of a graph, from the store if it knows, and
+// from the nodes and their edges otherwise
+template <typename T>
+static int node_id_bound(const T& graph) {
+  const int bound = dense_id_bound(graph);
+  if (bound >= 0) {
+    return bound;
+  }
+
+  int n = 0;
+  for (const int u : graph.nodes()) {
+    for (const auto e : graph.edges(u)) {
+      if (u < 0 or e.node < 0) {
+        throw std::invalid_argument("node ids can not be negative");
+      }
+      n = std::max(n, std::max(u, e.node) + 1);
+    }
+  }
+  return n;
+}
+
+// the nodes a traversal has seen. if the node ids are dense this is a bitmap,
+// otherwise it falls back to hashing the ids
+class seen_set {
+ private:
+  bool dense;
+  utils::bitmap bits;
+  std::unordered_set<int> hashed;
+
+ public:
+  // id_bound is one past the biggest id that will be inserted, or -1 if not
+  // known
+  explicit seen_set(int id_bound)
+      : dense(id_bound >= 0), bits(std::max(id_bound, 0)) {}
+
+  // marks a node as seen, returns false if it already was
+  bool insert(int n) {
+    if (dense) {
+      if (bits.test(n)) {
+        return false;
+      }
+      bits.set(n);
+      return true;
+    }
+    return hashed.insert(n).second;
+  }
+
+  bool contains(int n) const {
+    return dense ? bits.test(n) : hashed.count(n) != 0;
+  }
+};
+
+// a seen set sized for a traversal of a graph from some source
+template <typename T>
+static seen_set make_seen_set(const T& graph, int source) {
+  const int bound = dense_id_bound(graph);
+  if (bound < 0 or source < 0) {
+    return seen_set(-1);
+  }
+  return seen_set(std::max(bound, source + 1));
+}
+
+}  // namespace dads::graphs
+
+#endif
@@ -7,63 +7,386 @@
   - find:   O(n) / O(log n)
   - insert: O(n) / O(log n)
   - remove: O(n) / O(log n)
-  - min:    O(log n)
-  - max:    O(log n)
-  - height: O(log n)
+  - min:    O(n) / O(log n)
+  - max:    O(n) / O(log n)
+  - height: O(1)
+  Keys that arrive in sorted order turn the tree into a linked list. The
+  Balance policy can keep the tree balanced, which makes the worst case of
+  find, insert, remove, min, and max O(log n)
+  - balance::none:      a plain binary search tree
+  - balance::avl:       the heights of the two subtrees of a node differ by at
+                        most one, lookups are a bit faster
+  - balance::red_black: no path is more than twice as long as any other,
+                        updates do fewer rotations
+  avl_tree and red_black_tree are shorthands for the balanced trees.
+  A tree can also be built from a range of elements in one go. If the range is
+  sorted by key (pass sorted_unique) this takes O(n), otherwise O(n log n) to
+  sort it first. The result is perfectly balanced, whatever the policy.
+  The nodes are allocated by the Allocator policy, see node_allocator.hpp. The
+  default pool allocator keeps them in contiguous chunks, and recycles the
+  nodes of removed keys.
+  The elements can be walked with bidirectional iterators, like a std::map,
+  which follow the parent pointers of the nodes, so they need no stack. An
+  iterator stays valid until the element it points to is removed.
+  lower_bound, upper_bound, equal_range, and range only visit the nodes on the
+  path to the first element they find, and the elements they return.
+  The traversals take any callable, and call it with (key, value), or with a
+  tuple of references to them, if it only takes one argument.
+  Lookups hand out pointers and references to the stored elements instead of
+  copies, and take any key type that can be compared to K with <, so looking
+  up a std::string key with a string literal does not build a std::string.
+  emplace, try_emplace, and insert_or_assign construct the element right in
+  its node, try_emplace and insert_or_assign only do so if they need to.
+  The Augment policy makes every node keep more about its subtree, which the
+  rotations and updates keep up to date on the way back up to the root
+  - augment::none:         nothing more, the default
+  - augment::order:        the number of nodes, which gives rank, select, and
+                           count_range in O(height)
+  - augment::aggregate<M>: the number of nodes, and the values combined by the
+                           monoid M (augment::sum, min, max, or your own),
+                           which gives aggregate_range in O(height)
+  An aggregate only knows about changes to values made by insert_or_assign,
+  values changed through the references the tree hands out are not seen.
 */
 
-#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
 #include <optional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <utils/node_allocator.hpp>
 
 namespace dads::trees {
 
+// the balance policies of binary_search_tree
+namespace balance {
+struct none {};
+struct avl {};
+struct red_black {};
+}  // namespace balance
+
+// the augmentation policies of binary_search_tree, what else a node knows
+// about its subtree, besides its height
+namespace augment {
+struct none {
+  static constexpr bool sized = false;
+  using monoid = void;
+};
+
+// the number of nodes in the subtree, for rank and select
+struct order {
+  static constexpr bool sized = true;
+  using monoid = void;
+};
+
+// the number of nodes, and the values of the subtree combined in key order
+// by Monoid, which has a value_type, identity(), and an associative
+// combine(a, b). values are converted to the value_type of the monoid
+template <typename Monoid>
+struct aggregate {
+  static constexpr bool sized = true;
+  using monoid = Monoid;
+};
+
+template <typename T>
+struct sum {
+  using value_type = T;
+  static T identity() { return T{}; }
+  static T combine(const T &a, const T &b) { return a + b; }
+};
+
+template <typename T>
+struct min {
+  using value_type = T;
+  static T identity() { return std::numeric_limits<T>::max(); }
+  static T combine(const T &a, const T &b) { return b < a ? b : a; }
+};
+
+template <typename T>
+struct max {
+  using value_type = T;
+  static T identity() { return std::numeric_limits<T>::lowest(); }
+  static T combine(const T &a, const T &b) { return a < b ? b : a; }
+};
+
+// the fields a node has for the augmentation, nothing for augment::none
+template <typename Augment, typename = typename Augment::monoid>
+struct fields {};
+
+template <>
+struct fields<order, void> {
+  int size{1};
+};
+
+template <typename Monoid>
+struct fields<aggregate<Monoid>, Monoid> {
+  int size{1};
+  typename Monoid::value_type total{Monoid::identity()};
+};
+}  // namespace augment
+
+// marks a range of elements as sorted by key, without duplicate keys
+struct sorted_unique_t {};
+constexpr sorted_unique_t sorted_unique{};
+
 // we can force weak ordering on template-parameters with concepts/constraints
 // in c++20
-template <typename K, typename V>
+template <typename K, typename V,
+          template <typename> class Allocator = utils::pool_allocator,
+          typename Balance = balance::none,
+          typename Augment = augment::none>
 class binary_search_tree {
  private:
-  struct node {
-    K key;
-    V value;
+  using monoid = typename Augment::monoid;
+  static constexpr bool sized = Augment::sized;
+  static constexpr bool aggregated = !std::is_void_v<monoid>;
+
+  struct node : augment::fields<Augment> {
+    std::pair<const K, V> kv;
     node *left;
     node *right;
+    node *parent;
+    // the number of levels in the subtree rooted at this node
+    int height;
+    // only used by red-black trees
+    bool red;
 
-    node(K k, V v)
-        : key(std::move(k)),
-          value(std::move(v)),
+    template <typename... Args>
+    explicit node(Args &&...args)
+        : kv(std::forward<Args>(args)...),
           left(nullptr),
-          right(nullptr) {}
+          right(nullptr),
+          parent(nullptr),
+          height(1),
+          red(false) {}
 
     node(const node &) = delete;
     node &operator=(const node &) = default;
     node(node &&) = default;
     node &operator=(node &&) = default;
 
-    ~node() {
-      if (left != nullptr) {
-        delete left;
-        left = nullptr;
-      }
-      if (right != nullptr) {
-        delete right;
-        right = nullptr;
-      }
-    }
+    const K &key() const { return kv.first; }
+    V &value() { return kv.second; }
   };
 
+  Allocator<node> _allocator;
   node *_root{nullptr};
   int _nodes{0};
 
-  node *find_recursive(node *n, K key);
-  node *find_iterative(node *n, K key);
+  // constructs the element of the node from args, like a std::pair<const K, V>
+  template <typename... Args>
+  node *make_node(Args &&...args) {
+    node *n = _allocator.allocate();
+    try {
+      return new (n) node(std::forward<Args>(args)...);
+    } catch (...) {
+      _allocator.deallocate(n);
+      throw;
+    }
+  }
+
+  void destroy_node(node *n) {
+    n->~node();
+    _allocator.deallocate(n);
+  }
+
+  void destroy_all();
+
+  static int height_of(const node *n) { return n != nullptr ? n->height : 0; }
+  static bool is_red(const node *n) { return n != nullptr and n->red; }
+
+  static int size_of(const node *n) { return n != nullptr ? n->size : 0; }
+  template <typename M = monoid>
+  static typename M::value_type total_of(const node *n) {
+    return n != nullptr ? n->total : M::identity();
+  }
+  template <typename M = monoid>
+  static typename M::value_type lift(const node *n) {
+    return static_cast<typename M::value_type>(n->kv.second);
+  }
+
+  // recomputes what a node knows about its subtree, from its children
+  static void refresh(node *n) {
+    n->height = 1 + std::max(height_of(n->left), height_of(n->right));
+    if constexpr (sized) {
+      n->size = 1 + size_of(n->left) + size_of(n->right);
+    }
+    if constexpr (aggregated) {
+      n->total = monoid::combine(
+          monoid::combine(total_of(n->left), lift(n)), total_of(n->right));
+    }
+  }
+
+  // refreshes a node, and all of its ancestors
+  static void refresh_up(node *n) {
+    for (; n != nullptr; n = n->parent) {
+      refresh(n);
+    }
+  }
+
+  static node *leftmost(node *n) {
+    while (n->left != nullptr) {
+      n = n->left;
+    }
+    return n;
+  }
+
+  static node *rightmost(node *n) {
+    while (n->right != nullptr) {
+      n = n->right;
+    }
+    return n;
+  }
+
+  // the next node in key order, or null if n is the last one
+  static node *successor(node *n) {
+    if (n->right != nullptr) {
+      return leftmost(n->right);
+    }
+    while (n->parent != nullptr and n == n->parent->right) {
+      n = n->parent;
+    }
+    return n->parent;
+  }
+
+  // the previous node in key order, or null if n is the first one
+  static node *predecessor(node *n) {
+    if (n->left != nullptr) {
+      return rightmost(n->left);
+    }
+    while (n->parent != nullptr and n == n->parent->left) {
+      n = n->parent;
+    }
+    return n->parent;
+  }
+
+  // calls callback(key, value), or callback(tuple of references to them) for
+  // the callables that take a single argument, like the std::tuple<K, V>
+  // lambdas the traversals used to take
+  template <typename F>
+  static void visit(F &callback, node *n) {
+    if constexpr (std::is_invocable_v<F &, const K &, V &>) {
+      callback(n->kv.first, n->kv.second);
+    } else {
+      callback(std::tuple<const K &, V &>(n->kv.first, n->kv.second));
+    }
+  }
+  // like above, for the traversals of a const tree
+  template <typename F>
+  static void visit(F &callback, const node *n) {
+    if constexpr (std::is_invocable_v<F &, const K &, const V &>) {
+      callback(n->kv.first, n->kv.second);
+    } else {
+      callback(
+          std::tuple<const K &, const V &>(n->kv.first, n->kv.second));
+    }
+  }
+
+  template <typename Key>
+  node *find_node(const Key &key) const;
+  template <typename Key>
+  std::pair<node *, node *> find_slot(const Key &key) const;
+  node *link(node *n, node *parent);
+
+  template <typename Key>
+  node *lower_bound_node(const Key &key) const;
+  template <typename Key>
+  node *upper_bound_node(const Key &key) const;
+
+  template <typename KeyArg, typename... Args>
+  std::pair<node *, bool> try_emplace_node(KeyArg &&key, Args &&...args);
+  template <typename KeyArg, typename M>
+  std::pair<node *, bool> insert_or_assign_node(KeyArg &&key, M &&obj);
+
+  void replace_child(node *parent, node *old_child, node *new_child);
+  void swap_with_successor(node *n, node *s);
+  node *rotate_left(node *n);
+  node *rotate_right(node *n);
+
+  node *select_node(int i) const;
+  template <typename Key, typename M = monoid>
+  static typename M::value_type aggregate_from(const node *n, const Key &lo);
+  template <typename Key, typename M = monoid>
+  static typename M::value_type aggregate_below(const node *n, const Key &hi);
+
+  template <typename It>
+  void build(It first, It last);
+  node *link_sorted(const std::vector<node *> &nodes, std::size_t first,
+                    std::size_t last, node *parent, int depth, int height);
+
+  void avl_rebalance(node *n);
+  void red_black_insert_fixup(node *n);
+  void red_black_remove_fixup(node *n, node *parent);
+
+  template <bool Const>
+  class basic_iterator {
+   private:
+    friend class binary_search_tree;
+    template <bool>
+    friend class basic_iterator;
+    using tree_type = std::conditional_t<Const, const binary_search_tree,
+                                         binary_search_tree>;
+
+    node *n{nullptr};
+    // the end iterator has no node, but can still step back to the last one
+    tree_type *tree{nullptr};
+
+    basic_iterator(node *n, tree_type *tree) : n(n), tree(tree) {}
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const K, V>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<Const, const value_type &, value_type &>;
+
+    basic_iterator() = default;
+
+    // iterators convert to const_iterators
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    basic_iterator(const basic_iterator<false> &it) : n(it.n), tree(it.tree) {}
+
+    reference operator*() const { return n->kv; }
+    pointer operator->() const { return &n->kv; }
+
+    basic_iterator &operator++() {
+      n = successor(n);
+      return *this;
+    }
+    basic_iterator operator++(int) {
+      basic_iterator old = *this;
+      ++*this;
+      return old;
+    }
+    basic_iterator &operator--() {
+      n = n != nullptr ? predecessor(n) : rightmost(tree->_root);
+      return *this;
+    }
+    basic_iterator operator--(int) {
+      basic_iterator old = *this;
+      --*this;
+      return old;
+    }
 
-  void inorder(node *n, std::function<void(std::tuple<K, V>)> callback);
-  void preorder(node *n, std::function<void(std::tuple<K, V>)> callback);
-  void postorder(node *n, std::function<void(std::tuple<K, V>)> callback);
+    bool operator==(const basic_iterator &o) const { return n == o.n; }
+    bool operator!=(const basic_iterator &o) const { return n != o.n; }
+  };
 
  public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
   binary_search_tree() = default;
   binary_search_tree(std::initializer_list<std::tuple<K, V>> elements) {
     for (auto kvp : elements) {
@@ -71,230 +394,742 @@ class binary_search_tree {
     }
   }
 
+  // builds a balanced tree from (key, value) pairs or tuples, which are
+  // already sorted by key, and have no duplicate keys
+  template <typename It>
+  binary_search_tree(sorted_unique_t, It first, It last) {
+    build(first, last);
+  }
+
+  // builds a balanced tree from (key, value) pairs or tuples, in any order.
+  // like insert, the first of a run of duplicate keys wins
+  template <typename It, typename = typename std::iterator_traits<
+                             It>::iterator_category>
+  binary_search_tree(It first, It last) {
+    std::vector<std::pair<K, V>> elements;
+    for (; first != last; ++first) {
+      elements.emplace_back(std::get<0>(*first), std::get<1>(*first));
+    }
+
+    std::stable_sort(
+        std::begin(elements), std::end(elements),
+        [](const auto &a, const auto &b) { return a.first < b.first; });
+    auto end = std::unique(
+        std::begin(elements), std::end(elements),
+        [](const auto &a, const auto &b) { return !(a.first < b.first); });
+
+    build(std::make_move_iterator(std::begin(elements)),
+          std::make_move_iterator(end));
+  }
+
   binary_search_tree(const binary_search_tree &) = delete;
   binary_search_tree &operator=(const binary_search_tree &) = delete;
   binary_search_tree(binary_search_tree &&) = delete;
   binary_search_tree &operator=(binary_search_tree &&) = delete;
 
-  ~binary_search_tree() {
-    delete _root;
-    _root = nullptr;
-  }
+  ~binary_search_tree() { destroy_all(); }
 
   bool insert(K key, V value);
-  bool remove(K key);
-  std::optional<V> find(K key);
-  std::optional<std::tuple<K, V>> min();
-  std::optional<std::tuple<K, V>> max();
+
+  // constructs the element from args, like a std::pair<const K, V>, and
+  // inserts it, if its key is not in the tree already
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args &&...args);
+
+  // constructs the value from args, only if key is not in the tree already
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K &key, Args &&...args) {
+    const auto [n, inserted] =
+        try_emplace_node(key, std::forward<Args>(args)...);
+    return {iterator(n, this), inserted};
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+    const auto [n, inserted] =
+        try_emplace_node(std::move(key), std::forward<Args>(args)...);
+    return {iterator(n, this), inserted};
+  }
+
+  // inserts the key with the value obj, or assigns obj to the value of the
+  // key, if it is already in the tree. true if it was inserted
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj) {
+    const auto [n, inserted] = insert_or_assign_node(key, std::forward<M>(obj));
+    return {iterator(n, this), inserted};
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(K &&key, M &&obj) {
+    const auto [n, inserted] =
+        insert_or_assign_node(std::move(key), std::forward<M>(obj));
+    return {iterator(n, this), inserted};
+  }
+
+  template <typename Key>
+  bool remove(const Key &key);
+
+  // the value stored with key, or null if the key is not in the tree
+  template <typename Key>
+  V *find(const Key &key) {
+    node *n = find_node(key);
+    return n != nullptr ? &n->value() : nullptr;
+  }
+  template <typename Key>
+  const V *find(const Key &key) const {
+    const node *n = find_node(key);
+    return n != nullptr ? &n->kv.second : nullptr;
+  }
+  template <typename Key>
+  bool contains(const Key &key) const {
+    return find_node(key) != nullptr;
+  }
+
+  std::optional<std::tuple<const K &, V &>> min();
+  std::optional<std::tuple<const K &, V &>> max();
   int height();
   int size();
 
-  void inorder(std::function<void(std::tuple<K, V>)> callback);
-  void preorder(std::function<void(std::tuple<K, V>)> callback);
-  void postorder(std::function<void(std::tuple<K, V>)> callback);
+  iterator begin() {
+    return {_root != nullptr ? leftmost(_root) : nullptr, this};
+  }
+  iterator end() { return {nullptr, this}; }
+  const_iterator begin() const {
+    return {_root != nullptr ? leftmost(_root) : nullptr, this};
+  }
+  const_iterator end() const { return {nullptr, this}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // the first element whose key is not less than key
+  template <typename Key>
+  iterator lower_bound(const Key &key) {
+    return {lower_bound_node(key), this};
+  }
+  template <typename Key>
+  const_iterator lower_bound(const Key &key) const {
+    return {lower_bound_node(key), this};
+  }
+
+  // the first element whose key is greater than key
+  template <typename Key>
+  iterator upper_bound(const Key &key) {
+    return {upper_bound_node(key), this};
+  }
+  template <typename Key>
+  const_iterator upper_bound(const Key &key) const {
+    return {upper_bound_node(key), this};
+  }
+
+  // the elements with the given key, the range is empty if there are none
+  template <typename Key>
+  std::pair<iterator, iterator> equal_range(const Key &key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename Key>
+  std::pair<const_iterator, const_iterator> equal_range(const Key &key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename F>
+  void inorder(F &&callback);
+  template <typename F>
+  void preorder(F &&callback);
+  template <typename F>
+  void postorder(F &&callback);
+
+  // calls callback(key, value) for every key in [lo, hi), in key order. the
+  // callback is called like in inorder, and lo and hi are only compared to
+  // the keys, like in lower_bound
+  template <typename Key, typename F>
+  void range(const Key &lo, const Key &hi, F &&callback);
+  template <typename Key, typename F>
+  void range(const Key &lo, const Key &hi, F &&callback) const;
+
+  // the order statistics need a tree with augment::order or
+  // augment::aggregate, and take O(height)
+
+  // the number of keys less than key, which is the position of key in key
+  // order, if it is in the tree
+  template <typename Key>
+  int rank(const Key &key) const;
+
+  // the element at position i in key order, or end() if there is none
+  iterator select(int i) { return {select_node(i), this}; }
+  const_iterator select(int i) const { return {select_node(i), this}; }
+
+  // the number of keys in [lo, hi). lo and hi are only compared to the keys,
+  // rank never decreases, so an empty range does not go negative
+  template <typename Key>
+  int count_range(const Key &lo, const Key &hi) const {
+    return std::max(0, rank(hi) - rank(lo));
+  }
+
+  // the values of the keys in [lo, hi) combined in key order, needs a tree
+  // with augment::aggregate
+  template <typename Key, typename M = monoid>
+  typename M::value_type aggregate_range(const Key &lo, const Key &hi) const;
 };
 
 // returns true is data was inserted,
 // false if it was already in the tree
-template <typename K, typename V>
-bool binary_search_tree<K, V>::insert(K key, V value) {
-  // if the root is empty we're inserting into a new tree
-  if (_root == nullptr) {
-    _nodes++;
-    _root = new node(key, value);
-    return true;
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+bool binary_search_tree<K, V, Allocator, Balance, Augment>::insert(K key,
+                                                                   V value) {
+  const auto [existing, parent] = find_slot(key);
+  if (existing != nullptr) {
+    // do not insert duplicates
+    return false;
+  }
+
+  link(make_node(std::move(key), std::move(value)), parent);
+  return true;
+}
+
+// the key is only known once the element is constructed, so the node is built
+// first, and thrown away again if the key is already in the tree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename... Args>
+std::pair<
+    typename binary_search_tree<K, V, Allocator, Balance, Augment>::iterator,
+    bool>
+binary_search_tree<K, V, Allocator, Balance, Augment>::emplace(Args &&...args) {
+  node *n = make_node(std::forward<Args>(args)...);
+  const auto [existing, parent] = find_slot(n->key());
+  if (existing != nullptr) {
+    destroy_node(n);
+    return {iterator(existing, this), false};
+  }
+
+  link(n, parent);
+  return {iterator(n, this), true};
+}
+
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename KeyArg, typename... Args>
+std::pair<
+    typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *,
+    bool>
+binary_search_tree<K, V, Allocator, Balance, Augment>::try_emplace_node(
+    KeyArg &&key, Args &&...args) {
+  const auto [existing, parent] = find_slot(key);
+  if (existing != nullptr) {
+    return {existing, false};
+  }
+
+  node *n = make_node(std::piecewise_construct,
+                      std::forward_as_tuple(std::forward<KeyArg>(key)),
+                      std::forward_as_tuple(std::forward<Args>(args)...));
+  link(n, parent);
+  return {n, true};
+}
+
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename KeyArg, typename M>
+std::pair<
+    typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *,
+    bool>
+binary_search_tree<K, V, Allocator, Balance, Augment>::insert_or_assign_node(
+    KeyArg &&key, M &&obj) {
+  const auto [existing, parent] = find_slot(key);
+  if (existing != nullptr) {
+    existing->value() = std::forward<M>(obj);
+    if constexpr (aggregated) {
+      refresh_up(existing);
+    }
+    return {existing, false};
   }
 
-  // traverse down the tree and find where we need to insert,
+  node *n = make_node(std::forward<KeyArg>(key), std::forward<M>(obj));
+  link(n, parent);
+  return {n, true};
+}
+
+// traverses down the tree, looking for where key is, or would be. returns the
+// node with the key, or null and the node the key would be a child of
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key>
+std::pair<
+    typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *,
+    typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *>
+binary_search_tree<K, V, Allocator, Balance, Augment>::find_slot(
+    const Key &key) const {
+  node *parent = nullptr;
   node *cur = _root;
   while (cur != nullptr) {
-    // if we're smaller that the current nodes key, move down the left branch
-    if (key < cur->key) {
-      if (cur->left == nullptr) {
-        _nodes++;
-        cur->left = new node(key, value);
-        return true;
-      }
+    // if we're smaller that the current nodes key, move down the left branch,
+    // if we're bigger, move down the right branch
+    if (key < cur->key()) {
+      parent = cur;
       cur = cur->left;
-    }  // if we're bigger than the current nodes key, move down the right
-       // branch
-    else if (key > cur->key) {
-      if (cur->right == nullptr) {
-        _nodes++;
-        cur->right = new node(key, value);
-        return true;
-      }
+    } else if (cur->key() < key) {
+      parent = cur;
       cur = cur->right;
     } else {
-      // do not insert duplicates
-      return false;
+      return {cur, parent};
     }
   }
 
-  return false;
+  return {nullptr, parent};
+}
+
+// links a new node in as a child of parent, or as the root if there is no
+// parent, and rebalances the tree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::link(node *n,
+                                                            node *parent) {
+  // a new node is a leaf, only its total does not start out right
+  if constexpr (aggregated) {
+    refresh(n);
+  }
+
+  n->parent = parent;
+  if (parent == nullptr) {
+    _root = n;
+  } else if (n->key() < parent->key()) {
+    parent->left = n;
+  } else {
+    parent->right = n;
+  }
+  _nodes++;
+
+  if constexpr (std::is_same_v<Balance, balance::avl>) {
+    avl_rebalance(parent);
+  } else if constexpr (std::is_same_v<Balance, balance::red_black>) {
+    n->red = true;
+    red_black_insert_fixup(n);
+    refresh_up(n);
+  } else {
+    refresh_up(parent);
+  }
+
+  return n;
 }
 
 // returns true if the key was removed,
 // false if key was not found in the tree
-template <typename K, typename V>
-bool binary_search_tree<K, V>::remove(K key) {
-  node *cur = _root;
-  node *parent = nullptr;
-
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key>
+bool binary_search_tree<K, V, Allocator, Balance, Augment>::remove(
+    const Key &key) {
   // find the node we're supposed to remove, and remember its parent
-  while (cur != nullptr) {
-    if (cur->key == key) {
-      break;
-    }
-    parent = cur;
-    if (key <= cur->key) {
-      cur = cur->left;
-    } else if (key > cur->key) {
-      cur = cur->right;
-    }
-  }
+  auto [cur, parent] = find_slot(key);
 
   // if we could not find the node, there is nothing to remove
   if (cur == nullptr) {
     return false;
   }
 
-  // the key we're trying to remove is in the root node
-  if (parent == nullptr) {
-    delete _root;
-    _root = nullptr;
-    return true;
-  }
-
-  // from here on there are three possible cases
-  // 1) we're removing a leaf node
-  // 2) we're removing a node with a single child
-  // 3) we're removing a node with two children
-
-  // removing a leaf node
-  if (cur->left == nullptr and cur->right == nullptr) {
-    // turn this reference into nullptr
-    delete cur;
-    cur = nullptr;
-    _nodes--;
-    return true;
-  }
-
-  // removing a node with one child
-  bool only_left_child = (cur->left != nullptr or cur->right == nullptr);
-  bool only_right_child = (cur->left == nullptr and cur->right != nullptr);
-  // connect the only child we have to our parent, essentially taking
-  // our place in the tree
-  if (only_left_child or only_right_child) {
-    if (only_left_child) {
-      if (parent->left == cur) {
-        parent->left = cur->left;
-      } else {
-        parent->right = cur->left;
-      }
-    } else {
-      if (parent->left == cur) {
-        parent->left = cur->right;
+  // when removing a node with two children, the smallest node in the right
+  // subtree takes our place, and we take its place. it is the leftmost node
+  // of the subtree, so we now have at most one child. the nodes are moved
+  // instead of their contents, so iterators to other elements stay valid
+  if (cur->left != nullptr and cur->right != nullptr) {
+    swap_with_successor(cur, leftmost(cur->right));
+    parent = cur->parent;
+  }
+
+  // from here on we're removing either a leaf node, or a node with a single
+  // child. connect the child (if any) to our parent, essentially letting it
+  // take our place in the tree
+  node *child = cur->left != nullptr ? cur->left : cur->right;
+  replace_child(parent, cur, child);
+  if (child != nullptr) {
+    child->parent = parent;
+  }
+
+  if constexpr (std::is_same_v<Balance, balance::avl>) {
+    avl_rebalance(parent);
+  } else if constexpr (std::is_same_v<Balance, balance::red_black>) {
+    // removing a black node leaves its paths one black node short
+    if (!cur->red) {
+      if (is_red(child)) {
+        child->red = false;
       } else {
-        parent->right = cur->right;
+        red_black_remove_fixup(child, parent);
       }
     }
+    refresh_up(parent);
+  } else {
+    refresh_up(parent);
+  }
 
-    delete cur;
-    cur = nullptr;
-    _nodes--;
-    return true;
+  destroy_node(cur);
+  _nodes--;
+  return true;
+}
+
+// builds the tree from a sorted range. the nodes are allocated in key order,
+// as one block if the allocator can, and then linked up with the middle node
+// of every range as the root of its subtree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename It>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::build(It first,
+                                                                  It last) {
+  std::vector<node *> nodes;
+  if constexpr (std::is_base_of_v<
+                    std::forward_iterator_tag,
+                    typename std::iterator_traits<It>::iterator_category>) {
+    nodes.reserve(std::distance(first, last));
+    _allocator.reserve(nodes.capacity());
   }
 
-  // removing a node with two children
-  // we replace outselves with the smallest value in the right subtree
-  if (cur->left != nullptr and cur->right != nullptr) {
-    node *right_child = cur->right;
-    // if our right child is a leaf node, overwrite ourselves with it
-    if (right_child->left == nullptr and right_child->right == nullptr) {
-      cur->key = right_child->key;
-      cur->right = nullptr;
-      delete right_child;
-      right_child = nullptr;
-      _nodes--;
-      return true;
-    }
-
-    // if our right child has a left child
-    // locate the smallest node in its subtree (i.e. the leftmost node)
-    if (right_child->left != nullptr) {
-      node *right_child_left = right_child->left;
-      node *right_child_left_parent = right_child;
-      while (right_child_left->left != nullptr) {
-        right_child_left_parent = right_child_left;
-        right_child_left = right_child_left->left;
-      }
-      cur->key = right_child_left->key;
-      right_child_left_parent->left = nullptr;
-      delete right_child_left;
-      right_child_left = nullptr;
-      _nodes--;
-      return true;
-    }
-    // otherwise we know that our right child is the smallest
-    // element in the subtree, everything to the right of it is bigger
-    cur->key = right_child->key;
-    cur->right = right_child->right;
-    delete right_child;
-    right_child = nullptr;
-    _nodes--;
-    return true;
-  }
-
-  return false;
-}
-
-template <typename K, typename V>
-typename binary_search_tree<K, V>::node *
-binary_search_tree<K, V>::find_recursive(node *n, K key) {
-  if (n == nullptr) {
+  for (; first != last; ++first) {
+    // moves the key and value out, if the iterator hands out rvalues
+    auto &&element = *first;
+    using element_type = decltype(element);
+    nodes.push_back(
+        make_node(std::get<0>(std::forward<element_type>(element)),
+                  std::get<1>(std::forward<element_type>(element))));
+  }
+
+  // the bottom level of the tree is the only one that may not be full
+  int height = 0;
+  while ((std::size_t{1} << height) <= nodes.size()) {
+    height++;
+  }
+
+  _root = link_sorted(nodes, 0, nodes.size(), nullptr, 1, height);
+  _nodes = static_cast<int>(nodes.size());
+}
+
+// makes the middle of nodes[first, last) the root of a subtree, with the
+// nodes on either side as its subtrees, and returns it
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::link_sorted(
+    const std::vector<node *> &nodes, std::size_t first, std::size_t last,
+    node *parent, int depth, int height) {
+  if (first == last) {
     return nullptr;
   }
-  if (n->key == key) {
-    return n;
+
+  const std::size_t middle = first + (last - first) / 2;
+  node *n = nodes[middle];
+  n->parent = parent;
+  n->left = link_sorted(nodes, first, middle, n, depth + 1, height);
+  n->right = link_sorted(nodes, middle + 1, last, n, depth + 1, height);
+  refresh(n);
+
+  // every path has the same number of nodes above the bottom level, so if
+  // the nodes on the bottom level are red, all paths have the same number of
+  // black nodes
+  n->red = std::is_same_v<Balance, balance::red_black> and depth == height and
+           depth > 1;
+
+  return n;
+}
+
+// puts new_child where old_child was under parent, or at the root if there is
+// no parent. does not update the parent of new_child
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::replace_child(
+    node *parent, node *old_child, node *new_child) {
+  if (parent == nullptr) {
+    _root = new_child;
+  } else if (parent->left == old_child) {
+    parent->left = new_child;
+  } else {
+    parent->right = new_child;
+  }
+}
+
+// swaps the places of n and s in the tree, where s is the leftmost node of the
+// right subtree of n. the heights and colors belong to the places, so they
+// are swapped as well
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::swap_with_successor(
+    node *n, node *s) {
+  node *s_parent = s->parent;
+  node *s_right = s->right;
+
+  replace_child(n->parent, n, s);
+  s->parent = n->parent;
+  s->left = n->left;
+  s->left->parent = s;
+
+  // s may be the right child of n
+  if (s_parent == n) {
+    s->right = n;
+    n->parent = s;
+  } else {
+    s->right = n->right;
+    s->right->parent = s;
+    s_parent->left = n;
+    n->parent = s_parent;
   }
 
-  if (key < n->key) {
-    return find_recursive(n->left, key);
+  n->left = nullptr;
+  n->right = s_right;
+  if (s_right != nullptr) {
+    s_right->parent = n;
   }
 
-  return find_recursive(n->right, key);
+  std::swap(n->height, s->height);
+  std::swap(n->red, s->red);
 }
 
-template <typename K, typename V>
-typename binary_search_tree<K, V>::node *
-binary_search_tree<K, V>::find_iterative(node *n, K key) {
-  node *cur = n;
-  while (cur != nullptr) {
-    if (cur->key == key) {
-      return cur;
+// moves the right child of n up to take its place, n becomes its left child,
+// and the old left subtree of the child becomes the right subtree of n. the
+// order of the keys does not change. returns the new root of the subtree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::rotate_left(node *n) {
+  node *r = n->right;
+
+  n->right = r->left;
+  if (r->left != nullptr) {
+    r->left->parent = n;
+  }
+
+  r->parent = n->parent;
+  replace_child(n->parent, n, r);
+
+  r->left = n;
+  n->parent = r;
+
+  refresh(n);
+  refresh(r);
+  return r;
+}
+
+// the mirror image of rotate_left
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::rotate_right(node *n) {
+  node *l = n->left;
+
+  n->left = l->right;
+  if (l->right != nullptr) {
+    l->right->parent = n;
+  }
+
+  l->parent = n->parent;
+  replace_child(n->parent, n, l);
+
+  l->right = n;
+  n->parent = l;
+
+  refresh(n);
+  refresh(l);
+  return l;
+}
+
+// walks from a node up to the root, refreshing every node on the way, and
+// rotating the ones whose subtrees differ in height by more than one
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::avl_rebalance(
+    node *n) {
+  while (n != nullptr) {
+    refresh(n);
+    const int balance = height_of(n->left) - height_of(n->right);
+
+    if (balance > 1) {
+      // the left-right case needs a double rotation
+      if (height_of(n->left->left) < height_of(n->left->right)) {
+        rotate_left(n->left);
+      }
+      n = rotate_right(n);
+    } else if (balance < -1) {
+      if (height_of(n->right->right) < height_of(n->right->left)) {
+        rotate_right(n->right);
+      }
+      n = rotate_left(n);
     }
-    if (key < cur->key) {
-      cur = cur->left;
-    } else if (key > cur->key) {
-      cur = cur->right;
+
+    n = n->parent;
+  }
+}
+
+// a new node is red, which is only a problem if its parent is red as well.
+// either the red is pushed up to the grandparent by recoloring, or the
+// grandparent is rotated to fix it for good
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+void
+binary_search_tree<K, V, Allocator, Balance, Augment>::red_black_insert_fixup(
+    node *n) {
+  while (is_red(n->parent)) {
+    node *parent = n->parent;
+    // the root is black, so a red parent always has a parent
+    node *grandparent = parent->parent;
+
+    if (parent == grandparent->left) {
+      node *uncle = grandparent->right;
+      if (is_red(uncle)) {
+        parent->red = false;
+        uncle->red = false;
+        grandparent->red = true;
+        n = grandparent;
+        continue;
+      }
+      if (n == parent->right) {
+        rotate_left(parent);
+        n = parent;
+        parent = n->parent;
+      }
+      parent->red = false;
+      grandparent->red = true;
+      rotate_right(grandparent);
+    } else {
+      node *uncle = grandparent->left;
+      if (is_red(uncle)) {
+        parent->red = false;
+        uncle->red = false;
+        grandparent->red = true;
+        n = grandparent;
+        continue;
+      }
+      if (n == parent->left) {
+        rotate_right(parent);
+        n = parent;
+        parent = n->parent;
+      }
+      parent->red = false;
+      grandparent->red = true;
+      rotate_left(grandparent);
+    }
+  }
+
+  _root->red = false;
+}
+
+// n (which may be null) has taken the place of a removed black node, so the
+// paths through it are one black node short. either the sibling can lend a
+// red node, or the shortage is pushed up to the parent
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+void
+binary_search_tree<K, V, Allocator, Balance, Augment>::red_black_remove_fixup(
+    node *n, node *parent) {
+  while (n != _root and !is_red(n)) {
+    // the paths through the sibling have at least one more black node than
+    // the ones through n, so the sibling exists
+    if (n == parent->left) {
+      node *sibling = parent->right;
+      if (sibling->red) {
+        sibling->red = false;
+        parent->red = true;
+        rotate_left(parent);
+        sibling = parent->right;
+      }
+      if (!is_red(sibling->left) and !is_red(sibling->right)) {
+        sibling->red = true;
+        n = parent;
+        parent = n->parent;
+        continue;
+      }
+      if (!is_red(sibling->right)) {
+        sibling->left->red = false;
+        sibling->red = true;
+        rotate_right(sibling);
+        sibling = parent->right;
+      }
+      sibling->red = parent->red;
+      parent->red = false;
+      sibling->right->red = false;
+      rotate_left(parent);
+    } else {
+      node *sibling = parent->left;
+      if (sibling->red) {
+        sibling->red = false;
+        parent->red = true;
+        rotate_right(parent);
+        sibling = parent->left;
+      }
+      if (!is_red(sibling->left) and !is_red(sibling->right)) {
+        sibling->red = true;
+        n = parent;
+        parent = n->parent;
+        continue;
+      }
+      if (!is_red(sibling->left)) {
+        sibling->right->red = false;
+        sibling->red = true;
+        rotate_left(sibling);
+        sibling = parent->left;
+      }
+      sibling->red = parent->red;
+      parent->red = false;
+      sibling->left->red = false;
+      rotate_right(parent);
     }
+    n = _root;
   }
 
-  return cur;
+  if (n != nullptr) {
+    n->red = false;
+  }
+}
+
+// frees all nodes of the tree. if the nodes do not need destroying, and the
+// allocator can free everything at once, the nodes are never visited.
+// otherwise the tree is flattened by rotating left children up, which visits
+// every node once without recursion, so deep trees can not overflow the stack
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::destroy_all() {
+  if constexpr (!std::is_trivially_destructible_v<node> or
+                !Allocator<node>::releases_all) {
+    node *cur = _root;
+    while (cur != nullptr) {
+      if (cur->left != nullptr) {
+        node *left = cur->left;
+        cur->left = left->right;
+        left->right = cur;
+        cur = left;
+      } else {
+        node *right = cur->right;
+        destroy_node(cur);
+        cur = right;
+      }
+    }
+  }
+
+  _allocator.release();
+  _root = nullptr;
+  _nodes = 0;
 }
 
 // traverse down the tree, looking for some key
-template <typename K, typename V>
-std::optional<V> binary_search_tree<K, V>::find(K key) {
-  // node *n = find_recursive(_root, key);
-  node *n = find_iterative(_root, key);
-  return n != nullptr ? std::optional<int>{n->value} : std::nullopt;
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::find_node(
+    const Key &key) const {
+  node *cur = _root;
+  while (cur != nullptr) {
+    if (key < cur->key()) {
+      cur = cur->left;
+    } else if (cur->key() < key) {
+      cur = cur->right;
+    } else {
+      return cur;
+    }
+  }
+
+  return nullptr;
 }
 
-// returns the (key,value) pair of the smallest value from the tree
-template <typename K, typename V>
-std::optional<std::tuple<K, V>> binary_search_tree<K, V>::min() {
+// returns references to the key and value of the smallest key in the tree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+std::optional<std::tuple<const K &, V &>>
+binary_search_tree<K, V, Allocator, Balance, Augment>::min() {
   if (_root == nullptr) {
     return std::nullopt;
   }
@@ -303,12 +1138,14 @@ std::optional<std::tuple<K, V>> binary_search_tree<K, V>::min() {
   while (cur->left != nullptr) {
     cur = cur->left;
   }
-  return std::make_tuple(cur->key, cur->value);
+  return std::tuple<const K &, V &>(cur->key(), cur->value());
 }
 
-// returns the (key,value) pair of the biggest value from the tree
-template <typename K, typename V>
-std::optional<std::tuple<K, V>> binary_search_tree<K, V>::max() {
+// returns references to the key and value of the biggest key in the tree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+std::optional<std::tuple<const K &, V &>>
+binary_search_tree<K, V, Allocator, Balance, Augment>::max() {
   if (_root == nullptr) {
     return std::nullopt;
   }
@@ -317,101 +1154,285 @@ std::optional<std::tuple<K, V>> binary_search_tree<K, V>::max() {
   while (cur->right != nullptr) {
     cur = cur->right;
   }
-  return std::make_tuple(cur->key, cur->value);
+  return std::tuple<const K &, V &>(cur->key(), cur->value());
 }
 
 // how many levels the tree has
-template <typename K, typename V>
-int binary_search_tree<K, V>::height() {
-  if (_root == nullptr) {
-    return 0;
-  }
-
-  node *cur_left = _root;
-  node *cur_right = _root;
-
-  // why is this the case? why can we only have cases where the tree
-  // is bigger in either the smallest or biggest positions? (i.e. all
-  // left, or all right)
-  int left_height = 0, right_height = 0;
-  while (cur_left != nullptr) {
-    left_height++;
-    cur_left = cur_left->left;
-  }
-  while (cur_right != nullptr) {
-    right_height++;
-    cur_right = cur_right->right;
-  }
-
-  return std::max(left_height, right_height);
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+int binary_search_tree<K, V, Allocator, Balance, Augment>::height() {
+  return height_of(_root);
 }
 
 // the number of nodes in the tree
-template <typename K, typename V>
-int binary_search_tree<K, V>::size() {
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+int binary_search_tree<K, V, Allocator, Balance, Augment>::size() {
   return _nodes;
 }
 
-template <typename K, typename V>
-void binary_search_tree<K, V>::inorder(
-    node *n, std::function<void(std::tuple<K, V>)> callback) {
-  if (n->left != nullptr) {
-    inorder(n->left, callback);
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::lower_bound_node(
+    const Key &key) const {
+  node *bound = nullptr;
+  node *cur = _root;
+  while (cur != nullptr) {
+    if (cur->key() < key) {
+      cur = cur->right;
+    } else {
+      bound = cur;
+      cur = cur->left;
+    }
+  }
+  return bound;
+}
+
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::upper_bound_node(
+    const Key &key) const {
+  node *bound = nullptr;
+  node *cur = _root;
+  while (cur != nullptr) {
+    if (key < cur->key()) {
+      bound = cur;
+      cur = cur->left;
+    } else {
+      cur = cur->right;
+    }
   }
+  return bound;
+}
 
-  callback({n->key, n->value});
+// walks the tree with a stack of the nodes whose right subtrees are still to
+// be seen. it is faster than following the parent pointers back up, which
+// touches the nodes a second time, and does not recurse, so degenerate trees
+// can not overflow the call stack
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename F>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::inorder(
+    F &&callback) {
+  std::vector<node *> stack;
+  stack.reserve(height_of(_root));
 
-  if (n->right != nullptr) {
-    inorder(n->right, callback);
+  node *n = _root;
+  while (n != nullptr or !stack.empty()) {
+    if (n != nullptr) {
+      stack.push_back(n);
+      n = n->left;
+    } else {
+      n = stack.back();
+      stack.pop_back();
+      visit(callback, n);
+      n = n->right;
+    }
   }
 }
 
-template <typename K, typename V>
-void binary_search_tree<K, V>::inorder(
-    std::function<void(std::tuple<K, V>)> callback) {
-  inorder(_root, callback);
+// visits a node, then goes left if it can, otherwise right, and from a leaf
+// climbs back up to the first ancestor with a right subtree it has not seen
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename F>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::preorder(
+    F &&callback) {
+  node *n = _root;
+  while (n != nullptr) {
+    visit(callback, n);
+
+    if (n->left != nullptr) {
+      n = n->left;
+    } else if (n->right != nullptr) {
+      n = n->right;
+    } else {
+      while (n->parent != nullptr and
+             (n == n->parent->right or n->parent->right == nullptr)) {
+        n = n->parent;
+      }
+      n = n->parent != nullptr ? n->parent->right : nullptr;
+    }
+  }
 }
 
-template <typename K, typename V>
-void binary_search_tree<K, V>::preorder(
-    node *n, std::function<void(std::tuple<K, V>)> callback) {
-  callback({n->key, n->value});
+// the first node of a subtree in postorder is the leaf we reach by going left
+// whenever we can, and right otherwise. a node comes after its right subtree,
+// or after its left subtree when it has no right one
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename F>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::postorder(
+    F &&callback) {
+  const auto first_leaf = [](node *n) {
+    while (n->left != nullptr or n->right != nullptr) {
+      n = n->left != nullptr ? n->left : n->right;
+    }
+    return n;
+  };
+
+  node *n = _root != nullptr ? first_leaf(_root) : nullptr;
+  while (n != nullptr) {
+    node *parent = n->parent;
+    node *next = parent;
+    if (parent != nullptr and n == parent->left and parent->right != nullptr) {
+      next = first_leaf(parent->right);
+    }
 
-  if (n->left != nullptr) {
-    preorder(n->left, callback);
+    visit(callback, n);
+    n = next;
   }
+}
+
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key, typename F>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::range(
+    const Key &lo, const Key &hi, F &&callback) {
+  for (node *n = lower_bound_node(lo); n != nullptr and n->key() < hi;
+       n = successor(n)) {
+    visit(callback, n);
+  }
+}
 
-  if (n->right != nullptr) {
-    preorder(n->right, callback);
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key, typename F>
+void binary_search_tree<K, V, Allocator, Balance, Augment>::range(
+    const Key &lo, const Key &hi, F &&callback) const {
+  for (node *n = lower_bound_node(lo); n != nullptr and n->key() < hi;
+       n = successor(n)) {
+    visit(callback, static_cast<const node *>(n));
   }
 }
 
-template <typename K, typename V>
-void binary_search_tree<K, V>::preorder(
-    std::function<void(std::tuple<K, V>)> callback) {
-  preorder(_root, callback);
+// counts the nodes left of the path down to where key is, or would be
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key>
+int binary_search_tree<K, V, Allocator, Balance, Augment>::rank(
+    const Key &key) const {
+  static_assert(sized, "rank needs a tree with subtree sizes");
+
+  int rank = 0;
+  const node *cur = _root;
+  while (cur != nullptr) {
+    if (cur->key() < key) {
+      rank += size_of(cur->left) + 1;
+      cur = cur->right;
+    } else {
+      cur = cur->left;
+    }
+  }
+  return rank;
 }
 
-template <typename K, typename V>
-void binary_search_tree<K, V>::postorder(
-    node *n, std::function<void(std::tuple<K, V>)> callback) {
-  if (n->left != nullptr) {
-    postorder(n->left, callback);
+// the size of the left subtree is the position of a node within its subtree,
+// so that is where we go left, stop, or go right
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+typename binary_search_tree<K, V, Allocator, Balance, Augment>::node *
+binary_search_tree<K, V, Allocator, Balance, Augment>::select_node(
+    int i) const {
+  static_assert(sized, "select needs a tree with subtree sizes");
+
+  node *cur = i >= 0 ? _root : nullptr;
+  while (cur != nullptr) {
+    const int left = size_of(cur->left);
+    if (i < left) {
+      cur = cur->left;
+    } else if (i > left) {
+      i -= left + 1;
+      cur = cur->right;
+    } else {
+      return cur;
+    }
   }
+  return nullptr;
+}
 
-  if (n->right != nullptr) {
-    postorder(n->right, callback);
+// the combined values of the keys in the subtree of n that are not less than
+// lo. every node we keep on the way down comes before the ones we kept
+// already, along with its right subtree
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key, typename M>
+typename M::value_type
+binary_search_tree<K, V, Allocator, Balance, Augment>::aggregate_from(
+    const node *n, const Key &lo) {
+  auto total = M::identity();
+  while (n != nullptr) {
+    if (n->key() < lo) {
+      n = n->right;
+    } else {
+      total = M::combine(M::combine(lift(n), total_of(n->right)), total);
+      n = n->left;
+    }
   }
+  return total;
+}
 
-  callback({n->key, n->value});
+// the combined values of the keys in the subtree of n that are less than hi,
+// the mirror image of aggregate_from
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key, typename M>
+typename M::value_type
+binary_search_tree<K, V, Allocator, Balance, Augment>::aggregate_below(
+    const node *n, const Key &hi) {
+  auto total = M::identity();
+  while (n != nullptr) {
+    if (n->key() < hi) {
+      total = M::combine(total, M::combine(total_of(n->left), lift(n)));
+      n = n->right;
+    } else {
+      n = n->left;
+    }
+  }
+  return total;
 }
 
-template <typename K, typename V>
-void binary_search_tree<K, V>::postorder(
-    std::function<void(std::tuple<K, V>)> callback) {
-  postorder(_root, callback);
+// goes down to the first node in [lo, hi), where the paths to lo and hi split,
+// and combines what is in range on either side of it. the monoid does not
+// have to be commutative, or have inverses
+template <typename K, typename V, template <typename> class Allocator,
+          typename Balance, typename Augment>
+template <typename Key, typename M>
+typename M::value_type
+binary_search_tree<K, V, Allocator, Balance, Augment>::aggregate_range(
+    const Key &lo, const Key &hi) const {
+  static_assert(aggregated, "aggregate_range needs an augment::aggregate tree");
+
+  const node *cur = _root;
+  while (cur != nullptr) {
+    if (cur->key() < lo) {
+      cur = cur->right;
+    } else if (!(cur->key() < hi)) {
+      cur = cur->left;
+    } else {
+      return M::combine(
+          M::combine(aggregate_from(cur->left, lo), lift(cur)),
+          aggregate_below(cur->right, hi));
+    }
+  }
+  return M::identity();
 }
 
+template <typename K, typename V,
+          template <typename> class Allocator = utils::pool_allocator,
+          typename Augment = augment::none>
+using avl_tree = binary_search_tree<K, V, Allocator, balance::avl, Augment>;
+
+template <typename K, typename V,
+          template <typename> class Allocator = utils::pool_allocator,
+          typename Augment = augment::none>
+using red_black_tree =
+    binary_search_tree<K, V, Allocator, balance::red_black, Augment>;
+
 }  // namespace dads::trees
 
 #endif
@@ -0,0 +1,648 @@
+#ifndef BTREE_HPP
+#define BTREE_HPP
+/*
+  A B+-tree, an ordered map that keeps many keys in each node.
+  Inner nodes hold up to Fanout children, and the keys that separate them.
+  All values are in the leaves, which are linked together in key order, so
+  walking a range of keys is a walk along a list of arrays.
+  A binary search tree does a (likely) cache miss for every level of a
+  lookup, here a level is a scan over a few consecutive cache lines, and there
+  are log_{Fanout / 2}(n) levels instead of log_2(n).
+  The default fanout puts 256 bytes of keys in every node, four cache lines.
+  Keys and values have to be default constructible, since nodes are arrays.
+  Time Complexity:
+  - space:  O(n)
+  - find:   O(log n)
+  - insert: O(log n)
+  - remove: O(log n)
+  - min:    O(log n)
+  - max:    O(log n)
+  - height: O(1)
+  - range:  O(log n + k), for k keys in the range
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace dads::trees {
+
+template <typename K>
+constexpr std::size_t btree_default_fanout =
+    std::max<std::size_t>(8, 256 / sizeof(K));
+
+template <typename K, typename V, std::size_t Fanout = btree_default_fanout<K>>
+class btree {
+  static_assert(Fanout >= 4, "btree nodes need room for at least 4 keys");
+
+ private:
+  // nodes, except the root, are kept at least half full
+  static constexpr std::size_t min_keys = Fanout / 2;
+  static constexpr std::size_t min_children = Fanout / 2;
+  // the most levels a tree can have, even with 2^64 keys
+  static constexpr std::size_t max_height = 64;
+
+  struct node {
+    bool is_leaf;
+    // the number of keys in a leaf, or children in an inner node
+    std::size_t count{0};
+
+    explicit node(bool is_leaf) : is_leaf(is_leaf) {}
+  };
+
+  struct leaf : node {
+    std::array<K, Fanout> keys;
+    std::array<V, Fanout> values;
+    leaf *prev{nullptr};
+    leaf *next{nullptr};
+
+    leaf() : node(true) {}
+  };
+
+  // keys[i] separates children[i] and children[i + 1], the keys in
+  // children[i] are smaller than it, and the keys in children[i + 1] are not
+  struct inner : node {
+    std::array<K, Fanout - 1> keys;
+    std::array<node *, Fanout> children;
+
+    inner() : node(false) {}
+  };
+
+  node *_root{nullptr};
+  int _size{0};
+  int _height{0};
+
+  // keys that can be compared four at a time with SSE2
+  static constexpr bool simd_keys =
+#ifdef __SSE2__
+      std::is_integral_v<K> and std::is_signed_v<K> and sizeof(K) == 4;
+#else
+      false;
+#endif
+
+  // the position of a key among the first n keys of a node, the first key
+  // that is not less than it (lower bound), or the first key that is bigger
+  // than it (upper bound).
+  // 32-bit keys are scanned four at a time, stopping at the first block that
+  // has the position, a node is only a few cache lines, so this beats a binary
+  // search. other numbers use a binary search without branches, which the
+  // compiler turns into conditional moves
+  template <bool Upper, std::size_t N>
+  static std::size_t search(const std::array<K, N> &keys, std::size_t n,
+                            const K &key) {
+    // true for the keys that come before the position
+    auto before = [&key](const K &k) { return Upper ? !(key < k) : k < key; };
+
+    if constexpr (simd_keys) {
+#ifdef __SSE2__
+      const __m128i needle = _mm_set1_epi32(key);
+      std::size_t j = 0;
+      for (; j + 4 <= n; j += 4) {
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(&keys[j]));
+        // a bit for every key in the block that is past the position
+        const int past =
+            Upper ? _mm_movemask_ps(
+                        _mm_castsi128_ps(_mm_cmpgt_epi32(block, needle)))
+                  : ~_mm_movemask_ps(
+                        _mm_castsi128_ps(_mm_cmplt_epi32(block, needle))) &
+                        0xF;
+        if (past != 0) {
+          return j + __builtin_ctz(past);
+        }
+      }
+      while (j < n and before(keys[j])) {
+        j++;
+      }
+      return j;
+#endif
+    } else if constexpr (std::is_arithmetic_v<K>) {
+      if (n == 0) {
+        return 0;
+      }
+      const K *base = keys.data();
+      while (n > 1) {
+        const std::size_t half = n / 2;
+        base += before(base[half]) ? half : 0;
+        n -= half;
+      }
+      return (base - keys.data()) + before(*base);
+    } else {
+      return std::partition_point(keys.begin(), keys.begin() + n, before) -
+             keys.begin();
+    }
+  }
+
+  template <std::size_t N>
+  static std::size_t lower_bound(const std::array<K, N> &keys, std::size_t n,
+                                 const K &key) {
+    return search<false>(keys, n, key);
+  }
+
+  template <std::size_t N>
+  static std::size_t upper_bound(const std::array<K, N> &keys, std::size_t n,
+                                 const K &key) {
+    return search<true>(keys, n, key);
+  }
+
+  static inner *as_inner(node *n) { return static_cast<inner *>(n); }
+  static leaf *as_leaf(node *n) { return static_cast<leaf *>(n); }
+
+  // the child of an inner node that could hold key
+  static std::size_t child_index(const inner *n, const K &key) {
+    return upper_bound(n->keys, n->count - 1, key);
+  }
+
+  // the leaf that could hold key
+  leaf *find_leaf(const K &key) const {
+    node *n = _root;
+    while (!n->is_leaf) {
+      inner *in = as_inner(n);
+      n = in->children[child_index(in, key)];
+    }
+    return as_leaf(n);
+  }
+
+  leaf *first_leaf() const {
+    node *n = _root;
+    while (!n->is_leaf) {
+      n = as_inner(n)->children[0];
+    }
+    return as_leaf(n);
+  }
+
+  leaf *last_leaf() const {
+    node *n = _root;
+    while (!n->is_leaf) {
+      n = as_inner(n)->children[n->count - 1];
+    }
+    return as_leaf(n);
+  }
+
+  static void destroy(node *n) {
+    if (n->is_leaf) {
+      delete as_leaf(n);
+      return;
+    }
+
+    inner *in = as_inner(n);
+    for (std::size_t i = 0; i < in->count; i++) {
+      destroy(in->children[i]);
+    }
+    delete in;
+  }
+
+  void rebalance_leaf(leaf *l, inner *parent, std::size_t i);
+  void rebalance_inner(inner *n, inner *parent, std::size_t i);
+
+ public:
+  btree() = default;
+  btree(std::initializer_list<std::tuple<K, V>> elements) {
+    for (auto kvp : elements) {
+      insert(std::get<0>(kvp), std::get<1>(kvp));
+    }
+  }
+
+  btree(const btree &) = delete;
+  btree &operator=(const btree &) = delete;
+  btree(btree &&) = delete;
+  btree &operator=(btree &&) = delete;
+
+  ~btree() {
+    if (_root != nullptr) {
+      destroy(_root);
+    }
+  }
+
+  bool insert(K key, V value);
+  bool remove(const K &key);
+  std::optional<V> find(const K &key) const;
+  std::optional<std::tuple<K, V>> min() const;
+  std::optional<std::tuple<K, V>> max() const;
+  int height() const { return _height; }
+  int size() const { return _size; }
+
+  // calls callback(std::tuple<K, V>) for every element, in key order
+  template <typename F>
+  void inorder(F &&callback) const;
+
+  // calls callback(key, value) for every key in [lo, hi), in key order
+  template <typename F>
+  void range(const K &lo, const K &hi, F &&callback) const;
+};
+
+// returns true if the key was inserted,
+// false if it was already in the tree
+template <typename K, typename V, std::size_t Fanout>
+bool btree<K, V, Fanout>::insert(K key, V value) {
+  if (_root == nullptr) {
+    leaf *l = new leaf();
+    l->keys[0] = std::move(key);
+    l->values[0] = std::move(value);
+    l->count = 1;
+    _root = l;
+    _size = 1;
+    _height = 1;
+    return true;
+  }
+
+  // walk down to the leaf, remembering the way, so splits can be passed back
+  // up to the parents
+  std::array<std::pair<inner *, std::size_t>, max_height> path;
+  std::size_t depth = 0;
+
+  node *n = _root;
+  while (!n->is_leaf) {
+    inner *in = as_inner(n);
+    const std::size_t i = child_index(in, key);
+    path[depth++] = {in, i};
+    n = in->children[i];
+  }
+
+  leaf *l = as_leaf(n);
+  const std::size_t pos = lower_bound(l->keys, l->count, key);
+  if (pos < l->count and l->keys[pos] == key) {
+    // do not insert duplicates
+    return false;
+  }
+  _size++;
+
+  if (l->count < Fanout) {
+    std::move_backward(l->keys.begin() + pos, l->keys.begin() + l->count,
+                       l->keys.begin() + l->count + 1);
+    std::move_backward(l->values.begin() + pos, l->values.begin() + l->count,
+                       l->values.begin() + l->count + 1);
+    l->keys[pos] = std::move(key);
+    l->values[pos] = std::move(value);
+    l->count++;
+    return true;
+  }
+
+  // the leaf is full, split it in two halves, and put the new key in the half
+  // it belongs to
+  leaf *right = new leaf();
+  const std::size_t half = (Fanout + 1) / 2;
+  const bool goes_left = pos < half;
+  const std::size_t split = goes_left ? half - 1 : half;
+
+  std::move(l->keys.begin() + split, l->keys.begin() + l->count,
+            right->keys.begin());
+  std::move(l->values.begin() + split, l->values.begin() + l->count,
+            right->values.begin());
+  right->count = l->count - split;
+  l->count = split;
+
+  leaf *target = goes_left ? l : right;
+  const std::size_t at = goes_left ? pos : pos - split;
+  std::move_backward(target->keys.begin() + at,
+                     target->keys.begin() + target->count,
+                     target->keys.begin() + target->count + 1);
+  std::move_backward(target->values.begin() + at,
+                     target->values.begin() + target->count,
+                     target->values.begin() + target->count + 1);
+  target->keys[at] = std::move(key);
+  target->values[at] = std::move(value);
+  target->count++;
+
+  right->next = l->next;
+  right->prev = l;
+  if (l->next != nullptr) {
+    l->next->prev = right;
+  }
+  l->next = right;
+
+  // pass the split up, each parent gets a new key and child, and may have to
+  // split as well
+  K separator = right->keys[0];
+  node *new_child = right;
+
+  while (depth > 0) {
+    auto [in, i] = path[--depth];
+
+    if (in->count < Fanout) {
+      std::move_backward(in->keys.begin() + i, in->keys.begin() + in->count - 1,
+                         in->keys.begin() + in->count);
+      std::move_backward(in->children.begin() + i + 1,
+                         in->children.begin() + in->count,
+                         in->children.begin() + in->count + 1);
+      in->keys[i] = std::move(separator);
+      in->children[i + 1] = new_child;
+      in->count++;
+      return true;
+    }
+
+    // lay out the Fanout + 1 children, and Fanout keys, in order, then give
+    // the first half to the node, and the rest to a new node. the key in the
+    // middle moves up to the parent
+    std::array<K, Fanout> keys;
+    std::array<node *, Fanout + 1> children;
+    std::move(in->keys.begin(), in->keys.begin() + i, keys.begin());
+    keys[i] = std::move(separator);
+    std::move(in->keys.begin() + i, in->keys.end(), keys.begin() + i + 1);
+    std::copy(in->children.begin(), in->children.begin() + i + 1,
+              children.begin());
+    children[i + 1] = new_child;
+    std::copy(in->children.begin() + i + 1, in->children.end(),
+              children.begin() + i + 2);
+
+    const std::size_t left_children = (Fanout + 2) / 2;
+    inner *sibling = new inner();
+
+    std::move(keys.begin(), keys.begin() + left_children - 1, in->keys.begin());
+    std::copy(children.begin(), children.begin() + left_children,
+              in->children.begin());
+    in->count = left_children;
+
+    std::move(keys.begin() + left_children, keys.end(),
+              sibling->keys.begin());
+    std::copy(children.begin() + left_children, children.end(),
+              sibling->children.begin());
+    sibling->count = Fanout + 1 - left_children;
+
+    separator = std::move(keys[left_children - 1]);
+    new_child = sibling;
+  }
+
+  // the root was split, so the tree grows a level
+  inner *root = new inner();
+  root->keys[0] = std::move(separator);
+  root->children[0] = _root;
+  root->children[1] = new_child;
+  root->count = 2;
+  _root = root;
+  _height++;
+
+  return true;
+}
+
+// returns true if the key was removed,
+// false if key was not found in the tree
+template <typename K, typename V, std::size_t Fanout>
+bool btree<K, V, Fanout>::remove(const K &key) {
+  if (_root == nullptr) {
+    return false;
+  }
+
+  std::array<std::pair<inner *, std::size_t>, max_height> path;
+  std::size_t depth = 0;
+
+  node *n = _root;
+  while (!n->is_leaf) {
+    inner *in = as_inner(n);
+    const std::size_t i = child_index(in, key);
+    path[depth++] = {in, i};
+    n = in->children[i];
+  }
+
+  leaf *l = as_leaf(n);
+  const std::size_t pos = lower_bound(l->keys, l->count, key);
+  if (pos == l->count or !(l->keys[pos] == key)) {
+    return false;
+  }
+
+  std::move(l->keys.begin() + pos + 1, l->keys.begin() + l->count,
+            l->keys.begin() + pos);
+  std::move(l->values.begin() + pos + 1, l->values.begin() + l->count,
+            l->values.begin() + pos);
+  l->count--;
+  _size--;
+
+  // the separators above the leaf may still hold the removed key, which is
+  // fine, they only have to be ordered with respect to the keys around them
+  if (depth == 0) {
+    if (l->count == 0) {
+      delete l;
+      _root = nullptr;
+      _height = 0;
+    }
+    return true;
+  }
+
+  if (l->count >= min_keys) {
+    return true;
+  }
+
+  auto [parent, i] = path[--depth];
+  rebalance_leaf(l, parent, i);
+
+  // merging children can leave the parents too empty as well
+  while (depth > 0 and parent->count < min_children) {
+    auto [grandparent, j] = path[--depth];
+    rebalance_inner(parent, grandparent, j);
+    parent = grandparent;
+  }
+
+  // a root with a single child is not needed, the tree shrinks a level
+  if (_root == parent and parent->count == 1) {
+    _root = parent->children[0];
+    delete parent;
+    _height--;
+  }
+
+  return true;
+}
+
+// fills up a leaf that has too few keys, the i'th child of its parent, by
+// borrowing a key from a sibling, or merging it with a sibling
+template <typename K, typename V, std::size_t Fanout>
+void btree<K, V, Fanout>::rebalance_leaf(leaf *l, inner *parent,
+                                         std::size_t i) {
+  leaf *left = i > 0 ? as_leaf(parent->children[i - 1]) : nullptr;
+  leaf *right =
+      i + 1 < parent->count ? as_leaf(parent->children[i + 1]) : nullptr;
+
+  if (left != nullptr and left->count > min_keys) {
+    std::move_backward(l->keys.begin(), l->keys.begin() + l->count,
+                       l->keys.begin() + l->count + 1);
+    std::move_backward(l->values.begin(), l->values.begin() + l->count,
+                       l->values.begin() + l->count + 1);
+    l->keys[0] = std::move(left->keys[left->count - 1]);
+    l->values[0] = std::move(left->values[left->count - 1]);
+    l->count++;
+    left->count--;
+    parent->keys[i - 1] = l->keys[0];
+    return;
+  }
+
+  if (right != nullptr and right->count > min_keys) {
+    l->keys[l->count] = std::move(right->keys[0]);
+    l->values[l->count] = std::move(right->values[0]);
+    l->count++;
+    std::move(right->keys.begin() + 1, right->keys.begin() + right->count,
+              right->keys.begin());
+    std::move(right->values.begin() + 1, right->values.begin() + right->count,
+              right->values.begin());
+    right->count--;
+    parent->keys[i] = right->keys[0];
+    return;
+  }
+
+  // neither sibling can spare a key, so merge with one of them. the right one
+  // of the pair is emptied into the left one, and removed from the parent
+  if (left == nullptr) {
+    left = l;
+    i++;
+  }
+  leaf *gone = as_leaf(parent->children[i]);
+
+  std::move(gone->keys.begin(), gone->keys.begin() + gone->count,
+            left->keys.begin() + left->count);
+  std::move(gone->values.begin(), gone->values.begin() + gone->count,
+            left->values.begin() + left->count);
+  left->count += gone->count;
+
+  left->next = gone->next;
+  if (gone->next != nullptr) {
+    gone->next->prev = left;
+  }
+  delete gone;
+
+  std::move(parent->keys.begin() + i, parent->keys.begin() + parent->count - 1,
+            parent->keys.begin() + i - 1);
+  std::move(parent->children.begin() + i + 1,
+            parent->children.begin() + parent->count,
+            parent->children.begin() + i);
+  parent->count--;
+}
+
+// the same as rebalance_leaf, for inner nodes. borrowed children take their
+// separator from the parent, and give the parent theirs
+template <typename K, typename V, std::size_t Fanout>
+void btree<K, V, Fanout>::rebalance_inner(inner *n, inner *parent,
+                                          std::size_t i) {
+  inner *left = i > 0 ? as_inner(parent->children[i - 1]) : nullptr;
+  inner *right =
+      i + 1 < parent->count ? as_inner(parent->children[i + 1]) : nullptr;
+
+  if (left != nullptr and left->count > min_children) {
+    std::move_backward(n->keys.begin(), n->keys.begin() + n->count - 1,
+                       n->keys.begin() + n->count);
+    std::move_backward(n->children.begin(), n->children.begin() + n->count,
+                       n->children.begin() + n->count + 1);
+    n->keys[0] = std::move(parent->keys[i - 1]);
+    n->children[0] = left->children[left->count - 1];
+    n->count++;
+    parent->keys[i - 1] = std::move(left->keys[left->count - 2]);
+    left->count--;
+    return;
+  }
+
+  if (right != nullptr and right->count > min_children) {
+    n->keys[n->count - 1] = std::move(parent->keys[i]);
+    n->children[n->count] = right->children[0];
+    n->count++;
+    parent->keys[i] = std::move(right->keys[0]);
+    std::move(right->keys.begin() + 1, right->keys.begin() + right->count - 1,
+              right->keys.begin());
+    std::move(right->children.begin() + 1,
+              right->children.begin() + right->count,
+              right->children.begin());
+    right->count--;
+    return;
+  }
+
+  if (left == nullptr) {
+    left = n;
+    i++;
+  }
+  inner *gone = as_inner(parent->children[i]);
+
+  // the separator between the two comes down from the parent
+  left->keys[left->count - 1] = std::move(parent->keys[i - 1]);
+  std::move(gone->keys.begin(), gone->keys.begin() + gone->count - 1,
+            left->keys.begin() + left->count);
+  std::copy(gone->children.begin(), gone->children.begin() + gone->count,
+            left->children.begin() + left->count);
+  left->count += gone->count;
+  delete gone;
+
+  std::move(parent->keys.begin() + i, parent->keys.begin() + parent->count - 1,
+            parent->keys.begin() + i - 1);
+  std::move(parent->children.begin() + i + 1,
+            parent->children.begin() + parent->count,
+            parent->children.begin() + i);
+  parent->count--;
+}
+
+template <typename K, typename V, std::size_t Fanout>
+std::optional<V> btree<K, V, Fanout>::find(const K &key) const {
+  if (_root == nullptr) {
+    return std::nullopt;
+  }
+
+  const leaf *l = find_leaf(key);
+  const std::size_t pos = lower_bound(l->keys, l->count, key);
+  if (pos < l->count and l->keys[pos] == key) {
+    return l->values[pos];
+  }
+  return std::nullopt;
+}
+
+// returns the (key,value) pair of the smallest key in the tree
+template <typename K, typename V, std::size_t Fanout>
+std::optional<std::tuple<K, V>> btree<K, V, Fanout>::min() const {
+  if (_root == nullptr) {
+    return std::nullopt;
+  }
+
+  const leaf *l = first_leaf();
+  return std::make_tuple(l->keys[0], l->values[0]);
+}
+
+// returns the (key,value) pair of the biggest key in the tree
+template <typename K, typename V, std::size_t Fanout>
+std::optional<std::tuple<K, V>> btree<K, V, Fanout>::max() const {
+  if (_root == nullptr) {
+    return std::nullopt;
+  }
+
+  const leaf *l = last_leaf();
+  return std::make_tuple(l->keys[l->count - 1], l->values[l->count - 1]);
+}
+
+template <typename K, typename V, std::size_t Fanout>
+template <typename F>
+void btree<K, V, Fanout>::inorder(F &&callback) const {
+  if (_root == nullptr) {
+    return;
+  }
+
+  for (const leaf *l = first_leaf(); l != nullptr; l = l->next) {
+    for (std::size_t i = 0; i < l->count; i++) {
+      callback(std::tuple<K, V>(l->keys[i], l->values[i]));
+    }
+  }
+}
+
+template <typename K, typename V, std::size_t Fanout>
+template <typename F>
+void btree<K, V, Fanout>::range(const K &lo, const K &hi, F &&callback) const {
+  if (_root == nullptr) {
+    return;
+  }
+
+  // find the first key in the range, then follow the leaves
+  const leaf *l = find_leaf(lo);
+  std::size_t i = lower_bound(l->keys, l->count, lo);
+  for (; l != nullptr; l = l->next, i = 0) {
+    for (; i < l->count; i++) {
+      if (!(l->keys[i] < hi)) {
+        return;
+      }
+      callback(l->keys[i], l->values[i]);
+    }
+  }
+}
+
+}  // namespace dads::trees
+
+#endif
@@ -0,0 +1,357 @@
+#ifndef CONCURRENT_SKIP_LIST_HPP
+#define CONCURRENT_SKIP_LIST_HPP
+/*
+  A concurrent ordered map, as a skip list, which any number of threads can
+  insert into, remove from, and search at the same time.
+  It is the lazy skip list of Herlihy, Lev, Luchangco, and Shavit: find never
+  locks, never writes to shared memory, and never retries, so readers scale
+  with the number of cores. insert and remove lock only the nodes right
+  before the position they change, so writers to different parts of the list
+  do not wait for each other.
+  Removed nodes are handed to an epoch_domain, which deletes them once no
+  reader can still be looking at them.
+  Time Complexity: (expected)
+  - space:  O(n)
+  - find:   O(log n)
+  - insert: O(log n)
+  - remove: O(log n)
+  A node has a random number of levels, each level is a linked list that skips
+  over about half of the nodes of the level below it. The links of a node are
+  allocated along with it, so a node with one level costs one pointer of
+  links. Skipping over more nodes per level makes the nodes smaller, but a
+  search then touches more of them, and that is what a search pays for, once
+  the list does not fit in the cache.
+  find returns a copy of the value, values can not be changed once they are in
+  the list.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <utils/epoch_domain.hpp>
+
+namespace dads::trees {
+
+template <typename K, typename V>
+class concurrent_skip_list {
+ private:
+  static constexpr int max_height = 32;
+
+  struct node;
+
+  // the part of a node that links it into the list, the head of the list is
+  // only a tower
+  struct tower {
+    // height links, allocated right after the node
+    std::atomic<node *> *next{nullptr};
+    int height{0};
+    // set when the node is being removed, it is still in the list until its
+    // predecessors are relinked
+    std::atomic<bool> marked{false};
+    // set when the node is linked in at every level, before that it is not
+    // in the map yet
+    std::atomic<bool> fully_linked{false};
+    std::atomic<bool> locked{false};
+
+    void lock() {
+      while (locked.exchange(true, std::memory_order_acquire)) {
+        while (locked.load(std::memory_order_relaxed)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    void unlock() { locked.store(false, std::memory_order_release); }
+  };
+
+  struct node : tower {
+    const K key;
+    const V value;
+
+    node(K k, V v) : key(std::move(k)), value(std::move(v)) {}
+  };
+
+  // where the links of a T start, in its allocation
+  template <typename T>
+  static constexpr std::size_t links_offset =
+      (sizeof(T) + alignof(std::atomic<node *>) - 1) /
+      alignof(std::atomic<node *>) * alignof(std::atomic<node *>);
+
+  template <typename T, typename... Args>
+  static T *make(int height, Args &&...args) {
+    void *memory = ::operator new(links_offset<T> +
+                                  height * sizeof(std::atomic<node *>));
+    T *t = new (memory) T(std::forward<Args>(args)...);
+    t->next = reinterpret_cast<std::atomic<node *> *>(
+        static_cast<char *>(memory) + links_offset<T>);
+    for (int i = 0; i < height; i++) {
+      new (t->next + i) std::atomic<node *>(nullptr);
+    }
+    t->height = height;
+    return t;
+  }
+
+  template <typename T>
+  static void destroy(void *p) {
+    static_cast<T *>(p)->~T();
+    ::operator delete(p);
+  }
+
+  tower *head;
+  std::atomic<std::int64_t> _size{0};
+  // find pins the domain as well, which is not a change to the list
+  mutable utils::epoch_domain epochs;
+
+  // a node gets one more level with probability 1/2
+  static int random_height() {
+    // xorshift64, seeded differently in every thread
+    thread_local std::uint64_t state =
+        0x9e3779b97f4a7c15ULL ^
+        reinterpret_cast<std::uintptr_t>(&state) * 0xbf58476d1ce4e5b9ULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    const int height = 1 + __builtin_ctzll(state | (1ULL << 63));
+    return height < max_height ? height : max_height;
+  }
+
+  // fills preds and succs with the nodes right before, and at or right after,
+  // key on every level. returns the highest level key was found on, or -1
+  int find_position(const K &key, tower **preds, node **succs) const {
+    int found = -1;
+    tower *pred = head;
+
+    for (int level = max_height - 1; level >= 0; level--) {
+      node *cur = pred->next[level].load(std::memory_order_acquire);
+      while (cur != nullptr and cur->key < key) {
+        pred = cur;
+        cur = pred->next[level].load(std::memory_order_acquire);
+      }
+
+      if (found == -1 and cur != nullptr and !(key < cur->key)) {
+        found = level;
+      }
+      preds[level] = pred;
+      succs[level] = cur;
+    }
+
+    return found;
+  }
+
+  // the same search as find_position, without remembering the path. a key is
+  // in the map from when its node is fully linked, until it is marked
+  const node *find_node(const K &key) const {
+    const tower *pred = head;
+    for (int level = max_height - 1; level >= 0; level--) {
+      const node *cur = pred->next[level].load(std::memory_order_acquire);
+      while (cur != nullptr and cur->key < key) {
+        pred = cur;
+        cur = pred->next[level].load(std::memory_order_acquire);
+      }
+
+      if (cur != nullptr and !(key < cur->key)) {
+        const bool present =
+            cur->fully_linked.load(std::memory_order_acquire) and
+            !cur->marked.load(std::memory_order_acquire);
+        return present ? cur : nullptr;
+      }
+    }
+
+    return nullptr;
+  }
+
+  // unlocks the distinct predecessors on levels [0, highest]
+  static void unlock_preds(tower **preds, int highest) {
+    tower *previous = nullptr;
+    for (int level = 0; level <= highest; level++) {
+      if (preds[level] != previous) {
+        preds[level]->unlock();
+        previous = preds[level];
+      }
+    }
+  }
+
+ public:
+  concurrent_skip_list() : head(make<tower>(max_height)) {}
+
+  concurrent_skip_list(const concurrent_skip_list &) = delete;
+  concurrent_skip_list &operator=(const concurrent_skip_list &) = delete;
+  concurrent_skip_list(concurrent_skip_list &&) = delete;
+  concurrent_skip_list &operator=(concurrent_skip_list &&) = delete;
+
+  // no other thread may use the list while it is destroyed
+  ~concurrent_skip_list() {
+    node *n = head->next[0].load(std::memory_order_relaxed);
+    while (n != nullptr) {
+      node *next = n->next[0].load(std::memory_order_relaxed);
+      destroy<node>(n);
+      n = next;
+    }
+    destroy<tower>(head);
+  }
+
+  bool insert(K key, V value);
+  bool remove(const K &key);
+  std::optional<V> find(const K &key) const;
+  bool contains(const K &key) const;
+
+  // the number of keys in the list, only exact when no other thread is
+  // changing the list
+  int size() const {
+    return static_cast<int>(_size.load(std::memory_order_relaxed));
+  }
+};
+
+// returns true if the key was inserted,
+// false if it was already in the list
+template <typename K, typename V>
+bool concurrent_skip_list<K, V>::insert(K key, V value) {
+  utils::epoch_domain::guard guard(epochs);
+  const int height = random_height();
+  tower *preds[max_height];
+  node *succs[max_height];
+
+  while (true) {
+    const int found = find_position(key, preds, succs);
+    if (found != -1) {
+      node *existing = succs[found];
+      if (!existing->marked.load(std::memory_order_acquire)) {
+        // the key is being inserted by another thread, wait until it is
+        // done, so the key is in the map when we return
+        while (!existing->fully_linked.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        return false;
+      }
+      // the key is being removed, try again once it is gone
+      continue;
+    }
+
+    // lock the predecessors from the bottom up, and check that nothing
+    // changed between them and their successors while we were not looking
+    int highest_locked = -1;
+    bool valid = true;
+    tower *previous = nullptr;
+    for (int level = 0; valid and level < height; level++) {
+      tower *pred = preds[level];
+      node *succ = succs[level];
+      if (pred != previous) {
+        pred->lock();
+        highest_locked = level;
+        previous = pred;
+      }
+      valid = !pred->marked.load(std::memory_order_acquire) and
+              (succ == nullptr or
+               !succ->marked.load(std::memory_order_acquire)) and
+              pred->next[level].load(std::memory_order_acquire) == succ;
+    }
+
+    if (!valid) {
+      unlock_preds(preds, highest_locked);
+      continue;
+    }
+
+    node *n = make<node>(height, std::move(key), std::move(value));
+    for (int level = 0; level < height; level++) {
+      n->next[level].store(succs[level], std::memory_order_relaxed);
+    }
+    for (int level = 0; level < height; level++) {
+      preds[level]->next[level].store(n, std::memory_order_release);
+    }
+    n->fully_linked.store(true, std::memory_order_release);
+
+    unlock_preds(preds, highest_locked);
+    _size.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+}
+
+// returns true if the key was removed,
+// false if key was not found in the list
+template <typename K, typename V>
+bool concurrent_skip_list<K, V>::remove(const K &key) {
+  utils::epoch_domain::guard guard(epochs);
+  tower *preds[max_height];
+  node *succs[max_height];
+  node *victim = nullptr;
+
+  while (true) {
+    const int found = find_position(key, preds, succs);
+
+    if (victim == nullptr) {
+      // only remove nodes that are fully linked, and found at their top
+      // level, anything else is still being inserted, or already removed
+      if (found == -1) {
+        return false;
+      }
+      node *n = succs[found];
+      if (!n->fully_linked.load(std::memory_order_acquire) or
+          n->height - 1 != found or n->marked.load(std::memory_order_acquire)) {
+        return false;
+      }
+
+      // marking the node is what removes the key, the rest is cleanup
+      n->lock();
+      if (n->marked.load(std::memory_order_relaxed)) {
+        n->unlock();
+        return false;
+      }
+      n->marked.store(true, std::memory_order_release);
+      victim = n;
+    }
+
+    int highest_locked = -1;
+    bool valid = true;
+    tower *previous = nullptr;
+    for (int level = 0; valid and level < victim->height; level++) {
+      tower *pred = preds[level];
+      if (pred != previous) {
+        pred->lock();
+        highest_locked = level;
+        previous = pred;
+      }
+      valid = !pred->marked.load(std::memory_order_acquire) and
+              pred->next[level].load(std::memory_order_acquire) == victim;
+    }
+
+    if (!valid) {
+      unlock_preds(preds, highest_locked);
+      continue;
+    }
+
+    for (int level = victim->height - 1; level >= 0; level--) {
+      preds[level]->next[level].store(
+          victim->next[level].load(std::memory_order_relaxed),
+          std::memory_order_release);
+    }
+
+    victim->unlock();
+    unlock_preds(preds, highest_locked);
+    guard.retire(victim, &destroy<node>);
+    _size.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+}
+
+template <typename K, typename V>
+std::optional<V> concurrent_skip_list<K, V>::find(const K &key) const {
+  utils::epoch_domain::guard guard(epochs);
+  const node *n = find_node(key);
+  return n != nullptr ? std::optional<V>(n->value) : std::nullopt;
+}
+
+template <typename K, typename V>
+bool concurrent_skip_list<K, V>::contains(const K &key) const {
+  utils::epoch_domain::guard guard(epochs);
+  return find_node(key) != nullptr;
+}
+
+}  // namespace dads::trees
+
+#endif
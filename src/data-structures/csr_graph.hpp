@@ -0,0 +1,303 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+/*
+  A compressed sparse row (CSR) graph store.
+  The edges of all nodes are kept in two contiguous arrays (the targets, and
+  the weights of the edges), sorted by the node they leave from, and an array
+  of offsets marks where the edges of each node begin.
+  The store is built once, from an edge list or from another graph, and is
+  immutable afterwards.
+  Memory:
+  - per edge: one target and one weight, 8 bytes
+  - per node: one offset, 8 bytes
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
+
+namespace dads::graphs {
+
+// walks the parallel target and weight arrays of a CSR store
+class csr_edge_iterator {
+ private:
+  const int *target{nullptr};
+  const int *weight{nullptr};
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = edge;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const edge *;
+  using reference = edge;
+
+  csr_edge_iterator() = default;
+  csr_edge_iterator(const int *target, const int *weight)
+      : target(target), weight(weight) {}
+
+  edge operator*() const { return {*target, *weight}; }
+  csr_edge_iterator &operator++() {
+    ++target;
+    ++weight;
+    return *this;
+  }
+  csr_edge_iterator operator++(int) {
+    csr_edge_iterator old = *this;
+    ++*this;
+    return old;
+  }
+  bool operator==(const csr_edge_iterator &o) const {
+    return target == o.target;
+  }
+  bool operator!=(const csr_edge_iterator &o) const {
+    return target != o.target;
+  }
+};
+
+class csr_graph : public node_store<csr_graph> {
+ private:
+  // the edges leaving node n are in [offsets[n], offsets[n + 1])
+  std::vector<std::size_t> offsets{0};
+  std::vector<int> targets;
+  std::vector<int> weights;
+
+ public:
+  csr_graph() = default;
+
+  // builds the store from (from, to, weight) records, nodes are identified by
+  // their index, so they should be in a dense range starting from 0. if the
+  // same edge appears more than once, the last weight wins, just like adding
+  // it to the other stores would
+  explicit csr_graph(std::vector<std::tuple<int, int, int>> edges) {
+    // every node, including the ones that only have edges going into them,
+    // gets an offset, so node_count() covers all ids in the graph
+    int max_node = -1;
+    for (const auto &[u, v, w] : edges) {
+      if (u < 0 or v < 0) {
+        throw std::invalid_argument("csr_graph nodes can not be negative");
+      }
+      max_node = std::max(max_node, std::max(u, v));
+    }
+
+    // sort by (from, to), the sort is stable, so duplicate edges keep the
+    // order they were added in
+    std::stable_sort(std::begin(edges), std::end(edges),
+                     [](const auto &a, const auto &b) {
+                       return std::tie(std::get<0>(a), std::get<1>(a)) <
+                              std::tie(std::get<0>(b), std::get<1>(b));
+                     });
+
+    offsets.assign(max_node + 2, 0);
+    targets.reserve(edges.size());
+    weights.reserve(edges.size());
+
+    for (std::size_t i = 0; i < edges.size(); i++) {
+      const auto &[u, v, w] = edges[i];
+
+      // only keep the last of a run of duplicate edges
+      if (i + 1 < edges.size() and std::get<0>(edges[i + 1]) == u and
+          std::get<1>(edges[i + 1]) == v) {
+        continue;
+      }
+
+      targets.push_back(v);
+      weights.push_back(w);
+      offsets[u + 1]++;
+    }
+
+    // turn the per-node edge counts into offsets
+    for (std::size_t n = 1; n < offsets.size(); n++) {
+      offsets[n] += offsets[n - 1];
+    }
+  }
+
+  // takes over arrays that are already laid out like the ones of the store,
+  // with the edges of every node sorted by the node they go to
+  csr_graph(std::vector<std::size_t> offsets, std::vector<int> targets,
+            std::vector<int> weights)
+      : offsets(std::move(offsets)),
+        targets(std::move(targets)),
+        weights(std::move(weights)) {}
+
+  // builds the store from the edges of another graph
+  template <typename T>
+  explicit csr_graph(const graph<T> &graph) : csr_graph(edges_of(graph)) {}
+
+  void add_edge(int /*u*/, int /*v*/, int /*w*/) {
+    throw std::logic_error("csr_graph is immutable");
+  }
+
+  // all nodes that have edges leaving them
+  std::vector<int> nodes() const {
+    std::vector<int> ns;
+
+    for (std::size_t n = 0; n + 1 < offsets.size(); n++) {
+      if (offsets[n] != offsets[n + 1]) {
+        ns.push_back(n);
+      }
+    }
+
+    return ns;
+  }
+
+  edge_range<csr_edge_iterator> edges(int n) const {
+    if (n < 0 or n + 1 >= static_cast<int>(offsets.size())) {
+      return {csr_edge_iterator(), csr_edge_iterator()};
+    }
+
+    return {csr_edge_iterator(targets.data() + offsets[n],
+                              weights.data() + offsets[n]),
+            csr_edge_iterator(targets.data() + offsets[n + 1],
+                              weights.data() + offsets[n + 1])};
+  }
+
+  std::vector<int> neighbours(int n) const {
+    if (n < 0 or n + 1 >= static_cast<int>(offsets.size())) {
+      return {};
+    }
+
+    return std::vector<int>(std::begin(targets) + offsets[n],
+                            std::begin(targets) + offsets[n + 1]);
+  }
+
+  // the edges of a node are sorted by their target, so we can binary search
+  // for it. returns 0 if there is no edge between u and v
+  int weight(int u, int v) const {
+    if (u < 0 or u + 1 >= static_cast<int>(offsets.size())) {
+      return 0;
+    }
+
+    const auto first = std::begin(targets) + offsets[u];
+    const auto last = std::begin(targets) + offsets[u + 1];
+    const auto it = std::lower_bound(first, last, v);
+    if (it == last or *it != v) {
+      return 0;
+    }
+
+    return weights[it - std::begin(targets)];
+  }
+
+  // the number of node ids the store has room for, i.e. the biggest node id
+  // in the graph, plus one
+  std::size_t node_count() const { return offsets.size() - 1; }
+  std::size_t edge_count() const { return targets.size(); }
+  int id_bound() const { return node_count(); }
+
+ private:
+  template <typename T>
+  static std::vector<std::tuple<int, int, int>> edges_of(
+      const graph<T> &graph) {
+    std::vector<std::tuple<int, int, int>> edges;
+
+    for (const int u : graph.nodes()) {
+      for (const auto [v, w] : graph.edges(u)) {
+        edges.emplace_back(u, v, w);
+      }
+    }
+
+    return edges;
+  }
+};
+
+// a CSR copy of a graph with every edge reversed, so the edges(n) of the copy
+// are the edges going into n. used by the searches that walk backwards, it
+// only has to be built once for any number of them.
+// the copy is built on the pool: the edges into every node are counted, and
+// then every edge takes the next free slot of the node it goes to, so the
+// edges are never gathered into a list first
+template <typename T>
+static std::unique_ptr<graph<csr_graph>> transpose(
+    const T &g, utils::thread_pool &pool = utils::default_thread_pool()) {
+  constexpr std::size_t grain = 256;
+  const std::vector<int> sources = g.nodes();
+
+  // calls f(worker, u, edge) for every edge of the graph, on the pool
+  const auto for_edges = [&](auto &&f) {
+    pool.parallel_chunks(
+        0, sources.size(), grain,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i < last; i++) {
+            const int u = sources[i];
+            for (const auto e : g.edges(u)) {
+              f(worker, u, e);
+            }
+          }
+        });
+  };
+
+  // one past the biggest node id, as seen by every worker
+  std::vector<int> bounds(pool.size(), 0);
+  for_edges([&bounds](std::size_t worker, int u, edge e) {
+    if (u < 0 or e.node < 0) {
+      throw std::invalid_argument("csr_graph nodes can not be negative");
+    }
+    bounds[worker] = std::max(bounds[worker], std::max(u, e.node) + 1);
+  });
+  const int n = *std::max_element(std::begin(bounds), std::end(bounds));
+
+  // first the number of edges into every node, then the next free slot
+  auto slots = std::make_unique<std::atomic<std::size_t>[]>(n);
+  pool.parallel_for(0, n, [&slots](std::size_t v) {
+    slots[v].store(0, std::memory_order_relaxed);
+  });
+  for_edges([&slots](std::size_t, int, edge e) {
+    slots[e.node].fetch_add(1, std::memory_order_relaxed);
+  });
+
+  std::vector<std::size_t> offsets(n + 1, 0);
+  for (int v = 0; v < n; v++) {
+    offsets[v + 1] = offsets[v] + slots[v].load(std::memory_order_relaxed);
+    slots[v].store(offsets[v], std::memory_order_relaxed);
+  }
+
+  std::vector<int> targets(offsets[n]);
+  std::vector<int> weights(offsets[n]);
+  for_edges([&](std::size_t, int u, edge e) {
+    const std::size_t at =
+        slots[e.node].fetch_add(1, std::memory_order_relaxed);
+    targets[at] = u;
+    weights[at] = e.weight;
+  });
+
+  // the slots were taken in no particular order, but the edges of a node
+  // are kept sorted
+  std::vector<std::vector<std::pair<int, int>>> scratch(pool.size());
+  pool.parallel_chunks(
+      0, n, grain,
+      [&](std::size_t worker, std::size_t first, std::size_t last) {
+        auto &es = scratch[worker];
+        for (std::size_t v = first; v < last; v++) {
+          const auto from = std::begin(targets) + offsets[v];
+          const auto to = std::begin(targets) + offsets[v + 1];
+          if (std::is_sorted(from, to)) {
+            continue;
+          }
+
+          es.clear();
+          for (std::size_t i = offsets[v]; i < offsets[v + 1]; i++) {
+            es.emplace_back(targets[i], weights[i]);
+          }
+          std::sort(std::begin(es), std::end(es));
+          for (std::size_t i = 0; i < es.size(); i++) {
+            targets[offsets[v] + i] = es[i].first;
+            weights[offsets[v] + i] = es[i].second;
+          }
+        }
+      });
+
+  return std::make_unique<graph<csr_graph>>(
+      csr_graph(std::move(offsets), std::move(targets), std::move(weights)));
+}
+
+}  // namespace dads::graphs
+
+#endif
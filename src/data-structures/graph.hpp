@@ -6,23 +6,168 @@
   representation for edges between nodes.
 */
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <utils/thread_pool.hpp>
+
 namespace dads::graphs {
 
+// an edge to a neighbouring node, and the weight of that edge
+struct edge {
+  int node;
+  int weight;
+};
+
+// a view over the edges leaving a node. it does not own or copy the edges, so
+// it is only valid until the graph is changed
+template <typename Iterator>
+class edge_range {
+ private:
+  Iterator _first;
+  Iterator _last;
+
+ public:
+  edge_range(Iterator first, Iterator last)
+      : _first(std::move(first)), _last(std::move(last)) {}
+
+  Iterator begin() const { return _first; }
+  Iterator end() const { return _last; }
+  bool empty() const { return _first == _last; }
+};
+
+/*
+  The base of all node stores.
+  A store derives from node_store<itself>, and provides:
+  - add_edge(u, v, weight)
+  - nodes() -> std::vector<int>
+  - edges(n) -> a range of edge
+  - weight(u, v) -> int
+  and optionally
+  - id_bound() -> int, one past the biggest node id, or -1 if the ids are not
+    dense enough to index arrays by
+  - add_edges(range, pool), adds a batch of (from, to, weight) records, the
+    same way adding them one at a time would, but faster. like add_edge, an
+    edge that is added again keeps the weight it was added with last, so
+    there are never duplicate edges
+  - reserve(nodes, edges), makes room for that many more nodes and edges
+  - has_edge(u, v) -> bool, tells a missing edge from one of weight 0, since
+    weight(u, v) returns 0 for both
+  - in_edges(n) -> a range of edge, the edges into a node, with the node they
+    come from
+  - keep_in_edges(), for stores that only index the edges into nodes when
+    asked to, makes in_edges available from then on
+  There are no virtual functions, graph<T> knows the concrete type of its
+  store, so every call resolves at compile time and can be inlined into the
+  traversals. Use any_node_store if the store has to be picked at runtime.
+*/
+template <typename Derived>
 class node_store {
  public:
-  virtual void add_edge(int u, int v, int w) = 0;
-  virtual std::vector<int> nodes() = 0;
-  virtual std::vector<int> neighbours(int n) = 0;
-  virtual int weight(int u, int v) = 0;
+  // the nodes a node has edges to, as a copy
+  std::vector<int> neighbours(int n) const {
+    std::vector<int> ns;
+
+    for (const auto e : self().edges(n)) {
+      ns.push_back(e.node);
+    }
+
+    return ns;
+  }
+
+ protected:
+  ~node_store() = default;
+
+ private:
+  const Derived &self() const { return static_cast<const Derived &>(*this); }
 };
 
-class adjacency_list : public node_store {
+// checks that a type fulfills the node store contract, at compile time
+template <typename T, typename = void>
+struct is_node_store : std::false_type {};
+
+template <typename T>
+struct is_node_store<
+    T, std::void_t<decltype(std::declval<T &>().add_edge(0, 0, 0)),
+                   decltype(std::declval<const T &>().nodes()),
+                   decltype(std::declval<const T &>().neighbours(0)),
+                   decltype(std::declval<const T &>().edges(0).begin()),
+                   decltype(std::declval<const T &>().weight(0, 0))>>
+    : std::true_type {};
+
+// checks if a node store, or graph, knows the range of its node ids
+template <typename T, typename = void>
+struct has_id_bound : std::false_type {};
+
+template <typename T>
+struct has_id_bound<
+    T, std::void_t<decltype(std::declval<const T &>().id_bound())>>
+    : std::true_type {};
+
+// checks if a node store, or graph, can add a range of edges in one go
+template <typename T, typename Range, typename = void>
+struct has_add_edges : std::false_type {};
+
+template <typename T, typename Range>
+struct has_add_edges<
+    T, Range,
+    std::void_t<decltype(std::declval<T &>().add_edges(
+        std::declval<const Range &>(), std::declval<utils::thread_pool &>()))>>
+    : std::true_type {};
+
+// checks if a range of edge records can be indexed, with size() and [i]
+template <typename Range, typename = void>
+struct is_indexed_range : std::false_type {};
+
+template <typename Range>
+struct is_indexed_range<
+    Range, std::void_t<decltype(std::declval<const Range &>().size()),
+                       decltype(std::declval<const Range &>()[0])>>
+    : std::true_type {};
+
+// checks if a range of edge records is made of indexed chunks, like the
+// chunked_edges of a parsed csv text
+template <typename Range, typename = void>
+struct has_chunks : std::false_type {};
+
+template <typename Range>
+struct has_chunks<
+    Range, std::void_t<decltype(std::declval<const Range &>().chunks())>>
+    : std::true_type {};
+
+// checks if a node store, or graph, can list the edges into a node
+template <typename T, typename = void>
+struct has_in_edges : std::false_type {};
+
+template <typename T>
+struct has_in_edges<
+    T, std::void_t<decltype(std::declval<const T &>().in_edges(0))>>
+    : std::true_type {};
+
+// checks if a node store can make room for nodes and edges up front
+template <typename T, typename = void>
+struct has_reserve : std::false_type {};
+
+template <typename T>
+struct has_reserve<
+    T, std::void_t<decltype(std::declval<T &>().reserve(0, 0))>>
+    : std::true_type {};
+
+class adjacency_list : public node_store<adjacency_list> {
   /*
     In an adjacency list, each node keeps a list of it's edges to other nodes
     that their costs.
@@ -30,86 +175,668 @@ class adjacency_list : public node_store {
     a lot of space for big graphs.
     But if we have a graph where most nodes have edges to most other nodes, we
     end up with a lot of double-record-keeping.
+    The edges into the nodes are only indexed once keep_in_edges is called,
+    and kept up to date from then on, so graphs that never look at them do
+    not pay for keeping them.
    */
  private:
-  std::unordered_map<int, std::unordered_map<int, int>> list;
+  using edge_map = std::unordered_map<int, std::unordered_map<int, int>>;
+
+  // the edges leaving every node, and the weights of them
+  edge_map list;
+
+  // the edges into every node, by the node they come from, if kept
+  edge_map in_list;
+  bool keeps_in_edges{false};
+
+  // the range of node ids seen so far, so we know if they are dense
+  int min_id{0};
+  int max_id{-1};
+
+  // the number of edges to make room for in the edge map of a new node
+  std::size_t degree_hint{0};
 
  public:
-  void add_edge(int u, int v, int weight) override { list[u][v] = weight; }
+  // walks the (node, weight) pairs of a node, without copying them
+  class edge_iterator {
+   private:
+    std::unordered_map<int, int>::const_iterator it;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = edge;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const edge *;
+    using reference = edge;
+
+    edge_iterator() = default;
+    explicit edge_iterator(std::unordered_map<int, int>::const_iterator it)
+        : it(it) {}
+
+    edge operator*() const { return {it->first, it->second}; }
+    edge_iterator &operator++() {
+      ++it;
+      return *this;
+    }
+    edge_iterator operator++(int) {
+      edge_iterator old = *this;
+      ++it;
+      return old;
+    }
+    bool operator==(const edge_iterator &o) const { return it == o.it; }
+    bool operator!=(const edge_iterator &o) const { return it != o.it; }
+  };
+
+  void add_edge(int u, int v, int weight) {
+    auto [it, added] = list.try_emplace(u);
+    if (added and degree_hint > 0) {
+      it->second.reserve(degree_hint);
+    }
+    it->second[v] = weight;
+    if (keeps_in_edges) {
+      in_list[v][u] = weight;
+    }
+    min_id = std::min(min_id, std::min(u, v));
+    max_id = std::max(max_id, std::max(u, v));
+  }
+
+  // makes room for this many more nodes, and has the edge maps of the nodes
+  // added from here on start out big enough for their share of the edges
+  void reserve(std::size_t nodes, std::size_t edges) {
+    list.reserve(list.size() + nodes);
+    if (nodes > 0) {
+      degree_hint = (edges + nodes - 1) / nodes;
+    }
+  }
+
+  // adds a batch of (from, to, weight) records, like adding them one at a
+  // time: an edge is only kept once, with the weight of its last record.
+  // batches that can be indexed, or are made of indexed chunks, are added in
+  // parallel. first the batch is cut into pieces, and every piece is read
+  // once, sorting the positions of its records into a bucket per shard, by
+  // the node they leave from. a shard is the nodes whose id is a worker
+  // modulo the number of workers. then every worker builds the edge maps of
+  // its shard from its buckets, in the order of the batch. the maps are moved
+  // into the list, and the ones of nodes that already had edges are merged
+  // into them, again a shard per worker. the edges into nodes, if kept, are
+  // bucketed in the same pass, by the node they go to, and added the same way.
+  // other ranges are added one record at a time
+  template <typename Range>
+  void add_edges(const Range &edges,
+                 utils::thread_pool &pool = utils::default_thread_pool()) {
+    if constexpr (is_indexed_range<Range>::value or has_chunks<Range>::value) {
+      if (pool.size() > 1) {
+        add_sharded(pieces_of(edges, pool.size()), pool);
+        return;
+      }
+    }
 
-  std::vector<int> nodes() override {
+    for (const auto &e : edges) {
+      add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+    }
+  }
+
+ private:
+  // the records [first, first + size) of an indexed range of records
+  template <typename Records>
+  struct piece {
+    const Records *records;
+    std::size_t first;
+    std::size_t size;
+  };
+
+  // cuts a batch into at least count pieces, or into its chunks, small
+  // enough that a position in a piece fits in 32 bits
+  template <typename Range>
+  static auto pieces_of(const Range &edges, std::size_t count) {
+    if constexpr (has_chunks<Range>::value) {
+      using chunk = std::decay_t<decltype(edges.chunks()[0])>;
+      std::vector<piece<chunk>> pieces;
+      for (const auto &c : edges.chunks()) {
+        pieces.push_back({&c, 0, c.size()});
+      }
+      return pieces;
+    } else {
+      constexpr std::size_t max_piece = std::size_t{1} << 31;
+      const std::size_t size = edges.size();
+      const std::size_t n = std::max(count, size / max_piece + 1);
+      std::vector<piece<Range>> pieces;
+      for (std::size_t k = 0; k < n; k++) {
+        const std::size_t first = k * size / n;
+        pieces.push_back({&edges, first, (k + 1) * size / n - first});
+      }
+      return pieces;
+    }
+  }
+
+  // the positions of the records of every piece, with a bucket per shard
+  using buckets = std::vector<std::vector<std::vector<std::uint32_t>>>;
+
+  template <typename Pieces>
+  void add_sharded(const Pieces &pieces, utils::thread_pool &pool) {
+    const std::size_t shards = pool.size();
+    const bool both = keeps_in_edges;
+
+    buckets by_source(pieces.size(),
+                      std::vector<std::vector<std::uint32_t>>(shards));
+    buckets by_target(both ? pieces.size() : 0,
+                      std::vector<std::vector<std::uint32_t>>(shards));
+    pool.parallel_for(
+        0, pieces.size(),
+        [&](std::size_t k) {
+          const auto &p = pieces[k];
+          for (std::uint32_t i = 0; i < p.size; i++) {
+            const auto &e = (*p.records)[p.first + i];
+            by_source[k][static_cast<unsigned>(std::get<0>(e)) % shards]
+                .push_back(i);
+            if (both) {
+              by_target[k][static_cast<unsigned>(std::get<1>(e)) % shards]
+                  .push_back(i);
+            }
+          }
+        },
+        1);
+
+    add_bucketed(list, pieces, by_source, pool, false);
+    if (both) {
+      add_bucketed(in_list, pieces, by_target, pool, true);
+    }
+  }
+
+  // adds the bucketed records to the edge maps of an index, keyed by the
+  // node the edges leave from, or by the node they go to if reversed
+  template <typename Pieces>
+  void add_bucketed(edge_map &index, const Pieces &pieces,
+                    const buckets &bucketed, utils::thread_pool &pool,
+                    bool reversed) {
+    struct shard {
+      edge_map index;
+      // (edges of the node in the index, new edges of the node)
+      std::vector<std::pair<std::unordered_map<int, int> *,
+                            std::unordered_map<int, int> *>>
+          merges;
+      int min_id{0};
+      int max_id{-1};
+    };
+    std::vector<shard> parts(pool.size());
+
+    pool.run([&](std::size_t worker) {
+      auto &part = parts[worker];
+      auto last = part.index.end();
+      for (std::size_t k = 0; k < pieces.size(); k++) {
+        const auto &p = pieces[k];
+        for (const std::uint32_t i : bucketed[k][worker]) {
+          const auto &e = (*p.records)[p.first + i];
+          const int u = reversed ? std::get<1>(e) : std::get<0>(e);
+          const int v = reversed ? std::get<0>(e) : std::get<1>(e);
+          if (last == part.index.end() or last->first != u) {
+            bool added;
+            std::tie(last, added) = part.index.try_emplace(u);
+            if (added and degree_hint > 0) {
+              last->second.reserve(degree_hint);
+            }
+          }
+          last->second[v] = std::get<2>(e);
+          part.min_id = std::min(part.min_id, std::min(u, v));
+          part.max_id = std::max(part.max_id, std::max(u, v));
+        }
+      }
+    });
+
+    std::size_t keys = 0;
+    for (const auto &part : parts) {
+      keys += part.index.size();
+    }
+    index.reserve(index.size() + keys);
+    for (auto &part : parts) {
+      for (auto &[u, es] : part.index) {
+        auto [it, added] = index.try_emplace(u);
+        if (added) {
+          it->second = std::move(es);
+        } else {
+          part.merges.emplace_back(&it->second, &es);
+        }
+      }
+      min_id = std::min(min_id, part.min_id);
+      max_id = std::max(max_id, part.max_id);
+    }
+
+    // the outer map does not change from here on, and every node is only
+    // merged by its own shard
+    pool.run([&](std::size_t worker) {
+      for (auto &[old_edges, new_edges] : parts[worker].merges) {
+        for (const auto &[v, w] : *new_edges) {
+          (*old_edges)[v] = w;
+        }
+      }
+    });
+  }
+
+ public:
+  // indexes the edges into every node, and keeps the index up to date as
+  // edges are added, so in_edges can be used. this is a write like
+  // add_edge, once it has been called the graph can be read from many
+  // threads again
+  void keep_in_edges() {
+    if (keeps_in_edges) {
+      return;
+    }
+    for (const auto &[u, es] : list) {
+      for (const auto &[v, w] : es) {
+        in_list[v][u] = w;
+      }
+    }
+    keeps_in_edges = true;
+  }
+
+  // the ids count as dense if none are negative, and an array indexed by id
+  // would not be much bigger than the number of nodes
+  int id_bound() const {
+    const std::size_t bound = max_id + 1;
+    if (min_id < 0 or bound > 8 * list.size() + 64) {
+      return -1;
+    }
+    return bound;
+  }
+
+  edge_range<edge_iterator> edges(int n) const {
+    auto it = list.find(n);
+    if (it == list.end()) {
+      return {edge_iterator(), edge_iterator()};
+    }
+
+    const auto &es = it->second;
+    return {edge_iterator(es.begin()), edge_iterator(es.end())};
+  }
+
+  // the edges into a node, each with the node it comes from. only works
+  // once keep_in_edges has been called, and throws std::logic_error before
+  edge_range<edge_iterator> in_edges(int n) const {
+    if (!keeps_in_edges) {
+      throw std::logic_error("the in-edges are not kept, call keep_in_edges");
+    }
+
+    auto it = in_list.find(n);
+    if (it == in_list.end()) {
+      return {edge_iterator(), edge_iterator()};
+    }
+
+    const auto &es = it->second;
+    return {edge_iterator(es.begin()), edge_iterator(es.end())};
+  }
+
+  std::vector<int> nodes() const {
     std::vector<int> ns;
 
     // nodes are saved as (node, edges[]) pairs, grab all nodes
-    for (auto pair : list) {
+    for (const auto &pair : list) {
       ns.push_back(std::get<0>(pair));
     }
 
     return ns;
   }
 
-  std::vector<int> neighbours(int n) override {
-    std::vector<int> ns;
-    // the neighbours of a node are stores a list of (node, weight) pairs, grab
-    // all neighbours
-    for (auto pair : list[n]) {
-      ns.push_back(std::get<0>(pair));
+  // returns 0 if there is no edge between u and v
+  int weight(int u, int v) const {
+    auto it = list.find(u);
+    if (it == list.end()) {
+      return 0;
     }
 
-    return ns;
+    auto e = it->second.find(v);
+    return e != it->second.end() ? e->second : 0;
   }
 
-  int weight(int u, int v) override { return list[u][v]; }
+  bool has_edge(int u, int v) const {
+    auto it = list.find(u);
+    return it != list.end() and it->second.count(v) > 0;
+  }
 };
 
 template <const std::size_t N>
-class adjacency_matrix : public node_store {
+class adjacency_matrix : public node_store<adjacency_matrix<N>> {
   /*
     An adjacency matrix stores all nodes and their edges as a 2d-matrix, where
     graph[A][B] indicates the weight of the edge from A to B.
+    The weights are kept in one flat N * N array, and whether an edge exists
+    in a bitmap next to it, a bit per entry, so every weight, negative ones
+    included, can be stored. Walking the edges of a node scans the 64-bit
+    words of its row of the bitmap, skipping empty words four at a time with
+    AVX2 when it is available, and another bitmap keeps track of which nodes
+    have edges, so nodes() does not have to look at the whole matrix.
+    The bitmap is also kept transposed, a row per node with a bit for every
+    edge into it, so the edges into a node are found the same way.
+    Since every weight is a real weight, weight(u, v) returns 0 for a missing
+    edge, like the other stores, and not -1 like it used to. Use has_edge to
+    tell a missing edge from an edge of weight 0.
+    AVX2 is only used if the compiler targets it, e.g. with -march=native,
+    which the DADS_NATIVE cmake option turns on.
    */
  private:
-  std::vector<std::vector<int>> matrix;
+  static constexpr std::size_t word_bits = 64;
+  static constexpr std::size_t row_words = (N + word_bits - 1) / word_bits;
+
+  // the weight of the edge from u to v is at u * N + v
+  std::vector<int> weights;
+  // bit v of row u is set if there is an edge from u to v
+  std::vector<std::uint64_t> present;
+  // bit u of row v is set if there is an edge from u to v
+  std::vector<std::uint64_t> present_in;
+  // bit u is set if there are edges leaving u
+  std::vector<std::uint64_t> sources;
+
+  // the first word at or after w that has a bit set, or row_words
+  static std::size_t next_word(const std::uint64_t *bits, std::size_t w) {
+#ifdef __AVX2__
+    for (; w + 4 <= row_words; w += 4) {
+      const __m256i block =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bits + w));
+      if (!_mm256_testz_si256(block, block)) {
+        break;
+      }
+    }
+#endif
+    while (w < row_words and bits[w] == 0) {
+      w++;
+    }
+    return w;
+  }
 
  public:
-  adjacency_matrix() : matrix(N, std::vector<int>(N, -1)) {}
+  // walks the set bits of a row of a bitmap, a word at a time. the weight
+  // of bit i is at weights[i * stride], which walks a row of the weights
+  // with a stride of 1, and a column with a stride of N
+  class edge_iterator {
+   private:
+    const std::uint64_t *bits{nullptr};
+    const int *weights{nullptr};
+    std::size_t stride{1};
+    std::size_t w{0};
+    // the bits of word w that have not been visited yet
+    std::uint64_t rest{0};
+    std::size_t i{N};
+
+    void advance() {
+      while (rest == 0) {
+        w = next_word(bits, w + 1);
+        if (w >= row_words) {
+          i = N;
+          return;
+        }
+        rest = bits[w];
+      }
+      i = w * word_bits + __builtin_ctzll(rest);
+      // clear the lowest set bit
+      rest &= rest - 1;
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = edge;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const edge *;
+    using reference = edge;
+
+    edge_iterator() = default;
+    edge_iterator(const std::uint64_t *bits, const int *weights,
+                  std::size_t stride)
+        : bits(bits), weights(weights), stride(stride) {
+      if (row_words > 0) {
+        rest = bits[0];
+        advance();
+      }
+    }
+
+    edge operator*() const {
+      return {static_cast<int>(i), weights[i * stride]};
+    }
+    edge_iterator &operator++() {
+      advance();
+      return *this;
+    }
+    edge_iterator operator++(int) {
+      edge_iterator old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const edge_iterator &o) const { return i == o.i; }
+    bool operator!=(const edge_iterator &o) const { return i != o.i; }
+  };
+
+  adjacency_matrix()
+      : weights(N * N, 0),
+        present(N * row_words, 0),
+        present_in(N * row_words, 0),
+        sources(row_words, 0) {}
+
+  void add_edge(int u, int v, int weight) {
+    weights[u * N + v] = weight;
+    present[u * row_words + v / word_bits] |= std::uint64_t{1}
+                                              << (v % word_bits);
+    present_in[v * row_words + u / word_bits] |= std::uint64_t{1}
+                                                 << (u % word_bits);
+    sources[u / word_bits] |= std::uint64_t{1} << (u % word_bits);
+  }
+
+  int id_bound() const { return N; }
+
+  edge_range<edge_iterator> edges(int n) const {
+    return {edge_iterator(present.data() + n * row_words,
+                          weights.data() + n * N, 1),
+            edge_iterator()};
+  }
 
-  void add_edge(int u, int v, int weight) override { matrix[u][v] = weight; }
+  // the edges into a node, each with the node it comes from
+  edge_range<edge_iterator> in_edges(int n) const {
+    return {edge_iterator(present_in.data() + n * row_words,
+                          weights.data() + n, N),
+            edge_iterator()};
+  }
 
-  std::vector<int> nodes() override {
+  // the size of the row is known from its bits, so the copy is only
+  // allocated once
+  std::vector<int> neighbours(int n) const {
     std::vector<int> ns;
+    ns.reserve(degree(n));
+    for (const auto e : edges(n)) {
+      ns.push_back(e.node);
+    }
+    return ns;
+  }
 
-    for (std::size_t i = 0; i < N; i++) {
-      for (std::size_t j = 0; j < N; j++) {
-        // TODO: handle negative weight edges
-        if (matrix[i][j] > -1) {
-          ns.push_back(i);
-          break;
-        }
+  // the number of edges leaving a node
+  std::size_t degree(int n) const {
+    std::size_t d = 0;
+    for (std::size_t w = 0; w < row_words; w++) {
+      d += __builtin_popcountll(present[n * row_words + w]);
+    }
+    return d;
+  }
+
+  // all nodes that have edges leaving them, in increasing order
+  std::vector<int> nodes() const {
+    std::vector<int> ns;
+
+    for (std::size_t w = 0; w < row_words; w++) {
+      std::uint64_t bits = sources[w];
+      while (bits != 0) {
+        ns.push_back(w * word_bits + __builtin_ctzll(bits));
+        bits &= bits - 1;
       }
     }
 
     return ns;
   }
 
-  std::vector<int> neighbours(int n) override {
-    std::vector<int> ns;
+  // returns 0 if there is no edge between u and v, like the other stores
+  int weight(int u, int v) const { return weights[u * N + v]; }
+
+  bool has_edge(int u, int v) const {
+    return (present[u * row_words + v / word_bits] >> (v % word_bits)) & 1;
+  }
+};
 
-    for (std::size_t i = 0; i < N; i++) {
-      // TODO: handle negative weight edges
-      if (matrix[n][i] > -1) {
-        ns.push_back(i);
+/*
+  A type-erased node store, for when the store of a graph has to be picked at
+  runtime. Every call goes through a virtual function, and edges(n) returns a
+  copy of the edges, so prefer using the concrete store when possible.
+*/
+class any_node_store {
+ private:
+  struct store_base {
+    virtual ~store_base() = default;
+    virtual void add_edge(int u, int v, int w) = 0;
+    virtual void add_edges(const std::vector<std::tuple<int, int, int>> &edges,
+                           utils::thread_pool &pool) = 0;
+    virtual void reserve(std::size_t nodes, std::size_t edges) = 0;
+    virtual std::vector<int> nodes() const = 0;
+    virtual std::vector<int> neighbours(int n) const = 0;
+    virtual std::vector<edge> edges(int n) const = 0;
+    virtual int weight(int u, int v) const = 0;
+    virtual int id_bound() const = 0;
+  };
+
+  template <typename T>
+  struct store_model final : store_base {
+    T store;
+
+    explicit store_model(T &&store) : store(std::move(store)) {}
+
+    void add_edge(int u, int v, int w) override { store.add_edge(u, v, w); }
+    void add_edges(const std::vector<std::tuple<int, int, int>> &edges,
+                   utils::thread_pool &pool) override {
+      if constexpr (has_add_edges<T, std::vector<std::tuple<int, int, int>>>::
+                        value) {
+        store.add_edges(edges, pool);
+      } else {
+        for (const auto &[u, v, w] : edges) {
+          store.add_edge(u, v, w);
+        }
       }
     }
+    void reserve(std::size_t nodes, std::size_t edges) override {
+      if constexpr (has_reserve<T>::value) {
+        store.reserve(nodes, edges);
+      }
+    }
+    std::vector<int> nodes() const override { return store.nodes(); }
+    std::vector<int> neighbours(int n) const override {
+      return store.neighbours(n);
+    }
+    std::vector<edge> edges(int n) const override {
+      std::vector<edge> es;
+      for (const auto e : store.edges(n)) {
+        es.push_back(e);
+      }
+      return es;
+    }
+    int weight(int u, int v) const override { return store.weight(u, v); }
+    int id_bound() const override {
+      if constexpr (has_id_bound<T>::value) {
+        return store.id_bound();
+      } else {
+        return -1;
+      }
+    }
+  };
 
-    return ns;
+  std::unique_ptr<store_base> _store;
+
+ public:
+  template <typename T>
+  explicit any_node_store(T store)
+      : _store(std::make_unique<store_model<T>>(std::move(store))) {}
+
+  void add_edge(int u, int v, int w) { _store->add_edge(u, v, w); }
+  // one virtual call for the whole batch
+  void add_edges(const std::vector<std::tuple<int, int, int>> &edges,
+                 utils::thread_pool &pool = utils::default_thread_pool()) {
+    _store->add_edges(edges, pool);
+  }
+  void reserve(std::size_t nodes, std::size_t edges) {
+    _store->reserve(nodes, edges);
   }
+  std::vector<int> nodes() const { return _store->nodes(); }
+  std::vector<int> neighbours(int n) const { return _store->neighbours(n); }
+  std::vector<edge> edges(int n) const { return _store->edges(n); }
+  int weight(int u, int v) const { return _store->weight(u, v); }
+  int id_bound() const { return _store->id_bound(); }
+};
 
-  int weight(int u, int v) override { return matrix[u][v]; }
+// the records of a range, each followed by its reverse edge, without copying
+// them. it can be indexed if the records can, so add_edges can shard it
+template <typename Range>
+class mirrored_edges {
+ private:
+  using record = std::tuple<int, int, int>;
+  using base = decltype(std::begin(std::declval<const Range &>()));
+
+  const Range &edges;
+
+  template <typename E>
+  static record mirror(const E &e, bool reversed) {
+    if (reversed) {
+      return {std::get<1>(e), std::get<0>(e), std::get<2>(e)};
+    }
+    return {std::get<0>(e), std::get<1>(e), std::get<2>(e)};
+  }
+
+ public:
+  class iterator {
+   private:
+    base it;
+    bool reversed{false};
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = record;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = record;
+
+    iterator() = default;
+    iterator(base it, bool reversed) : it(std::move(it)), reversed(reversed) {}
+
+    record operator*() const { return mirror(*it, reversed); }
+    iterator &operator++() {
+      if (reversed) {
+        ++it;
+      }
+      reversed = !reversed;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const iterator &o) const {
+      return it == o.it and reversed == o.reversed;
+    }
+    bool operator!=(const iterator &o) const { return !(*this == o); }
+  };
+
+  explicit mirrored_edges(const Range &edges) : edges(edges) {}
+
+  iterator begin() const { return {std::begin(edges), false}; }
+  iterator end() const { return {std::end(edges), false}; }
+
+  template <typename R = Range>
+  auto size() const -> decltype(std::declval<const R &>().size()) {
+    return 2 * edges.size();
+  }
+  template <typename R = Range>
+  auto operator[](std::size_t i) const
+      -> decltype(std::declval<const R &>()[i], record()) {
+    return mirror(edges[i / 2], i % 2 == 1);
+  }
 };
 
 template <typename T>
 class graph {
+  static_assert(is_node_store<T>::value,
+                "graph<T> needs T to implement the node store interface");
+
  private:
   std::unique_ptr<T> _nodes;
 
@@ -120,12 +847,60 @@ class graph {
 
  public:
   graph() : _nodes(std::move(std::make_unique<T>())){};
+  // take over an already built node store, used for stores that can not
+  // have edges added one at a time
+  explicit graph(T &&nodes) : _nodes(std::make_unique<T>(std::move(nodes))){};
 
   void add_edge(int u, int v, int weight);
   void add_bi_edge(int u, int v, int weight);
-  std::vector<int> nodes();
-  std::vector<int> neighbours(int n);
-  int weight(int u, int v);
+
+  // adds a range of (from, to, weight) records, in one go if the store
+  // supports it, and one at a time otherwise. either way, an edge that is in
+  // the range more than once gets the weight of its last record
+  template <typename Range>
+  void add_edges(const Range &edges,
+                 utils::thread_pool &pool = utils::default_thread_pool());
+  // adds the records, and their reverse edges
+  template <typename Range>
+  void add_bi_edges(const Range &edges,
+                    utils::thread_pool &pool = utils::default_thread_pool());
+  // makes room for more nodes and edges, if the store can
+  void reserve(std::size_t nodes, std::size_t edges);
+
+  std::vector<int> nodes() const;
+  std::vector<int> neighbours(int n) const;
+  auto edges(int n) const;
+  int weight(int u, int v) const;
+
+  // the edges into a node, each with the node it comes from. only
+  // available if the store supports it
+  template <typename U = T>
+  auto in_edges(int n) const
+      -> decltype(std::declval<const U &>().in_edges(n)) {
+    return _nodes->in_edges(n);
+  }
+
+  // has the store index the edges into nodes, for stores that only do so
+  // when asked to
+  template <typename U = T>
+  auto keep_in_edges() -> decltype(std::declval<U &>().keep_in_edges()) {
+    return _nodes->keep_in_edges();
+  }
+
+  // true if there is an edge from u to v, also if its weight is 0. only
+  // available if the store supports it
+  template <typename U = T>
+  auto has_edge(int u, int v) const
+      -> decltype(std::declval<const U &>().has_edge(u, v)) {
+    return _nodes->has_edge(u, v);
+  }
+
+  // one past the biggest node id, or -1 if the ids are not dense. only
+  // available if the store supports it
+  template <typename U = T>
+  auto id_bound() const -> decltype(std::declval<const U &>().id_bound()) {
+    return _nodes->id_bound();
+  }
 };
 
 template <typename T>
@@ -140,20 +915,68 @@ void graph<T>::add_bi_edge(int u, int v, int weight) {
 }
 
 template <typename T>
-std::vector<int> graph<T>::nodes() {
+template <typename Range>
+void graph<T>::add_edges(const Range &edges, utils::thread_pool &pool) {
+  if constexpr (has_add_edges<T, Range>::value) {
+    _nodes->add_edges(edges, pool);
+  } else {
+    for (const auto &e : edges) {
+      _nodes->add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+    }
+  }
+}
+
+// the reverse edges go right after their edges, so if an edge and its reverse
+// are both in the range, the last one added wins, as with add_bi_edge
+template <typename T>
+template <typename Range>
+void graph<T>::add_bi_edges(const Range &edges, utils::thread_pool &pool) {
+  add_edges(mirrored_edges<Range>(edges), pool);
+}
+
+template <typename T>
+void graph<T>::reserve(std::size_t nodes, std::size_t edges) {
+  if constexpr (has_reserve<T>::value) {
+    _nodes->reserve(nodes, edges);
+  }
+}
+
+template <typename T>
+std::vector<int> graph<T>::nodes() const {
   return _nodes->nodes();
 }
 
 template <typename T>
-std::vector<int> graph<T>::neighbours(int n) {
+std::vector<int> graph<T>::neighbours(int n) const {
   return _nodes->neighbours(n);
 }
 
+// the (node, weight) pairs of the edges leaving a node, as a view into the
+// node store, iterating it does not allocate
+template <typename T>
+auto graph<T>::edges(int n) const {
+  return _nodes->edges(n);
+}
+
 template <typename T>
-int graph<T>::weight(int u, int v) {
+int graph<T>::weight(int u, int v) const {
   return _nodes->weight(u, v);
 }
 
+// a graph with every edge turned around, as a view over a graph or store that
+// keeps its in-edges: the edges(n) of the view are the in_edges(n) of the
+// graph. for searches that walk backwards, like a reversed copy would
+template <typename T>
+class in_edges_view {
+ private:
+  const T &graph;
+
+ public:
+  explicit in_edges_view(const T &graph) : graph(graph) {}
+
+  auto edges(int n) const { return graph.in_edges(n); }
+};
+
 }  // namespace dads::graphs
 
 #endif
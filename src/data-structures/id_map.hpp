@@ -0,0 +1,74 @@
+#ifndef ID_MAP_HPP
+#define ID_MAP_HPP
+/*
+  Maps arbitrary node ids to a dense range [0, n), and back.
+  Graphs with sparse (or negative) node ids can be remapped with remap_ids,
+  which gives an equivalent CSR graph over dense ids. The traversals can then
+  keep their state in flat arrays instead of hash maps.
+*/
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+
+namespace dads::graphs {
+
+class id_map {
+ private:
+  std::unordered_map<int, int> dense;
+  std::vector<int> original;
+
+ public:
+  // the dense id of a node, the node gets the next free id if it has none
+  int insert(int id) {
+    auto [it, inserted] = dense.try_emplace(id, original.size());
+    if (inserted) {
+      original.push_back(id);
+    }
+    return it->second;
+  }
+
+  // the dense id of a node, or -1 if the node is not mapped
+  int to_dense(int id) const {
+    auto it = dense.find(id);
+    return it != dense.end() ? it->second : -1;
+  }
+
+  int to_original(int id) const { return original[id]; }
+
+  // the number of mapped nodes, dense ids are in [0, size())
+  std::size_t size() const { return original.size(); }
+};
+
+// a copy of a graph, with dense ids, and the map between the two sets of ids
+struct remapped_graph {
+  std::unique_ptr<graph<csr_graph>> dense;
+  id_map ids;
+};
+
+// dense ids are handed out in the order the nodes are found, so the ids of a
+// graph that is already dense are not necessarily kept
+template <typename T>
+static remapped_graph remap_ids(const T& g) {
+  remapped_graph r;
+  std::vector<std::tuple<int, int, int>> edges;
+
+  for (const int u : g.nodes()) {
+    const int du = r.ids.insert(u);
+    for (const auto [v, w] : g.edges(u)) {
+      edges.emplace_back(du, r.ids.insert(v), w);
+    }
+  }
+
+  r.dense = std::make_unique<graph<csr_graph>>(csr_graph(std::move(edges)));
+  return r;
+}
+
+}  // namespace dads::graphs
+
+#endif
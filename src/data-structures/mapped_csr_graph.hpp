@@ -0,0 +1,337 @@
+#ifndef MAPPED_CSR_GRAPH_HPP
+#define MAPPED_CSR_GRAPH_HPP
+/*
+  A CSR graph store that lives in a file.
+  write_csr_file saves any graph in a binary CSR format, and mapped_csr_graph
+  maps such a file into memory, and uses the arrays in it as they are, so
+  opening a graph does not parse, copy, or even read its edges. The pages of
+  the file are loaded by the OS when the graph first touches them, and are
+  shared by every process that maps the same file.
+  The file is a header, followed by the arrays of a csr_graph, each starting
+  at a multiple of 64 bytes:
+  - offsets: node_count + 1 unsigned 64-bit integers
+  - targets: edge_count signed 32-bit integers
+  - weights: edge_count signed 32-bit integers
+  The numbers are stored in the byte order of the machine that wrote the file,
+  which the header records, so a file from a machine with the other byte order
+  is refused instead of misread.
+  Time Complexity:
+  - open:   O(1), the header is checked, the arrays are not
+  - write:  O(E log d), d being the biggest out-degree, the edges of every
+            node are sorted by target
+  - edges:  O(1)
+  - weight: O(log d)
+  Only the header is checked when a file is opened. A file that was changed
+  after it was written can hand out node ids that are out of range.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+
+namespace dads::graphs {
+
+constexpr char csr_file_magic[8] = {'D', 'A', 'D', 'S', 'C', 'S', 'R', '\0'};
+// bumped whenever the layout of the file changes
+constexpr std::uint32_t csr_file_version = 1;
+// reads back as 0x04030201 on a machine with the other byte order
+constexpr std::uint32_t csr_file_byte_order = 0x01020304;
+
+struct csr_file_header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t node_count;
+  std::uint64_t edge_count;
+  // where the arrays start, in bytes from the start of the file
+  std::uint64_t offsets_at;
+  std::uint64_t targets_at;
+  std::uint64_t weights_at;
+};
+
+// saves a graph, or a node store, in the CSR file format. the nodes are
+// identified by their index, like in a csr_graph, so they can not be negative.
+// the edges are walked once for the targets, and once more for the weights,
+// so the graph is never copied
+template <typename G>
+static void write_csr_file(const G &graph, const std::string &path) {
+  auto nodes = graph.nodes();
+  std::sort(std::begin(nodes), std::end(nodes));
+
+  // every node id that appears, even only as a target, gets an offset
+  std::int64_t max_node = -1;
+  std::vector<std::uint64_t> degrees;
+  for (const int u : nodes) {
+    if (u < 0) {
+      throw std::invalid_argument("csr files can not have negative nodes");
+    }
+    max_node = std::max<std::int64_t>(max_node, u);
+    if (degrees.size() <= static_cast<std::size_t>(u)) {
+      degrees.resize(u + 1, 0);
+    }
+    for (const auto e : graph.edges(u)) {
+      if (e.node < 0) {
+        throw std::invalid_argument("csr files can not have negative nodes");
+      }
+      max_node = std::max<std::int64_t>(max_node, e.node);
+      degrees[u]++;
+    }
+  }
+
+  csr_file_header header{};
+  std::memcpy(header.magic, csr_file_magic, sizeof(header.magic));
+  header.version = csr_file_version;
+  header.byte_order = csr_file_byte_order;
+  header.node_count = max_node + 1;
+
+  std::vector<std::uint64_t> offsets(header.node_count + 1, 0);
+  for (std::size_t n = 0; n < degrees.size(); n++) {
+    offsets[n + 1] = degrees[n];
+  }
+  for (std::size_t n = 1; n < offsets.size(); n++) {
+    offsets[n] += offsets[n - 1];
+  }
+  header.edge_count = offsets.back();
+
+  const auto align = [](std::uint64_t at) { return (at + 63) / 64 * 64; };
+  header.offsets_at = align(sizeof(header));
+  header.targets_at =
+      align(header.offsets_at + offsets.size() * sizeof(std::uint64_t));
+  header.weights_at =
+      align(header.targets_at + header.edge_count * sizeof(std::int32_t));
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  const auto pad_to = [&out](std::uint64_t at) {
+    static const char zeros[64] = {};
+    out.write(zeros, at - static_cast<std::uint64_t>(out.tellp()));
+  };
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  pad_to(header.offsets_at);
+  out.write(reinterpret_cast<const char *>(offsets.data()),
+            offsets.size() * sizeof(std::uint64_t));
+
+  // the edges of a node are sorted by target, which weight() relies on
+  std::vector<edge> es;
+  std::vector<std::int32_t> column;
+  const auto write_column = [&](auto field) {
+    for (const int u : nodes) {
+      es.clear();
+      for (const auto e : graph.edges(u)) {
+        es.push_back(e);
+      }
+      std::sort(std::begin(es), std::end(es),
+                [](const edge &a, const edge &b) { return a.node < b.node; });
+
+      column.clear();
+      for (const auto &e : es) {
+        column.push_back(field(e));
+      }
+      out.write(reinterpret_cast<const char *>(column.data()),
+                column.size() * sizeof(std::int32_t));
+    }
+  };
+
+  pad_to(header.targets_at);
+  write_column([](const edge &e) { return e.node; });
+  pad_to(header.weights_at);
+  write_column([](const edge &e) { return e.weight; });
+
+  out.close();
+  if (!out) {
+    throw std::runtime_error("could not write the csr file " + path);
+  }
+}
+
+class mapped_csr_graph : public node_store<mapped_csr_graph> {
+ private:
+  void *_data{nullptr};
+  std::size_t _size{0};
+
+  std::size_t _node_count{0};
+  std::size_t _edge_count{0};
+  // the edges leaving node n are in [offsets[n], offsets[n + 1])
+  const std::uint64_t *offsets{nullptr};
+  const std::int32_t *targets{nullptr};
+  const std::int32_t *weights{nullptr};
+
+  void unmap() {
+    if (_data != nullptr) {
+      munmap(_data, _size);
+      _data = nullptr;
+    }
+  }
+
+  // checks that the header describes arrays that fit in the file, and points
+  // the arrays into the mapping
+  void attach(const std::string &path) {
+    const auto fail = [&path](const char *why) {
+      throw std::runtime_error(path + " is not a csr file: " + why);
+    };
+
+    if (_size < sizeof(csr_file_header)) {
+      fail("too short");
+    }
+    csr_file_header header;
+    std::memcpy(&header, _data, sizeof(header));
+
+    if (std::memcmp(header.magic, csr_file_magic, sizeof(header.magic)) != 0) {
+      fail("bad magic");
+    }
+    if (header.byte_order != csr_file_byte_order) {
+      fail("written with a different byte order");
+    }
+    if (header.version != csr_file_version) {
+      fail("unsupported version");
+    }
+
+    const auto fits = [this](std::uint64_t at, std::uint64_t count,
+                             std::size_t size) {
+      return at % size == 0 and at <= _size and count <= (_size - at) / size;
+    };
+    if (header.node_count == UINT64_MAX or
+        !fits(header.offsets_at, header.node_count + 1,
+              sizeof(std::uint64_t)) or
+        !fits(header.targets_at, header.edge_count, sizeof(std::int32_t)) or
+        !fits(header.weights_at, header.edge_count, sizeof(std::int32_t))) {
+      fail("the arrays do not fit in the file");
+    }
+
+    const char *base = static_cast<const char *>(_data);
+    offsets = reinterpret_cast<const std::uint64_t *>(base + header.offsets_at);
+    targets = reinterpret_cast<const std::int32_t *>(base + header.targets_at);
+    weights = reinterpret_cast<const std::int32_t *>(base + header.weights_at);
+    _node_count = header.node_count;
+    _edge_count = header.edge_count;
+
+    // the offsets have to end where the edges do, the ones in between are
+    // not read until they are needed
+    if (offsets[0] != 0 or offsets[_node_count] != _edge_count) {
+      fail("the offsets do not match the edges");
+    }
+  }
+
+ public:
+  // maps the file read-only. throws std::system_error if it can not be
+  // mapped, and std::runtime_error if it is not a csr file
+  explicit mapped_csr_graph(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      throw std::system_error(errno, std::generic_category(),
+                              "could not open " + path);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) == -1 or st.st_size == 0) {
+      const int error = st.st_size == 0 ? EINVAL : errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(),
+                              "could not map " + path);
+    }
+
+    _size = st.st_size;
+    _data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+    // the mapping keeps the file open
+    ::close(fd);
+    if (_data == MAP_FAILED) {
+      _data = nullptr;
+      throw std::system_error(error, std::generic_category(),
+                              "could not map " + path);
+    }
+
+    try {
+      attach(path);
+    } catch (...) {
+      unmap();
+      throw;
+    }
+  }
+
+  mapped_csr_graph(const mapped_csr_graph &) = delete;
+  mapped_csr_graph &operator=(const mapped_csr_graph &) = delete;
+  mapped_csr_graph(mapped_csr_graph &&o) noexcept { *this = std::move(o); }
+  mapped_csr_graph &operator=(mapped_csr_graph &&o) noexcept {
+    if (this != &o) {
+      unmap();
+      _data = std::exchange(o._data, nullptr);
+      _size = std::exchange(o._size, 0);
+      _node_count = std::exchange(o._node_count, 0);
+      _edge_count = std::exchange(o._edge_count, 0);
+      offsets = std::exchange(o.offsets, nullptr);
+      targets = std::exchange(o.targets, nullptr);
+      weights = std::exchange(o.weights, nullptr);
+    }
+    return *this;
+  }
+
+  ~mapped_csr_graph() { unmap(); }
+
+  void add_edge(int /*u*/, int /*v*/, int /*w*/) {
+    throw std::logic_error("mapped_csr_graph is immutable");
+  }
+
+  // all nodes that have edges leaving them
+  std::vector<int> nodes() const {
+    std::vector<int> ns;
+
+    for (std::size_t n = 0; n < _node_count; n++) {
+      if (offsets[n] != offsets[n + 1]) {
+        ns.push_back(n);
+      }
+    }
+
+    return ns;
+  }
+
+  edge_range<csr_edge_iterator> edges(int n) const {
+    if (n < 0 or static_cast<std::size_t>(n) >= _node_count) {
+      return {csr_edge_iterator(), csr_edge_iterator()};
+    }
+
+    return {csr_edge_iterator(targets + offsets[n], weights + offsets[n]),
+            csr_edge_iterator(targets + offsets[n + 1],
+                              weights + offsets[n + 1])};
+  }
+
+  // the edges of a node are sorted by their target, so we can binary search
+  // for it. returns 0 if there is no edge between u and v
+  int weight(int u, int v) const {
+    if (u < 0 or static_cast<std::size_t>(u) >= _node_count) {
+      return 0;
+    }
+
+    const std::int32_t *first = targets + offsets[u];
+    const std::int32_t *last = targets + offsets[u + 1];
+    const std::int32_t *it = std::lower_bound(first, last, v);
+    if (it == last or *it != v) {
+      return 0;
+    }
+
+    return weights[it - targets];
+  }
+
+  std::size_t node_count() const { return _node_count; }
+  std::size_t edge_count() const { return _edge_count; }
+  int id_bound() const { return node_count(); }
+};
+
+}  // namespace dads::graphs
+
+#endif
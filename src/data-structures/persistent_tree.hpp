@@ -0,0 +1,431 @@
+#ifndef PERSISTENT_TREE_HPP
+#define PERSISTENT_TREE_HPP
+/*
+  A persistent (copy-on-write) balanced binary search tree.
+  A tree is never changed in place. insert and remove copy the nodes on the
+  path from the root to the change, and the new path shares every subtree it
+  did not touch with the old one. Copying a tree only copies its root, so a
+  snapshot of a tree costs O(1), and it stays the same no matter what happens
+  to the tree it was taken from.
+  Time Complexity:
+  - space:    O(n), and O(log n) per version that is kept alive
+  - find:     O(log n)
+  - insert:   O(log n)
+  - remove:   O(log n)
+  - snapshot: O(1)
+  The nodes have the layout of the binary_search_tree nodes, without the
+  parent pointers, a shared subtree does not have a single parent. The tree
+  is kept balanced like an avl_tree, and nodes are reference counted, so a
+  node is deleted once the last version that has it is gone. The counts are
+  atomic, so versions can be copied and dropped on any thread.
+  The keys and values on the path to a change are copied into the new nodes,
+  so they should be cheap to copy, or be pointers to the real thing.
+  versioned_tree holds the current version of a tree for writers to update,
+  and readers to take snapshots of, without locks.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <utils/epoch_domain.hpp>
+
+namespace dads::trees {
+
+template <typename K, typename V>
+class persistent_tree {
+ private:
+  struct node;
+
+  // a counted reference to a node
+  class ref {
+   private:
+    const node *p{nullptr};
+
+   public:
+    ref() = default;
+    // adopts a reference that has already been counted
+    explicit ref(const node *p) : p(p) {}
+    ref(const ref &o) : p(o.p) {
+      if (p != nullptr) {
+        p->refs.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    ref(ref &&o) noexcept : p(std::exchange(o.p, nullptr)) {}
+    ref &operator=(ref o) noexcept {
+      std::swap(p, o.p);
+      return *this;
+    }
+    ~ref() {
+      if (p != nullptr and
+          p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete p;
+      }
+    }
+
+    const node *get() const { return p; }
+    const node *operator->() const { return p; }
+    explicit operator bool() const { return p != nullptr; }
+  };
+
+  struct node {
+    const K key;
+    const V value;
+    const ref left;
+    const ref right;
+    // the number of levels in the subtree rooted at this node
+    const int height;
+    mutable std::atomic<int> refs{1};
+
+    node(K key, V value, ref left, ref right)
+        : key(std::move(key)),
+          value(std::move(value)),
+          left(std::move(left)),
+          right(std::move(right)),
+          height(1 + std::max(height_of(this->left), height_of(this->right))) {}
+  };
+
+  ref _root;
+  int _nodes{0};
+
+  static int height_of(const ref &n) { return n ? n->height : 0; }
+
+  static ref make(K key, V value, ref left, ref right) {
+    return ref(new node(std::move(key), std::move(value), std::move(left),
+                        std::move(right)));
+  }
+
+  static ref balance(K key, V value, ref left, ref right);
+  template <typename Key>
+  static ref insert(const ref &t, Key &&key, V &&value, bool &inserted);
+  template <typename Key>
+  static ref remove(const ref &t, const Key &key, bool &removed);
+  static ref remove_min(const ref &t);
+
+  // calls callback(key, value), or callback(tuple of references to them) for
+  // the callables that take a single argument
+  template <typename F>
+  static void inorder(const node *n, F &callback) {
+    while (n != nullptr) {
+      inorder(n->left.get(), callback);
+      if constexpr (std::is_invocable_v<F &, const K &, const V &>) {
+        callback(n->key, n->value);
+      } else {
+        callback(std::tuple<const K &, const V &>(n->key, n->value));
+      }
+      n = n->right.get();
+    }
+  }
+
+ public:
+  persistent_tree() = default;
+  persistent_tree(std::initializer_list<std::tuple<K, V>> elements) {
+    for (auto kvp : elements) {
+      insert(std::get<0>(kvp), std::get<1>(kvp));
+    }
+  }
+
+  // copies share all nodes with the original, and are independent of it
+  persistent_tree(const persistent_tree &) = default;
+  persistent_tree &operator=(const persistent_tree &) = default;
+  persistent_tree(persistent_tree &&o) noexcept
+      : _root(std::move(o._root)), _nodes(std::exchange(o._nodes, 0)) {}
+  persistent_tree &operator=(persistent_tree &&o) noexcept {
+    _root = std::move(o._root);
+    _nodes = std::exchange(o._nodes, 0);
+    return *this;
+  }
+
+  // an O(1) copy of the tree, as it is right now
+  persistent_tree snapshot() const { return *this; }
+
+  bool insert(K key, V value);
+  template <typename Key>
+  bool remove(const Key &key);
+
+  // the value stored with key, or null if the key is not in the tree. the
+  // value lives as long as any version of the tree that has it
+  template <typename Key>
+  const V *find(const Key &key) const;
+  template <typename Key>
+  bool contains(const Key &key) const {
+    return find(key) != nullptr;
+  }
+
+  std::optional<std::tuple<const K &, const V &>> min() const;
+  std::optional<std::tuple<const K &, const V &>> max() const;
+  int height() const { return height_of(_root); }
+  int size() const { return _nodes; }
+
+  // calls the callback for every element, in key order
+  template <typename F>
+  void inorder(F &&callback) const {
+    inorder(_root.get(), callback);
+  }
+
+  // true if the two trees are the same version, or share the same root
+  bool shares_root_with(const persistent_tree &o) const {
+    return _root.get() == o._root.get();
+  }
+};
+
+// makes a node of key and value, with the two subtrees as its children. if
+// their heights differ by more than one, the taller one is rotated up, which
+// is enough, since they only ever differ by two after a single insert or
+// remove
+template <typename K, typename V>
+typename persistent_tree<K, V>::ref persistent_tree<K, V>::balance(
+    K key, V value, ref left, ref right) {
+  const int hl = height_of(left);
+  const int hr = height_of(right);
+
+  if (hl > hr + 1) {
+    const node *l = left.get();
+    if (height_of(l->left) >= height_of(l->right)) {
+      return make(l->key, l->value, l->left,
+                  make(std::move(key), std::move(value), l->right,
+                       std::move(right)));
+    }
+    // the left-right case needs a double rotation
+    const node *lr = l->right.get();
+    return make(lr->key, lr->value, make(l->key, l->value, l->left, lr->left),
+                make(std::move(key), std::move(value), lr->right,
+                     std::move(right)));
+  }
+
+  if (hr > hl + 1) {
+    const node *r = right.get();
+    if (height_of(r->right) >= height_of(r->left)) {
+      return make(r->key, r->value,
+                  make(std::move(key), std::move(value), std::move(left),
+                       r->left),
+                  r->right);
+    }
+    const node *rl = r->left.get();
+    return make(rl->key, rl->value,
+                make(std::move(key), std::move(value), std::move(left),
+                     rl->left),
+                make(r->key, r->value, rl->right, r->right));
+  }
+
+  return make(std::move(key), std::move(value), std::move(left),
+              std::move(right));
+}
+
+// returns the new root of the subtree t, with key added. if the key is
+// already there, t itself is returned
+template <typename K, typename V>
+template <typename Key>
+typename persistent_tree<K, V>::ref persistent_tree<K, V>::insert(
+    const ref &t, Key &&key, V &&value, bool &inserted) {
+  if (!t) {
+    inserted = true;
+    return make(std::forward<Key>(key), std::move(value), ref(), ref());
+  }
+
+  if (key < t->key) {
+    ref left = insert(t->left, std::forward<Key>(key), std::move(value),
+                      inserted);
+    return inserted ? balance(t->key, t->value, std::move(left), t->right) : t;
+  }
+  if (t->key < key) {
+    ref right = insert(t->right, std::forward<Key>(key), std::move(value),
+                       inserted);
+    return inserted ? balance(t->key, t->value, t->left, std::move(right)) : t;
+  }
+
+  // do not insert duplicates
+  inserted = false;
+  return t;
+}
+
+// the subtree t without its smallest node
+template <typename K, typename V>
+typename persistent_tree<K, V>::ref persistent_tree<K, V>::remove_min(
+    const ref &t) {
+  if (!t->left) {
+    return t->right;
+  }
+  return balance(t->key, t->value, remove_min(t->left), t->right);
+}
+
+// returns the new root of the subtree t, without key. if the key is not
+// there, t itself is returned
+template <typename K, typename V>
+template <typename Key>
+typename persistent_tree<K, V>::ref persistent_tree<K, V>::remove(
+    const ref &t, const Key &key, bool &removed) {
+  if (!t) {
+    removed = false;
+    return t;
+  }
+
+  if (key < t->key) {
+    ref left = remove(t->left, key, removed);
+    return removed ? balance(t->key, t->value, std::move(left), t->right) : t;
+  }
+  if (t->key < key) {
+    ref right = remove(t->right, key, removed);
+    return removed ? balance(t->key, t->value, t->left, std::move(right)) : t;
+  }
+
+  // the smallest node of the right subtree takes our place
+  removed = true;
+  if (!t->left) {
+    return t->right;
+  }
+  if (!t->right) {
+    return t->left;
+  }
+
+  const node *successor = t->right.get();
+  while (successor->left) {
+    successor = successor->left.get();
+  }
+  return balance(successor->key, successor->value, t->left,
+                 remove_min(t->right));
+}
+
+// returns true is data was inserted,
+// false if it was already in the tree
+template <typename K, typename V>
+bool persistent_tree<K, V>::insert(K key, V value) {
+  bool inserted = false;
+  ref root = insert(_root, std::move(key), std::move(value), inserted);
+  if (inserted) {
+    _root = std::move(root);
+    _nodes++;
+  }
+  return inserted;
+}
+
+// returns true if the key was removed,
+// false if key was not found in the tree
+template <typename K, typename V>
+template <typename Key>
+bool persistent_tree<K, V>::remove(const Key &key) {
+  bool removed = false;
+  ref root = remove(_root, key, removed);
+  if (removed) {
+    _root = std::move(root);
+    _nodes--;
+  }
+  return removed;
+}
+
+template <typename K, typename V>
+template <typename Key>
+const V *persistent_tree<K, V>::find(const Key &key) const {
+  const node *cur = _root.get();
+  while (cur != nullptr) {
+    if (key < cur->key) {
+      cur = cur->left.get();
+    } else if (cur->key < key) {
+      cur = cur->right.get();
+    } else {
+      return &cur->value;
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename K, typename V>
+std::optional<std::tuple<const K &, const V &>> persistent_tree<K, V>::min()
+    const {
+  if (!_root) {
+    return std::nullopt;
+  }
+
+  const node *cur = _root.get();
+  while (cur->left) {
+    cur = cur->left.get();
+  }
+  return std::tuple<const K &, const V &>(cur->key, cur->value);
+}
+
+template <typename K, typename V>
+std::optional<std::tuple<const K &, const V &>> persistent_tree<K, V>::max()
+    const {
+  if (!_root) {
+    return std::nullopt;
+  }
+
+  const node *cur = _root.get();
+  while (cur->right) {
+    cur = cur->right.get();
+  }
+  return std::tuple<const K &, const V &>(cur->key, cur->value);
+}
+
+/*
+  The current version of a persistent_tree, shared between threads.
+  Readers take snapshots without locking, and keep using them for as long as
+  they like. Writers are serialized, each update builds a new version from
+  the current one, and publishes it. A version that has been replaced is only
+  let go of once no reader can be in the middle of copying it, which an
+  epoch_domain keeps track of.
+*/
+template <typename K, typename V>
+class versioned_tree {
+ private:
+  std::atomic<persistent_tree<K, V> *> current;
+  std::mutex writer;
+  utils::epoch_domain epochs;
+
+ public:
+  versioned_tree() : current(new persistent_tree<K, V>()) {}
+  versioned_tree(const versioned_tree &) = delete;
+  versioned_tree &operator=(const versioned_tree &) = delete;
+
+  // no other thread may use it while it is destroyed
+  ~versioned_tree() { delete current.load(std::memory_order_relaxed); }
+
+  // the current version, in O(1)
+  persistent_tree<K, V> snapshot() {
+    utils::epoch_domain::guard guard(epochs);
+    return *current.load(std::memory_order_acquire);
+  }
+
+  // calls f(tree) on a copy of the current version, and publishes the copy
+  // as the new version. returns whatever f returns
+  template <typename F>
+  auto update(F &&f) {
+    std::lock_guard<std::mutex> lock(writer);
+    utils::epoch_domain::guard guard(epochs);
+
+    persistent_tree<K, V> *old = current.load(std::memory_order_relaxed);
+    auto next = std::make_unique<persistent_tree<K, V>>(*old);
+
+    if constexpr (std::is_void_v<decltype(f(*next))>) {
+      f(*next);
+      current.store(next.release(), std::memory_order_release);
+      guard.retire(old);
+    } else {
+      auto result = f(*next);
+      current.store(next.release(), std::memory_order_release);
+      guard.retire(old);
+      return result;
+    }
+  }
+
+  bool insert(K key, V value) {
+    return update([&](persistent_tree<K, V> &t) {
+      return t.insert(std::move(key), std::move(value));
+    });
+  }
+
+  template <typename Key>
+  bool remove(const Key &key) {
+    return update([&](persistent_tree<K, V> &t) { return t.remove(key); });
+  }
+};
+
+}  // namespace dads::trees
+
+#endif
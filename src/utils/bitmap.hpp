@@ -0,0 +1,109 @@
+#ifndef BITMAP_HPP
+#define BITMAP_HPP
+/*
+  A fixed-size bitmap, one bit per index.
+  The words are atomics, so threads can set bits concurrently with
+  set_atomic(). All other operations are relaxed loads and stores, which cost
+  the same as plain ones, and are only safe while no other thread writes to
+  the same word.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace dads::utils {
+
+class bitmap {
+ private:
+  static constexpr std::size_t word_bits = 64;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> _words;
+  std::size_t _bits{0};
+  std::size_t _size{0};
+
+  static std::size_t words_for(std::size_t bits) {
+    return (bits + word_bits - 1) / word_bits;
+  }
+
+ public:
+  bitmap() = default;
+  explicit bitmap(std::size_t bits)
+      : _words(std::make_unique<std::atomic<uint64_t>[]>(words_for(bits))),
+        _bits(bits),
+        _size(words_for(bits)) {
+    clear();
+  }
+
+  std::size_t size() const { return _bits; }
+  std::size_t word_count() const { return _size; }
+
+  bool test(std::size_t i) const {
+    return (word(i / word_bits) >> (i % word_bits)) & 1u;
+  }
+
+  void set(std::size_t i) {
+    auto &w = _words[i / word_bits];
+    w.store(
+        w.load(std::memory_order_relaxed) | (uint64_t{1} << (i % word_bits)),
+        std::memory_order_relaxed);
+  }
+
+  void reset(std::size_t i) {
+    auto &w = _words[i / word_bits];
+    w.store(
+        w.load(std::memory_order_relaxed) & ~(uint64_t{1} << (i % word_bits)),
+        std::memory_order_relaxed);
+  }
+
+  // sets a bit, safe to call from multiple threads at once. returns true if
+  // this call was the one that set it
+  bool set_atomic(std::size_t i) {
+    const uint64_t mask = uint64_t{1} << (i % word_bits);
+    return (_words[i / word_bits].fetch_or(mask, std::memory_order_relaxed) &
+            mask) == 0;
+  }
+
+  void clear() {
+    for (std::size_t i = 0; i < _size; i++) {
+      _words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // the raw words, bit i is bit (i % 64) of word (i / 64)
+  uint64_t word(std::size_t w) const {
+    return _words[w].load(std::memory_order_relaxed);
+  }
+
+  std::size_t count() const {
+    std::size_t c = 0;
+    for (std::size_t i = 0; i < _size; i++) {
+      c += __builtin_popcountll(word(i));
+    }
+    return c;
+  }
+
+  // calls fn(i) for every set bit i in the words [first_word, last_word), in
+  // increasing order
+  template <typename F>
+  void for_each_set(
+      F &&fn, std::size_t first_word = 0,
+      std::size_t last_word = static_cast<std::size_t>(-1)) const {
+    if (last_word > _size) {
+      last_word = _size;
+    }
+    for (std::size_t w = first_word; w < last_word; w++) {
+      uint64_t bits = word(w);
+      while (bits != 0) {
+        fn(w * word_bits + __builtin_ctzll(bits));
+        // clear the lowest set bit
+        bits &= bits - 1;
+      }
+    }
+  }
+};
+
+}  // namespace dads::utils
+
+#endif
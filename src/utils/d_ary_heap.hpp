@@ -0,0 +1,110 @@
+#ifndef D_ARY_HEAP_HPP
+#define D_ARY_HEAP_HPP
+/*
+  A d-ary heap, a binary heap where every node has D children instead of two.
+  The tree is stored implicitly in a single array. With D = 4 the children of
+  a node sit next to each other in the same cache line, and the tree is half
+  as deep as a binary heap, which makes pushes cheaper and pops touch fewer
+  cache lines.
+  top() is the smallest element according to Compare.
+  Time Complexity:
+  - push:   O(log_D n)
+  - pop:    O(D log_D n)
+  - top:    O(1)
+*/
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace dads::utils {
+
+template <typename T, std::size_t D = 4, typename Compare = std::less<T>>
+class d_ary_heap {
+  static_assert(D >= 2, "a heap node needs at least two children");
+
+ private:
+  std::vector<T> data;
+  Compare less;
+
+  void sift_up(std::size_t i) {
+    T item = std::move(data[i]);
+    while (i > 0) {
+      const std::size_t parent = (i - 1) / D;
+      if (!less(item, data[parent])) {
+        break;
+      }
+      data[i] = std::move(data[parent]);
+      i = parent;
+    }
+    data[i] = std::move(item);
+  }
+
+  void sift_down(std::size_t i) {
+    const std::size_t n = data.size();
+    T item = std::move(data[i]);
+    while (true) {
+      const std::size_t first = i * D + 1;
+      if (first >= n) {
+        break;
+      }
+
+      // find the smallest child
+      std::size_t smallest = first;
+      const std::size_t last = first + D < n ? first + D : n;
+      for (std::size_t c = first + 1; c < last; c++) {
+        if (less(data[c], data[smallest])) {
+          smallest = c;
+        }
+      }
+
+      if (!less(data[smallest], item)) {
+        break;
+      }
+      data[i] = std::move(data[smallest]);
+      i = smallest;
+    }
+    data[i] = std::move(item);
+  }
+
+ public:
+  d_ary_heap() = default;
+  explicit d_ary_heap(Compare compare) : less(std::move(compare)) {}
+
+  bool empty() const { return data.empty(); }
+  std::size_t size() const { return data.size(); }
+  void reserve(std::size_t n) { data.reserve(n); }
+  void clear() { data.clear(); }
+
+  // the smallest element, requires !empty()
+  const T &top() const { return data.front(); }
+
+  void push(T item) {
+    data.push_back(std::move(item));
+    sift_up(data.size() - 1);
+  }
+
+  template <typename... Args>
+  void emplace(Args &&... args) {
+    data.emplace_back(std::forward<Args>(args)...);
+    sift_up(data.size() - 1);
+  }
+
+  // removes and returns the smallest element, requires !empty()
+  T pop() {
+    T top = std::move(data.front());
+    if (data.size() > 1) {
+      data.front() = std::move(data.back());
+      data.pop_back();
+      sift_down(0);
+    } else {
+      data.pop_back();
+    }
+    return top;
+  }
+};
+
+}  // namespace dads::utils
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef EPOCH_DOMAIN_HPP
+#define EPOCH_DOMAIN_HPP
+/*
+  Epoch based memory reclamation, for lock-free data structures.
+  A thread pins the domain while it reads a shared structure, and nodes that
+  are unlinked from the structure are retired instead of deleted. A retired
+  node is tagged with the global epoch at the time it is retired, and is only
+  deleted once the global epoch has moved two steps past that. The epoch can
+  only move forward when every pinned thread has seen the current epoch, so by
+  then no thread that could have reached the node is still pinned.
+  - pin:    O(1), amortized, except every so often when it tries to advance
+            the epoch, which looks at every slot
+  - retire: O(1)
+  A guard holds a slot of the domain while it is alive. The slots are claimed
+  by whichever thread needs one, so the domain does not need to know about the
+  threads that use it, and a thread that exits does not leak anything. The
+  retired nodes are kept with the slot they were retired from, and are deleted
+  by the next thread to pin that slot, once they are old enough.
+*/
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dads::utils {
+
+class epoch_domain {
+ private:
+  struct retired {
+    void *p;
+    void (*deleter)(void *);
+  };
+
+  // the retired nodes of a slot, by the epoch they were retired in, modulo 3.
+  // the three buckets hold the epochs that may still be in use
+  struct limbo {
+    std::vector<retired> nodes;
+    std::uint64_t epoch{0};
+  };
+
+  // slots sit on their own cache lines, so pinning one does not slow down the
+  // threads that pin the others
+  struct alignas(64) slot {
+    std::atomic<bool> owned{false};
+    // 0 when the slot is not pinned, otherwise the epoch it was pinned in,
+    // shifted left, with the lowest bit set
+    std::atomic<std::uint64_t> pinned{0};
+    slot *next{nullptr};
+
+    // only touched by the thread that owns the slot
+    std::array<limbo, 3> buckets;
+    std::uint64_t pins{0};
+  };
+
+  // how often, in pins, a slot tries to advance the epoch
+  static constexpr std::uint64_t advance_every = 64;
+
+  // the epoch starts at 2, so retiring in epoch 0 is not confused with an
+  // empty bucket
+  std::atomic<std::uint64_t> global_epoch{2};
+  std::atomic<slot *> slots{nullptr};
+  const std::uint64_t id;
+
+  static std::uint64_t next_id() {
+    static std::atomic<std::uint64_t> ids{0};
+    return ids.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // the slot this thread used last, and the domain it belongs to. the id of a
+  // domain is never reused, so a slot of a destroyed domain is never touched
+  struct last_slot {
+    std::uint64_t domain{~std::uint64_t{0}};
+    slot *s{nullptr};
+  };
+  static last_slot &cached() {
+    thread_local last_slot last;
+    return last;
+  }
+
+  static bool try_claim(slot *s) {
+    bool expected = false;
+    return !s->owned.load(std::memory_order_relaxed) and
+           s->owned.compare_exchange_strong(expected, true,
+                                            std::memory_order_acquire);
+  }
+
+  // finds a free slot, the one this thread used last if it can, and adds a
+  // new slot if all of them are taken
+  slot *claim() {
+    last_slot &last = cached();
+    if (last.domain == id and try_claim(last.s)) {
+      return last.s;
+    }
+
+    slot *s = slots.load(std::memory_order_acquire);
+    for (; s != nullptr; s = s->next) {
+      if (try_claim(s)) {
+        break;
+      }
+    }
+
+    if (s == nullptr) {
+      s = new slot();
+      s->owned.store(true, std::memory_order_relaxed);
+      s->next = slots.load(std::memory_order_relaxed);
+      while (!slots.compare_exchange_weak(s->next, s,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+      }
+    }
+
+    last = {id, s};
+    return s;
+  }
+
+  // moves the epoch forward, if every pinned slot is in the current epoch
+  void try_advance(std::uint64_t epoch) {
+    for (slot *s = slots.load(std::memory_order_acquire); s != nullptr;
+         s = s->next) {
+      const std::uint64_t pinned = s->pinned.load(std::memory_order_seq_cst);
+      if (pinned != 0 and pinned >> 1 != epoch) {
+        return;
+      }
+    }
+
+    global_epoch.compare_exchange_strong(epoch, epoch + 1,
+                                         std::memory_order_seq_cst);
+  }
+
+  static void free_bucket(limbo &bucket) {
+    for (const retired &r : bucket.nodes) {
+      r.deleter(r.p);
+    }
+    bucket.nodes.clear();
+  }
+
+  // deletes the nodes that were retired at least two epochs ago
+  static void collect(slot *s, std::uint64_t epoch) {
+    for (limbo &bucket : s->buckets) {
+      if (!bucket.nodes.empty() and bucket.epoch + 2 <= epoch) {
+        free_bucket(bucket);
+      }
+    }
+  }
+
+  slot *pin() {
+    slot *s = claim();
+
+    const std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+    s->pinned.store((epoch << 1) | 1, std::memory_order_seq_cst);
+    // the pin has to be visible before we read anything from the structure
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (++s->pins % advance_every == 0) {
+      try_advance(epoch);
+    }
+    // acquire, to see the unpins of the readers that let the epoch advance
+    // before we free what they could have reached
+    collect(s, global_epoch.load(std::memory_order_acquire));
+
+    return s;
+  }
+
+  static void unpin(slot *s) {
+    s->pinned.store(0, std::memory_order_release);
+    s->owned.store(false, std::memory_order_release);
+  }
+
+  void retire(slot *s, void *p, void (*deleter)(void *)) {
+    // the epoch is read after the node was unlinked. the fence keeps the
+    // caller's unlinking store from being reordered after the load
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+    limbo &bucket = s->buckets[epoch % 3];
+
+    // the bucket is three epochs behind, so it is safe to empty it
+    if (bucket.epoch != epoch) {
+      free_bucket(bucket);
+      bucket.epoch = epoch;
+    }
+    bucket.nodes.push_back({p, deleter});
+  }
+
+ public:
+  // keeps the domain pinned while it is alive. nodes read from the structure
+  // the domain protects can only be used while the guard is alive
+  class guard {
+   private:
+    epoch_domain *domain;
+    slot *s;
+
+   public:
+    explicit guard(epoch_domain &domain) : domain(&domain), s(domain.pin()) {}
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+    ~guard() { unpin(s); }
+
+    // hands a node that is no longer reachable from the structure over to
+    // the domain, which deletes it with deleter(p), when it is safe to
+    void retire(void *p, void (*deleter)(void *)) {
+      domain->retire(s, p, deleter);
+    }
+
+    template <typename T>
+    void retire(T *p) {
+      retire(p, [](void *q) { delete static_cast<T *>(q); });
+    }
+  };
+
+  epoch_domain() : id(next_id()) {}
+  epoch_domain(const epoch_domain &) = delete;
+  epoch_domain &operator=(const epoch_domain &) = delete;
+
+  // no thread may be pinned when the domain is destroyed
+  ~epoch_domain() {
+    slot *s = slots.load(std::memory_order_acquire);
+    while (s != nullptr) {
+      for (limbo &bucket : s->buckets) {
+        free_bucket(bucket);
+      }
+      slot *next = s->next;
+      delete s;
+      s = next;
+    }
+  }
+
+  guard pin_guard() { return guard(*this); }
+
+  // deletes every retired node that is old enough, as far as the slots that
+  // are not in use know. mostly useful in tests
+  void collect_all() {
+    for (int i = 0; i < 3; i++) {
+      guard g(*this);
+      try_advance(global_epoch.load(std::memory_order_seq_cst));
+    }
+
+    const std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+    for (slot *s = slots.load(std::memory_order_acquire); s != nullptr;
+         s = s->next) {
+      if (try_claim(s)) {
+        collect(s, epoch);
+        s->owned.store(false, std::memory_order_release);
+      }
+    }
+  }
+
+  std::uint64_t epoch() const {
+    return global_epoch.load(std::memory_order_relaxed);
+  }
+};
+
+}  // namespace dads::utils
+
+#endif
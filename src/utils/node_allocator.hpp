@@ -0,0 +1,142 @@
+#ifndef NODE_ALLOCATOR_HPP
+#define NODE_ALLOCATOR_HPP
+/*
+  Allocators for the nodes of node based data structures.
+  An allocator for nodes of type T provides
+  - allocate() -> T*, storage for a single T, not constructed
+  - deallocate(T*), gives back the storage of a T that is already destroyed
+  - reserve(n), a hint that n allocations are coming
+  - releases_all, true if release() frees all storage at once, so a structure
+    with trivially destructible nodes does not have to visit them to free them
+  - release(), gives back all storage, only if releases_all is true
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dads::utils {
+
+// every node is its own allocation
+template <typename T>
+class heap_allocator {
+ public:
+  static constexpr bool releases_all = false;
+
+  T *allocate() { return static_cast<T *>(::operator new(sizeof(T))); }
+  void deallocate(T *p) { ::operator delete(p); }
+  void reserve(std::size_t /*n*/) {}
+  void release() {}
+};
+
+/*
+  A slab allocator. Nodes are carved out of contiguous chunks, so nodes that
+  are allocated together are close in memory, and a node costs no allocator
+  bookkeeping. Freed nodes are kept on a free list, and reused by the next
+  allocations. The chunks grow geometrically, and are only returned when the
+  allocator is released or destroyed.
+*/
+template <typename T>
+class pool_allocator {
+ private:
+  // a free slot holds a pointer to the next free slot
+  union slot {
+    slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  static constexpr std::size_t first_chunk = 64;
+  static constexpr std::size_t max_chunk = 1 << 16;
+
+  std::vector<std::unique_ptr<slot[]>> chunks;
+  slot *free_list{nullptr};
+
+  // the unused part of the last chunk
+  slot *next_unused{nullptr};
+  slot *chunk_end{nullptr};
+  std::size_t chunk_size{first_chunk};
+
+  void grow(std::size_t size) {
+    // not make_unique, that would zero the slots
+    chunks.emplace_back(new slot[size]);
+    next_unused = chunks.back().get();
+    chunk_end = next_unused + size;
+    if (chunk_size < max_chunk) {
+      chunk_size *= 2;
+    }
+  }
+
+ public:
+  static constexpr bool releases_all = true;
+
+  pool_allocator() = default;
+  pool_allocator(const pool_allocator &) = delete;
+  pool_allocator &operator=(const pool_allocator &) = delete;
+  // the moved-from allocator is left empty, like after release(), so it
+  // can not hand out slots of the chunks it gave away
+  pool_allocator(pool_allocator &&other) noexcept
+      : chunks(std::move(other.chunks)),
+        free_list(std::exchange(other.free_list, nullptr)),
+        next_unused(std::exchange(other.next_unused, nullptr)),
+        chunk_end(std::exchange(other.chunk_end, nullptr)),
+        chunk_size(std::exchange(other.chunk_size, first_chunk)) {
+    other.chunks.clear();
+  }
+  pool_allocator &operator=(pool_allocator &&other) noexcept {
+    if (this != &other) {
+      chunks = std::move(other.chunks);
+      other.chunks.clear();
+      free_list = std::exchange(other.free_list, nullptr);
+      next_unused = std::exchange(other.next_unused, nullptr);
+      chunk_end = std::exchange(other.chunk_end, nullptr);
+      chunk_size = std::exchange(other.chunk_size, first_chunk);
+    }
+    return *this;
+  }
+
+  T *allocate() {
+    if (free_list != nullptr) {
+      slot *s = free_list;
+      free_list = s->next;
+      return reinterpret_cast<T *>(s->storage);
+    }
+
+    if (next_unused == chunk_end) {
+      grow(chunk_size);
+    }
+    return reinterpret_cast<T *>((next_unused++)->storage);
+  }
+
+  void deallocate(T *p) {
+    slot *s = reinterpret_cast<slot *>(p);
+    s->next = free_list;
+    free_list = s;
+  }
+
+  // makes sure the next n allocations, that are not served by the free list,
+  // come from one contiguous run of slots
+  void reserve(std::size_t n) {
+    if (static_cast<std::size_t>(chunk_end - next_unused) < n) {
+      grow(std::max(n, chunk_size));
+    }
+  }
+
+  // frees every chunk, in O(chunks)
+  void release() {
+    chunks.clear();
+    free_list = nullptr;
+    next_unused = nullptr;
+    chunk_end = nullptr;
+    chunk_size = first_chunk;
+  }
+
+  // the number of chunks allocated so far
+  std::size_t chunk_count() const { return chunks.size(); }
+};
+
+}  // namespace dads::utils
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+/*
+  A radix heap, a monotone priority queue for unsigned integer keys.
+  Monotone means that a pushed key can never be smaller than the last popped
+  key, which is the case for the distances in Dijkstra's algorithm.
+  Elements are kept in buckets by the highest bit in which their key differs
+  from the last popped key. A pop only has to redistribute a bucket when the
+  smallest bucket runs empty, and an element can only move to smaller buckets,
+  so it moves at most 64 times in total.
+  Time Complexity: (amortized)
+  - push:   O(1)
+  - pop:    O(log C), where C is the largest key
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dads::utils {
+
+template <typename Value>
+class radix_heap {
+ private:
+  // bucket 0 holds keys equal to the last popped key, bucket i holds the keys
+  // whose highest bit differing from it is bit i - 1
+  std::array<std::vector<std::pair<uint64_t, Value>>, 65> buckets;
+  uint64_t last{0};
+  std::size_t _size{0};
+
+  static std::size_t bucket_of(uint64_t key, uint64_t last) {
+    return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+  }
+
+  // moves the elements of the smallest non-empty bucket into smaller buckets,
+  // relative to the smallest key among them, so bucket 0 is no longer empty.
+  // does nothing if the heap is empty
+  void refill() {
+    if (!buckets[0].empty() or _size == 0) {
+      return;
+    }
+
+    std::size_t i = 1;
+    while (i < 64 and buckets[i].empty()) {
+      i++;
+    }
+
+    uint64_t smallest = buckets[i].front().first;
+    for (const auto &kv : buckets[i]) {
+      smallest = kv.first < smallest ? kv.first : smallest;
+    }
+
+    last = smallest;
+    for (auto &kv : buckets[i]) {
+      buckets[bucket_of(kv.first, last)].push_back(std::move(kv));
+    }
+    buckets[i].clear();
+  }
+
+ public:
+  bool empty() const { return _size == 0; }
+  std::size_t size() const { return _size; }
+
+  void push(uint64_t key, Value value) {
+    if (key < last) {
+      throw std::invalid_argument("radix_heap keys can not decrease");
+    }
+    buckets[bucket_of(key, last)].emplace_back(key, std::move(value));
+    _size++;
+  }
+
+  // the smallest key in the heap, requires !empty()
+  uint64_t top_key() {
+    refill();
+    return last;
+  }
+
+  // removes and returns the (key, value) pair with the smallest key,
+  // requires !empty()
+  std::pair<uint64_t, Value> pop() {
+    refill();
+    auto kv = std::move(buckets[0].back());
+    buckets[0].pop_back();
+    _size--;
+    return kv;
+  }
+
+  void clear() {
+    for (auto &b : buckets) {
+      b.clear();
+    }
+    last = 0;
+    _size = 0;
+  }
+};
+
+}  // namespace dads::utils
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+/*
+  A minimal thread pool for the parallel algorithms.
+  The workers are started once, and sleep between jobs. The thread that
+  submits a job works on it as well, so a pool of size 1 has no extra threads,
+  and runs everything on the caller.
+  A job can not submit another job to the same pool.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dads::utils {
+
+class thread_pool {
+ private:
+  std::vector<std::thread> workers;
+
+  // only one job runs at a time
+  std::mutex submit;
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::function<void(std::size_t)> job;
+  std::size_t generation{0};
+  std::size_t running{0};
+  bool stopping{false};
+  std::exception_ptr error;
+
+  void work(std::size_t worker) {
+    std::size_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping or generation != seen; });
+        if (stopping) {
+          return;
+        }
+        seen = generation;
+      }
+
+      run_job(worker);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--running == 0) {
+        done.notify_one();
+      }
+    }
+  }
+
+  void run_job(std::size_t worker) {
+    try {
+      job(worker);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+ public:
+  explicit thread_pool(
+      std::size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+    // the submitting thread is worker 0
+    for (std::size_t i = 1; i < std::max<std::size_t>(threads, 1); i++) {
+      workers.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  thread_pool(thread_pool &&) = delete;
+  thread_pool &operator=(thread_pool &&) = delete;
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto &w : workers) {
+      w.join();
+    }
+  }
+
+  // the number of threads that work on a job, including the caller
+  std::size_t size() const { return workers.size() + 1; }
+
+  // runs fn(worker) once on every worker, with worker in [0, size()), and
+  // blocks until all of them are done. the first exception thrown by any of
+  // them is rethrown here
+  template <typename F>
+  void run(F &&fn) {
+    std::lock_guard<std::mutex> serial(submit);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = std::forward<F>(fn);
+      error = nullptr;
+      running = workers.size();
+      generation++;
+    }
+    wake.notify_all();
+
+    run_job(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return running == 0; });
+    job = nullptr;
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // splits [first, last) into chunks of `grain` items, which the workers
+  // grab one at a time, and calls fn(worker, begin, end) for each chunk
+  template <typename F>
+  void parallel_chunks(std::size_t first, std::size_t last, std::size_t grain,
+                       F &&fn) {
+    if (first >= last) {
+      return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+
+    // not worth waking the workers for a single chunk
+    if (last - first <= grain or size() == 1) {
+      fn(std::size_t{0}, first, last);
+      return;
+    }
+
+    std::atomic<std::size_t> next{first};
+    run([&](std::size_t worker) {
+      while (true) {
+        const std::size_t begin = next.fetch_add(grain);
+        if (begin >= last) {
+          return;
+        }
+        fn(worker, begin, std::min(begin + grain, last));
+      }
+    });
+  }
+
+  // calls fn(i) for every i in [first, last), spread over the workers
+  template <typename F>
+  void parallel_for(std::size_t first, std::size_t last, F &&fn,
+                    std::size_t grain = 1024) {
+    parallel_chunks(first, last, grain,
+                    [&fn](std::size_t, std::size_t begin, std::size_t end) {
+                      for (std::size_t i = begin; i < end; i++) {
+                        fn(i);
+                      }
+                    });
+  }
+};
+
+// a pool shared by the algorithms that are not given one, with a thread for
+// every core
+inline thread_pool &default_thread_pool() {
+  static thread_pool pool;
+  return pool;
+}
+
+}  // namespace dads::utils
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef UNION_FIND_HPP
+#define UNION_FIND_HPP
+/*
+  A lock-free union-find (disjoint set) over the elements [0, n).
+  Every element points at a parent, and the roots of the trees name the sets.
+  Any number of threads can call find, unite, and same at once, the parents
+  are atomics that are only ever changed with compare-and-swap:
+  - unite links the root with the bigger id under the one with the smaller id,
+    so the root of a set is always its smallest element, and there can be no
+    cycles, whatever order the links happen in
+  - find halves the path it walks, pointing every other element at its
+    grandparent. a lost race only means the path was not shortened
+  Time Complexity, for m operations on n elements, with p threads:
+  - find, unite, same: O(log n) each, amortized O(α(n)) without contention
+  - the work of m concurrent operations: O(m (α(n) + log(1 + n p / m)))
+  The bound is from Jayanti and Tarjan, "A Randomized Concurrent Algorithm
+  for Disjoint Set Union", for randomized linking. Linking by id is not
+  randomized, and can build deeper trees on adversarial orders.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace dads::utils {
+
+class concurrent_union_find {
+ private:
+  std::unique_ptr<std::atomic<int>[]> parent;
+  std::size_t _size{0};
+
+ public:
+  concurrent_union_find() = default;
+  // every element starts out in a set of its own
+  explicit concurrent_union_find(std::size_t n)
+      : parent(std::make_unique<std::atomic<int>[]>(n)), _size(n) {
+    for (std::size_t i = 0; i < n; i++) {
+      parent[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  std::size_t size() const { return _size; }
+
+  // the root of the set x is in, the smallest element of it
+  int find(int x) {
+    while (true) {
+      int p = parent[x].load(std::memory_order_relaxed);
+      const int gp = parent[p].load(std::memory_order_relaxed);
+      if (p == gp) {
+        return p;
+      }
+      // skip p, if nobody has moved x in the meantime
+      parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+      x = gp;
+    }
+  }
+
+  // the parent of x, without walking further. x is a root if it is its own
+  // parent
+  int parent_of(int x) const {
+    return parent[x].load(std::memory_order_relaxed);
+  }
+
+  // joins the sets of a and b, returns false if they already were the same
+  bool unite(int a, int b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      // a is the bigger root, it only becomes a child if it still is a root
+      int root = a;
+      if (parent[a].compare_exchange_strong(root, b,
+                                            std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  // true if a and b are in the same set. the answer is only stable once no
+  // other thread is uniting the sets
+  bool same(int a, int b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b) {
+        return true;
+      }
+      // if a is still a root, b was not in its set when we looked
+      if (parent[a].load(std::memory_order_relaxed) == a) {
+        return false;
+      }
+    }
+  }
+
+  // points the elements in [first, last) straight at their roots. threads can
+  // compress different ranges at once, but not while any of them unite sets
+  void compress(std::size_t first = 0,
+                std::size_t last = static_cast<std::size_t>(-1)) {
+    if (last > _size) {
+      last = _size;
+    }
+    for (std::size_t x = first; x < last; x++) {
+      parent[x].store(find(x), std::memory_order_relaxed);
+    }
+  }
+};
+
+}  // namespace dads::utils
+
+#endif
@@ -1,15 +1,22 @@
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <random>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <algorithms/breadth_first_search.hpp>
+#include <data-structures/csr_graph.hpp>
 #include <data-structures/graph.hpp>
 
 using dads::graphs::adjacency_list;
+using dads::graphs::adjacency_matrix;
+using dads::graphs::csr_graph;
 using dads::graphs::graph;
 
 namespace {
@@ -36,4 +43,157 @@ TEST_F(BFSSearchableGraph, CanFindShortestReach) {  // NOLINT
   // ASSERT_EQ(G->weight(0, u), 5);
 }
 
+TEST_F(BFSSearchableGraph, ShortestReachSumsEdgeWeights) {  // NOLINT
+  G->add_bi_edge(0, 1, 5);
+  G->add_edge(1, 4, 2);
+  G->add_edge(4, 7, 3);
+
+  auto r = dads::graphs::bfs_shortest_reach(*G, 1);
+
+  ASSERT_EQ(r[0], 5);
+  ASSERT_EQ(r[4], 2);
+  ASSERT_EQ(r[7], 5);
+}
+
+TEST_F(BFSSearchableGraph, DenseIdsGiveFlatDistances) {  // NOLINT
+  G->add_bi_edge(0, 1, 5);
+  G->add_edge(1, 2, 2);
+  G->add_edge(4, 3, 1);
+  ASSERT_EQ(G->id_bound(), 5);
+
+  auto d = dads::graphs::bfs_distances(*G, 0);
+
+  ASSERT_EQ(d, std::vector<int>({0, 5, 7, dads::graphs::unreachable,
+                                 dads::graphs::unreachable}));
+}
+
+TEST_F(BFSSearchableGraph, CanBeGivenTheIdBound) {  // NOLINT
+  G->add_bi_edge(0, 1, 5);
+
+  auto d = dads::graphs::bfs_distances(*G, 0, 10);
+  ASSERT_EQ(d.size(), 10);
+  ASSERT_EQ(d[1], 5);
+}
+
+TEST_F(BFSSearchableGraph, VisitorCanStopTheSearch) {  // NOLINT
+  for (int i = 0; i < 10; i++) {
+    G->add_edge(i, i + 1, 1);
+  }
+
+  std::vector<int> visited;
+  const bool stopped = dads::graphs::breadth_first_search(
+      *G, 0, [&visited](int /*parent*/, int node) {
+        visited.push_back(node);
+        return node == 3 ? dads::graphs::visit_control::stop
+                         : dads::graphs::visit_control::proceed;
+      });
+
+  ASSERT_TRUE(stopped);
+  ASSERT_EQ(visited, std::vector<int>({1, 2, 3}));
+  ASSERT_FALSE(dads::graphs::breadth_first_search(
+      *G, 0, [](int /*parent*/, int /*node*/) {}));
+}
+
+TEST_F(BFSSearchableGraph, VisitorCanPruneTheSearch) {  // NOLINT
+  G->add_edge(0, 1, 1);
+  G->add_edge(0, 2, 1);
+  G->add_edge(1, 3, 1);
+  G->add_edge(2, 4, 1);
+  G->add_edge(4, 3, 1);
+
+  std::vector<int> visited;
+  dads::graphs::breadth_first_search(
+      *G, 0, [&visited](int /*parent*/, int node, int /*weight*/) {
+        visited.push_back(node);
+        return node == 1 ? dads::graphs::visit_control::prune
+                         : dads::graphs::visit_control::proceed;
+      });
+
+  // 3 is only reached through 4, since the search does not go past 1
+  std::sort(std::begin(visited), std::end(visited));
+  ASSERT_EQ(visited, std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST_F(BFSSearchableGraph, BidirectionalSearchFindsTheFewestHops) {  // NOLINT
+  constexpr int n = 300;
+  std::mt19937 rng(n);
+  std::uniform_int_distribution<int> pick(0, n - 1);
+  G->keep_in_edges();
+  for (int i = 0; i < 2 * n; i++) {
+    G->add_edge(pick(rng), pick(rng), 1);
+  }
+
+  for (int source = 0; source < n; source += 7) {
+    std::unordered_map<int, int> hops;
+    hops[source] = 0;
+    dads::graphs::breadth_first_search(
+        *G, source,
+        [&hops](int parent, int node) { hops[node] = hops[parent] + 1; });
+
+    for (int target = 0; target < n; target += 3) {
+      const auto r = dads::graphs::bidirectional_bfs(*G, source, target);
+      const auto it = hops.find(target);
+      if (it == hops.end()) {
+        ASSERT_EQ(r.hops, dads::graphs::unreachable);
+        ASSERT_TRUE(r.path.empty());
+        continue;
+      }
+
+      ASSERT_EQ(r.hops, it->second);
+      // the path has that many edges, and they are all in the graph
+      ASSERT_EQ(r.path.size(), r.hops + 1);
+      ASSERT_EQ(r.path.front(), source);
+      ASSERT_EQ(r.path.back(), target);
+      for (std::size_t j = 0; j + 1 < r.path.size(); j++) {
+        const auto ns = G->neighbours(r.path[j]);
+        ASSERT_NE(std::find(std::begin(ns), std::end(ns), r.path[j + 1]),
+                  std::end(ns));
+      }
+    }
+  }
+}
+
+TEST_F(BFSSearchableGraph, BidirectionalSearchCanBeBounded) {  // NOLINT
+  for (int i = 0; i < 10; i++) {
+    G->add_edge(i, i + 1, 1);
+  }
+  G->keep_in_edges();
+
+  ASSERT_EQ(dads::graphs::bidirectional_bfs(*G, 0, 10).hops, 10);
+  ASSERT_EQ(dads::graphs::bidirectional_bfs(*G, 0, 10, 10).hops, 10);
+  ASSERT_EQ(dads::graphs::bidirectional_bfs(*G, 0, 10, 9).hops,
+            dads::graphs::unreachable);
+  ASSERT_EQ(dads::graphs::bidirectional_bfs(*G, 10, 0).hops,
+            dads::graphs::unreachable);
+
+  const auto r = dads::graphs::bidirectional_bfs(*G, 2, 5, 100, false);
+  ASSERT_EQ(r.hops, 3);
+  ASSERT_TRUE(r.path.empty());
+
+  const auto same = dads::graphs::bidirectional_bfs(*G, 4, 4);
+  ASSERT_EQ(same.hops, 0);
+  ASSERT_EQ(same.path, std::vector<int>({4}));
+
+  const auto next = dads::graphs::bidirectional_bfs(*G, 4, 5);
+  ASSERT_EQ(next.path, std::vector<int>({4, 5}));
+}
+
+TEST(BidirectionalBFS, WorksOnEveryStore) {  // NOLINT
+  const std::vector<std::tuple<int, int, int>> edges = {
+      {0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {0, 4, 1}, {4, 3, 1}, {3, 5, 1}};
+
+  graph<adjacency_matrix<6>> matrix;
+  matrix.add_edges(edges);
+  const auto m = dads::graphs::bidirectional_bfs(matrix, 0, 5);
+  ASSERT_EQ(m.hops, 3);
+  ASSERT_EQ(m.path, std::vector<int>({0, 4, 3, 5}));
+
+  // stores without in-edges are searched backward in a reversed copy
+  graph<csr_graph> csr{csr_graph(edges)};
+  const auto reverse = dads::graphs::transpose(csr);
+  const auto c = dads::graphs::bidirectional_bfs(csr, *reverse, 0, 5);
+  ASSERT_EQ(c.hops, 3);
+  ASSERT_EQ(c.path, std::vector<int>({0, 4, 3, 5}));
+}
+
 }  // namespace
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <algorithms/connected_components.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::adjacency_matrix;
+using dads::graphs::any_node_store;
+using dads::graphs::connected_components;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+using dads::graphs::strongly_connected_components;
+using dads::utils::thread_pool;
+
+namespace {
+
+class ConnectedComponents : public ::testing::Test {
+ protected:
+  std::unique_ptr<graph<adjacency_list>> G;
+  std::unique_ptr<thread_pool> pool;
+  void SetUp() override {
+    G = std::make_unique<graph<adjacency_list>>();
+    pool = std::make_unique<thread_pool>(4);
+  }
+
+  // the components, as the smallest node reachable when the edges are
+  // undirected, found one search at a time
+  std::vector<int> expected(int n) {
+    graph<adjacency_list> undirected;
+    for (const int u : G->nodes()) {
+      for (const auto e : G->edges(u)) {
+        undirected.add_bi_edge(u, e.node, 1);
+      }
+    }
+
+    std::vector<int> component(n, -1);
+    for (int s = 0; s < n; s++) {
+      if (component[s] != -1) {
+        continue;
+      }
+      component[s] = s;
+      dads::graphs::breadth_first_search(
+          undirected, s,
+          [&component, s](int /*parent*/, int node) { component[node] = s; });
+    }
+    return component;
+  }
+};
+
+TEST_F(ConnectedComponents, CanFindComponents) {  // NOLINT
+  G->add_bi_edge(0, 1, 1);
+  G->add_bi_edge(1, 2, 1);
+  G->add_bi_edge(4, 5, 1);
+  G->add_edge(7, 6, 1);
+
+  const auto c = connected_components(*G, *pool);
+  ASSERT_EQ(c, std::vector<int>({0, 0, 0, 3, 4, 4, 6, 6}));
+}
+
+TEST_F(ConnectedComponents, MatchesSearchingFromEveryNode) {  // NOLINT
+  // a few big components, some small ones, and edges in one direction
+  constexpr int n = 5000;
+  std::mt19937 rng(n);
+  std::uniform_int_distribution<int> pick(0, n - 1);
+  for (int i = 0; i < n; i++) {
+    const int u = pick(rng);
+    const int v = pick(rng);
+    if (u % 5 == v % 5) {
+      G->add_edge(u, v, 1);
+    }
+  }
+  G->add_edge(n - 1, n - 1, 1);
+
+  ASSERT_EQ(connected_components(*G, *pool), expected(n));
+  thread_pool one(1);
+  ASSERT_EQ(connected_components(*G, one), expected(n));
+}
+
+TEST_F(ConnectedComponents, CanSkipTheBigComponent) {  // NOLINT
+  // one big component in a symmetric graph, and a few stragglers
+  constexpr int n = 3000;
+  for (int u = 0; u + 1 < n - 10; u++) {
+    G->add_bi_edge(u, u + 1, 1);
+    G->add_bi_edge(u, (u * 7) % (n - 10), 1);
+  }
+  for (int u = n - 10; u + 1 < n; u += 2) {
+    G->add_bi_edge(u, u + 1, 1);
+  }
+
+  ASSERT_EQ(connected_components(*G, *pool, true), expected(n));
+  ASSERT_EQ(connected_components(*G, true), expected(n));
+}
+
+TEST_F(ConnectedComponents, WorksOnEveryStore) {  // NOLINT
+  const std::vector<std::tuple<int, int, int>> edges = {
+      {0, 1, 1}, {2, 3, 1}, {3, 4, 1}, {5, 4, 1}};
+  const std::vector<int> components = {0, 0, 2, 2, 2, 2};
+
+  graph<csr_graph> csr{csr_graph(edges)};
+  ASSERT_EQ(connected_components(csr, *pool), components);
+
+  graph<adjacency_matrix<6>> matrix;
+  matrix.add_edges(edges);
+  ASSERT_EQ(connected_components(matrix, *pool), components);
+
+  graph<any_node_store> any{any_node_store(adjacency_list())};
+  any.add_edges(edges);
+  ASSERT_EQ(connected_components(any, *pool), components);
+}
+
+TEST_F(ConnectedComponents, RefusesNegativeNodes) {  // NOLINT
+  G->add_edge(-1, 2, 1);
+  ASSERT_THROW(connected_components(*G, *pool), std::invalid_argument);
+}
+
+TEST(StronglyConnectedComponents, CanFindComponents) {  // NOLINT
+  graph<adjacency_list> G;
+  // 0 -> {1, 2} -> 3 <-> 4, and 5 on its own
+  G.add_edge(0, 1, 1);
+  G.add_edge(1, 2, 1);
+  G.add_edge(2, 1, 1);
+  G.add_edge(2, 3, 1);
+  G.add_edge(3, 4, 1);
+  G.add_edge(4, 3, 1);
+  G.add_edge(5, 5, 1);
+
+  const auto c = strongly_connected_components(G);
+  ASSERT_EQ(c.size(), 6);
+  ASSERT_EQ(c[1], c[2]);
+  ASSERT_EQ(c[3], c[4]);
+  ASSERT_EQ(std::set<int>(std::begin(c), std::end(c)).size(), 4);
+
+  // edges go from higher numbers to lower ones
+  ASSERT_GT(c[0], c[1]);
+  ASSERT_GT(c[2], c[3]);
+}
+
+TEST(StronglyConnectedComponents, HandlesLongPaths) {  // NOLINT
+  // deep enough to overflow the stack of a recursive search
+  constexpr int n = 1000000;
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int u = 0; u + 1 < n; u++) {
+    edges.emplace_back(u, u + 1, 1);
+  }
+  edges.emplace_back(n - 1, n / 2, 1);
+  graph<csr_graph> G{csr_graph(edges)};
+
+  const auto c = strongly_connected_components(G);
+  // the second half is one cycle, the first half is a path into it
+  ASSERT_EQ(c[n / 2], 0);
+  ASSERT_EQ(c[n - 1], 0);
+  ASSERT_EQ(c[n / 2 - 1], 1);
+  ASSERT_EQ(c[0], n / 2);
+}
+
+TEST(StronglyConnectedComponents, WorksOnTypeErasedStores) {  // NOLINT
+  graph<any_node_store> G{any_node_store(adjacency_matrix<4>())};
+  G.add_edge(0, 1, 1);
+  G.add_edge(1, 0, 1);
+  G.add_edge(1, 2, 1);
+
+  const auto c = strongly_connected_components(G);
+  ASSERT_EQ(c[0], c[1]);
+  ASSERT_NE(c[1], c[2]);
+  ASSERT_NE(c[2], c[3]);
+}
+
+}  // namespace
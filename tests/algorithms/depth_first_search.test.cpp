@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -49,4 +51,53 @@ TEST_F(DFSSearchableGraph, DFSCanFindShortestReach) {  // NOLINT
   // ASSERT_EQ(G->weight(0, u), 5);
 }
 
+TEST_F(DFSSearchableGraph, DenseIdsGiveFlatDistances) {  // NOLINT
+  G->add_bi_edge(0, 1, 5);
+  G->add_edge(1, 2, 2);
+  G->add_edge(4, 3, 1);
+
+  auto d = dads::graphs::dfs_distances(*G, 0);
+
+  ASSERT_EQ(d[0], 0);
+  ASSERT_EQ(d[1], 5);
+  ASSERT_EQ(d[2], 7);
+  ASSERT_EQ(d[3], std::numeric_limits<int>::max());
+}
+
+TEST_F(DFSSearchableGraph, VisitorCanStopTheSearch) {  // NOLINT
+  for (int i = 0; i < 10; i++) {
+    G->add_edge(i, i + 1, 1);
+  }
+
+  std::vector<int> visited;
+  const bool stopped = dads::graphs::depth_first_search(
+      *G, 0, [&visited](int /*parent*/, int node) {
+        visited.push_back(node);
+        return node == 3 ? dads::graphs::visit_control::stop
+                         : dads::graphs::visit_control::proceed;
+      });
+
+  ASSERT_TRUE(stopped);
+  ASSERT_EQ(visited, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST_F(DFSSearchableGraph, VisitorCanPruneTheSearch) {  // NOLINT
+  G->add_edge(0, 1, 1);
+  G->add_edge(1, 2, 1);
+  G->add_edge(0, 3, 1);
+  G->add_edge(3, 4, 1);
+
+  std::vector<int> visited;
+  const bool stopped = dads::graphs::depth_first_search(
+      *G, 0, [&visited](int /*parent*/, int node) {
+        visited.push_back(node);
+        return node == 1 or node == 3 ? dads::graphs::visit_control::prune
+                                      : dads::graphs::visit_control::proceed;
+      });
+
+  ASSERT_FALSE(stopped);
+  std::sort(std::begin(visited), std::end(visited));
+  ASSERT_EQ(visited, std::vector<int>({0, 1, 3}));
+}
+
 }  // namespace
@@ -1,16 +1,27 @@
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <algorithms/graph_utils.hpp>
+#include <data-structures/csr_graph.hpp>
 #include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
 
 using dads::graphs::adjacency_list;
+using dads::graphs::csr_graph;
 using dads::graphs::graph;
+using dads::graphs::parse_edges;
+using edge_list = std::vector<std::tuple<int, int, int>>;
 
 namespace {
 
@@ -58,4 +69,146 @@ TEST_F(SomeGraph, GraphConversionsAreInverses) {  // NOLINT
   ASSERT_EQ(G->nodes(), new_G->nodes());
 }
 
+TEST(ParseEdges, AcceptsLinesAndSeparators) {  // NOLINT
+  const edge_list expected{{0, 1, 1}, {1, 2, -3}, {20, 10, 7}};
+
+  ASSERT_EQ(parse_edges("0,1,1 1,2,-3 20,10,7"), expected);
+  ASSERT_EQ(parse_edges("0,1,1\n1,2,-3\n20,10,7\n"), expected);
+  ASSERT_EQ(parse_edges("0,1,1\r\n1,2,-3\r\n20,10,7"), expected);
+  ASSERT_EQ(parse_edges("0,1,1;1,2,-3;20,10,7;", ';'), expected);
+  ASSERT_EQ(parse_edges("  0,1,1 \n\n 1,2,-3  20,10,7  "), expected);
+  ASSERT_TRUE(parse_edges("").empty());
+}
+
+TEST(ParseEdges, RefusesMalformedRecords) {  // NOLINT
+  ASSERT_THROW(parse_edges("0,1"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,1,1 0,x,1"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,1,1,1"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0;1;1"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,1,99999999999"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,1,000099999999999"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,1,2147483648"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,+,1"), std::invalid_argument);
+  ASSERT_THROW(parse_edges("0,+-1,1"), std::invalid_argument);
+}
+
+TEST(ParseEdges, TakesSignsAndLeadingZeros) {  // NOLINT
+  // like std::stoi does
+  const edge_list expected = {{0, 5, -7}, {2147483647, -2147483648, 0}};
+  ASSERT_EQ(parse_edges("+0,00000000005,-007 "
+                        "0002147483647,-2147483648,-0000000000000"),
+            expected);
+}
+
+TEST(ParseEdges, ChunksKeepTheOrderOfTheRecords) {  // NOLINT
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> pick(0, 100000);
+  edge_list expected;
+  std::string csv;
+  for (int i = 0; i < 20000; i++) {
+    expected.emplace_back(pick(rng), pick(rng), pick(rng) - 50000);
+    const auto &[u, v, w] = expected.back();
+    csv += std::to_string(u) + "," + std::to_string(v) + "," +
+           std::to_string(w) + (i % 3 == 0 ? "\n" : " ");
+  }
+
+  dads::utils::thread_pool pool(4);
+  for (const std::size_t chunk : {1, 7, 100, 4096, 1 << 20}) {
+    ASSERT_EQ(parse_edges(csv, ' ', pool, chunk), expected);
+  }
+}
+
+TEST(ParseEdges, ChunksCanBeWalkedAsOneRange) {  // NOLINT
+  // chunks of one byte are mostly empty, and have to be skipped
+  const std::string csv = "0,1,1 1,2,-3  20,10,7 1,2,4";
+  dads::utils::thread_pool pool(4);
+  for (const std::size_t chunk : {1, 4, 1 << 20}) {
+    const auto chunks = dads::graphs::parse_edge_chunks(csv, ' ', pool, chunk);
+    const dads::graphs::chunked_edges records(chunks);
+    ASSERT_EQ(edge_list(records.begin(), records.end()), parse_edges(csv));
+
+    // the last of the repeated edges wins, like adding them one at a time
+    graph<adjacency_list> G;
+    G.add_edges(records, pool);
+    ASSERT_EQ(G.weight(1, 2), 4);
+    ASSERT_EQ(G.weight(20, 10), 7);
+  }
+}
+
+TEST(ParseEdges, BuildsGraphsInOneGo) {  // NOLINT
+  std::string graph_str = "0,1,1 0,2,1 1,3,2 1,4,2 2,5,2 2,6,2 0,2,5";
+  auto csr = dads::graphs::from_csv<graph<csr_graph>>(graph_str);
+  auto list = dads::graphs::from_csv<graph<adjacency_list>>(graph_str);
+
+  ASSERT_EQ(dads::graphs::to_csv(*csr), dads::graphs::to_csv(*list));
+  ASSERT_EQ(csr->weight(0, 2), 5);
+}
+
+TEST(WriteCsv, WritesToAnySink) {  // NOLINT
+  std::string graph_str = "0,1,1 0,2,1 1,3,2 1,4,2 2,5,2 2,6,2";
+  auto G = dads::graphs::from_csv<graph<adjacency_list>>(graph_str);
+
+  std::string text;
+  dads::graphs::write_csv(*G, [&text](const char *data, std::size_t size) {
+    text.append(data, size);
+  });
+  ASSERT_EQ(text, graph_str);
+
+  std::ostringstream out;
+  dads::graphs::write_csv(*G, dads::graphs::ostream_sink{out}, '\n');
+  ASSERT_EQ(dads::graphs::parse_edges(out.str()),
+            dads::graphs::parse_edges(graph_str));
+}
+
+TEST(WriteCsv, CanLeaveTheEdgesUnsorted) {  // NOLINT
+  std::string graph_str = "3,1,1 0,2,1 1,3,2 3,0,7 1,4,2 2,5,2";
+  auto G = dads::graphs::from_csv<graph<adjacency_list>>(graph_str);
+
+  std::string text;
+  dads::graphs::write_csv(*G, dads::graphs::string_sink{text}, ' ',
+                          dads::graphs::csv_order::unsorted);
+  auto edges = dads::graphs::parse_edges(text);
+  auto expected = dads::graphs::parse_edges(graph_str);
+  std::sort(std::begin(edges), std::end(edges));
+  std::sort(std::begin(expected), std::end(expected));
+  ASSERT_EQ(edges, expected);
+}
+
+TEST(WriteCsv, ParallelOutputMatches) {  // NOLINT
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> pick(0, 5000);
+  graph<adjacency_list> G;
+  for (int i = 0; i < 20000; i++) {
+    G.add_edge(pick(rng), pick(rng), pick(rng) - 2500);
+  }
+
+  const std::string expected = dads::graphs::to_csv(G);
+  dads::utils::thread_pool pool(4);
+  for (const std::size_t nodes_per_range : {1, 3, 100, 1 << 14}) {
+    std::string text;
+    dads::graphs::parallel_write_csv(G, dads::graphs::string_sink{text}, ' ',
+                                     dads::graphs::csv_order::sorted, pool,
+                                     nodes_per_range);
+    ASSERT_EQ(text, expected);
+  }
+
+  std::string empty;
+  dads::graphs::parallel_write_csv(graph<adjacency_list>(),
+                                   dads::graphs::string_sink{empty});
+  ASSERT_TRUE(empty.empty());
+}
+
+TEST(WriteCsv, CanWriteToFiles) {  // NOLINT
+  std::string graph_str = "0,1,-1 0,2,2147483647 1,3,-2147483648";
+  auto G = dads::graphs::from_csv<graph<adjacency_list>>(graph_str);
+
+  std::FILE *file = std::tmpfile();
+  dads::graphs::write_csv(*G, dads::graphs::fd_sink{fileno(file)});
+  std::rewind(file);
+  char text[128] = {};
+  std::fread(text, 1, sizeof(text) - 1, file);
+  std::fclose(file);
+  ASSERT_EQ(std::string(text), graph_str);
+}
+
 }  // namespace
@@ -3,9 +3,11 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <unordered_map>
 
 #include <gtest/gtest.h>
 
+#include <algorithms/breadth_first_search.hpp>
 #include <algorithms/depth_first_search.hpp>
 #include <algorithms/iterative_deepening_search.hpp>
 #include <data-structures/graph.hpp>
@@ -53,4 +55,112 @@ TEST_F(IDSSearchableGraph, IDSCanFindShortestReach) {  // NOLINT
   // ASSERT_EQ(G->weight(0, u), 5);
 }
 
+TEST_F(IDSSearchableGraph, StopsAtTheGoal) {  // NOLINT
+  // a path to the goal, and a wide fan next to it that the search would
+  // otherwise walk through every round
+  G->add_edge(0, 1, 1);
+  G->add_edge(1, 2, 1);
+  for (int i = 0; i < 100; i++) {
+    G->add_edge(2, 100 + i, 1);
+  }
+  G->add_edge(0, 3, 1);
+
+  int visited = 0;
+  const bool found = dads::graphs::iterative_deepening_bfs(
+      *G, 0, 2, 10, [&visited](int /*parent*/, int /*node*/) { visited++; });
+
+  ASSERT_TRUE(found);
+  // none of the fan is visited, the goal ends the search
+  ASSERT_LE(visited, 1 + 3 + 3);
+}
+
+TEST_F(IDSSearchableGraph, VisitorCanStopTheSearch) {  // NOLINT
+  G->add_edge(0, 1, 1);
+  G->add_edge(1, 2, 1);
+
+  int visited = 0;
+  const bool found = dads::graphs::iterative_deepening_bfs(
+      *G, 0, 2, 10, [&visited](int /*parent*/, int node) {
+        visited++;
+        return node == 1 ? dads::graphs::visit_control::stop
+                         : dads::graphs::visit_control::proceed;
+      });
+
+  ASSERT_FALSE(found);
+  // the source, and then 1, every node is only visited once
+  ASSERT_EQ(visited, 2);
+}
+
+TEST_F(IDSSearchableGraph, ReportsAMissingGoal) {  // NOLINT
+  G->add_edge(0, 1, 1);
+  G->add_edge(1, 2, 1);
+
+  ASSERT_FALSE(dads::graphs::iterative_deepening_bfs(
+      *G, 0, 2, 1, [](int /*parent*/, int /*node*/) {}));
+  ASSERT_FALSE(dads::graphs::iterative_deepening_bfs(
+      *G, 0, 7, 10, [](int /*parent*/, int /*node*/) {}));
+}
+
+TEST_F(IDSSearchableGraph, DoesNotMissShorterPaths) {  // NOLINT
+  // 3 is two edges away through 2, and four through 1, 4, and 2, whichever
+  // one the search tries first
+  G->add_edge(0, 1, 1);
+  G->add_edge(1, 4, 1);
+  G->add_edge(4, 2, 1);
+  G->add_edge(0, 2, 1);
+  G->add_edge(2, 3, 1);
+
+  ASSERT_TRUE(dads::graphs::iterative_deepening_bfs(
+      *G, 0, 3, 2, [](int /*parent*/, int /*node*/) {}));
+}
+
+TEST_F(IDSSearchableGraph, RecordsTheDepthOfEveryNode) {  // NOLINT
+  // a few levels of a tree, with shortcuts to deeper levels
+  for (int u = 0; u < 40; u++) {
+    G->add_edge(u, 2 * u + 1, 1);
+    G->add_edge(u, 2 * u + 2, 1);
+  }
+  G->add_edge(1, 30, 1);
+  G->add_edge(30, 5, 1);
+
+  const auto hops = [this](int n) {
+    std::unordered_map<int, int> h;
+    h[0] = 0;
+    dads::graphs::breadth_first_search(
+        *G, 0, [&h](int parent, int node) { h[node] = h[parent] + 1; });
+    return h.count(n) ? h[n] : -1;
+  };
+
+  dads::graphs::iterative_deepening<graph<adjacency_list>> search(*G, 0);
+  for (const int step : {1, 3}) {
+    int visited = 0;
+    const auto count = [&visited](int /*parent*/, int /*node*/) { visited++; };
+    for (int depth = 0; !search.exhausted(); depth += step) {
+      ASSERT_FALSE(search.deepen(depth, count));
+    }
+
+    for (int n = 0; n < 90; n++) {
+      ASSERT_EQ(search.depth(n), hops(n));
+    }
+    if (step == 1) {
+      // one level at a time, every node is visited once
+      ASSERT_EQ(visited, 81);
+    }
+    search.reset(0);
+  }
+}
+
+TEST_F(IDSSearchableGraph, WorksWithSparseIds) {  // NOLINT
+  G->add_edge(-5, 1000000, 1);
+  G->add_edge(1000000, -7, 1);
+
+  dads::graphs::iterative_deepening<graph<adjacency_list>> search(*G, -5);
+  search.deepen(1, [](int /*parent*/, int /*node*/) {});
+  ASSERT_EQ(search.depth(1000000), 1);
+  ASSERT_EQ(search.depth(-7), -1);
+  search.deepen(2, [](int /*parent*/, int /*node*/) {});
+  ASSERT_EQ(search.depth(-7), 2);
+  ASSERT_EQ(search.searched_to(), 2);
+}
+
 }  // namespace
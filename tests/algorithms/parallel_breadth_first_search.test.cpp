@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <algorithms/parallel_breadth_first_search.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::graph;
+using dads::utils::thread_pool;
+
+namespace {
+
+class ParallelBFSSearchableGraph : public ::testing::Test {
+ protected:
+  std::unique_ptr<graph<adjacency_list>> G;
+  std::unique_ptr<thread_pool> pool;
+  void SetUp() override {
+    G = std::make_unique<graph<adjacency_list>>();
+    // the bottom-up steps walk the in-edges
+    G->keep_in_edges();
+    pool = std::make_unique<thread_pool>(4);
+  }
+
+  // the number of edges from the source, found with the sequential search
+  std::unordered_map<int, int> hops(int source) {
+    std::unordered_map<int, int> h;
+    h[source] = 0;
+    dads::graphs::breadth_first_search(
+        *G, source, [&h](int parent, int node) { h[node] = h[parent] + 1; });
+    return h;
+  }
+
+  void expect_valid_tree(const dads::graphs::bfs_tree &tree, int source) {
+    const auto expected = hops(source);
+
+    for (int v = 0; v < static_cast<int>(tree.level.size()); v++) {
+      auto it = expected.find(v);
+      if (it == expected.end()) {
+        ASSERT_EQ(tree.level[v], -1);
+        ASSERT_EQ(tree.parent[v], -1);
+        continue;
+      }
+
+      ASSERT_EQ(tree.level[v], it->second);
+      if (v == source) {
+        ASSERT_EQ(tree.parent[v], source);
+      } else {
+        // the parent is one level up, and has an edge to the node
+        const int p = tree.parent[v];
+        ASSERT_EQ(tree.level[p], tree.level[v] - 1);
+        const auto ns = G->neighbours(p);
+        ASSERT_NE(std::find(std::begin(ns), std::end(ns), v), std::end(ns));
+      }
+    }
+  }
+};
+
+TEST_F(ParallelBFSSearchableGraph, FindsLevelsOfSmallGraph) {  // NOLINT
+  G->add_bi_edge(0, 1, 1);
+  G->add_bi_edge(1, 2, 1);
+  G->add_bi_edge(2, 3, 1);
+  G->add_bi_edge(0, 4, 1);
+  G->add_edge(4, 3, 1);
+  G->add_edge(6, 5, 1);
+
+  auto tree = dads::graphs::direction_optimizing_bfs(*G, 0, *pool);
+
+  ASSERT_EQ(tree.level, std::vector<int>({0, 1, 2, 2, 1, -1, -1}));
+  expect_valid_tree(tree, 0);
+}
+
+TEST_F(ParallelBFSSearchableGraph, MatchesSequentialOnRandomGraph) {  // NOLINT
+  // dense enough that the search switches to bottom-up and back
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> pick(0, 4999);
+  for (int i = 0; i < 40000; i++) {
+    G->add_bi_edge(pick(rng), pick(rng), 1);
+  }
+
+  for (const int source : {0, 17, 4999}) {
+    expect_valid_tree(dads::graphs::direction_optimizing_bfs(*G, source, *pool),
+                      source);
+  }
+}
+
+TEST_F(ParallelBFSSearchableGraph, MatchesSequentialOnDigraph) {  // NOLINT
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 1999);
+  for (int i = 0; i < 10000; i++) {
+    G->add_edge(pick(rng), pick(rng), 1);
+  }
+
+  expect_valid_tree(dads::graphs::direction_optimizing_bfs(*G, 3, *pool), 3);
+}
+
+TEST_F(ParallelBFSSearchableGraph, VisitsInLevelOrder) {  // NOLINT
+  G->add_bi_edge(0, 1, 5);
+  G->add_bi_edge(1, 2, 6);
+  G->add_bi_edge(0, 3, 7);
+
+  std::vector<int> order;
+  std::vector<int> weights;
+  dads::graphs::parallel_breadth_first_search(
+      *G, 0,
+      [&order, &weights](int /*parent*/, int node, int weight) {
+        order.push_back(node);
+        weights.push_back(weight);
+      },
+      *pool);
+
+  ASSERT_EQ(order.size(), 3);
+  ASSERT_EQ(order.back(), 2);
+  ASSERT_EQ(weights.back(), 6);
+}
+
+TEST_F(ParallelBFSSearchableGraph, VisitorCanStopAndPrune) {  // NOLINT
+  for (int i = 0; i < 10; i++) {
+    G->add_edge(i, i + 1, 1);
+  }
+  G->add_edge(0, 20, 1);
+  G->add_edge(20, 21, 1);
+
+  std::vector<int> visited;
+  const bool stopped = dads::graphs::parallel_breadth_first_search(
+      *G, 0,
+      [&visited](int, int node) {
+        visited.push_back(node);
+        return node == 3 ? dads::graphs::visit_control::stop
+                         : dads::graphs::visit_control::proceed;
+      },
+      *pool);
+  // the levels before 3 are 1 and 20, and 2 and 21
+  ASSERT_TRUE(stopped);
+  ASSERT_EQ(visited.back(), 3);
+  ASSERT_EQ(visited.size(), 5);
+
+  // nothing below 2 is visited, the other branch is
+  visited.clear();
+  ASSERT_FALSE(dads::graphs::parallel_breadth_first_search(
+      *G, 0,
+      [&visited](int, int node) {
+        visited.push_back(node);
+        return node == 2 ? dads::graphs::visit_control::prune
+                         : dads::graphs::visit_control::proceed;
+      },
+      *pool));
+  std::sort(std::begin(visited), std::end(visited));
+  ASSERT_EQ(visited, std::vector<int>({1, 2, 20, 21}));
+}
+
+TEST(ParallelBFSCSRGraph, CanSearchCSRGraph) {  // NOLINT
+  dads::graphs::graph<dads::graphs::csr_graph> G{
+      dads::graphs::csr_graph({{0, 1, 1}, {1, 2, 1}, {2, 0, 1}, {2, 3, 1}})};
+
+  // stores without in-edges are searched bottom-up in a reversed copy, which
+  // every search can share
+  thread_pool pool(4);
+  const auto reverse = dads::graphs::transpose(G, pool);
+  auto tree = dads::graphs::direction_optimizing_bfs(G, *reverse, 1, pool);
+  ASSERT_EQ(tree.level, std::vector<int>({2, 0, 1, 2}));
+  tree = dads::graphs::direction_optimizing_bfs(G, *reverse, 3, pool);
+  ASSERT_EQ(tree.level, std::vector<int>({-1, -1, -1, 0}));
+}
+
+}  // namespace
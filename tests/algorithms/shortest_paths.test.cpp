@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <algorithms/shortest_paths.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::dijkstra_heap;
+using dads::graphs::graph;
+using dads::graphs::infinite_distance;
+using dads::utils::thread_pool;
+
+namespace {
+
+class ShortestPathsGraph : public ::testing::Test {
+ protected:
+  std::unique_ptr<graph<adjacency_list>> G;
+  std::unique_ptr<thread_pool> pool;
+  void SetUp() override {
+    G = std::make_unique<graph<adjacency_list>>();
+    pool = std::make_unique<thread_pool>(4);
+  }
+
+  void add_random_edges(int nodes, int edges, int max_weight) {
+    std::mt19937 rng(nodes);
+    std::uniform_int_distribution<int> pick(0, nodes - 1);
+    std::uniform_int_distribution<int> weight(0, max_weight);
+    for (int i = 0; i < edges; i++) {
+      G->add_edge(pick(rng), pick(rng), weight(rng));
+    }
+  }
+
+  // bellman-ford, slow but obviously right
+  std::vector<int64_t> expected(int source) {
+    std::vector<int64_t> d(G->id_bound(), infinite_distance);
+    d[source] = 0;
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (const int u : G->nodes()) {
+        if (d[u] == infinite_distance) {
+          continue;
+        }
+        for (const auto [v, w] : G->edges(u)) {
+          if (d[u] + w < d[v]) {
+            d[v] = d[u] + w;
+            changed = true;
+          }
+        }
+      }
+    }
+    return d;
+  }
+};
+
+TEST_F(ShortestPathsGraph, DijkstraFindsWeightedShortestPaths) {  // NOLINT
+  // the path with fewest edges is not the shortest one
+  G->add_edge(0, 1, 10);
+  G->add_edge(0, 2, 1);
+  G->add_edge(2, 3, 1);
+  G->add_edge(3, 1, 1);
+  G->add_edge(5, 4, 1);
+
+  for (const auto heap : {dijkstra_heap::radix, dijkstra_heap::d_ary}) {
+    auto tree = dads::graphs::dijkstra(*G, 0, heap);
+    ASSERT_EQ(tree.distance, std::vector<int64_t>({0, 3, 1, 2,
+                                                   infinite_distance,
+                                                   infinite_distance}));
+    ASSERT_EQ(tree.parent, std::vector<int>({0, 3, 0, 2, -1, -1}));
+  }
+}
+
+TEST_F(ShortestPathsGraph, EnginesMatchBellmanFord) {  // NOLINT
+  add_random_edges(3000, 15000, 50);
+
+  for (const int source : {0, 123, 2999}) {
+    const auto d = expected(source);
+    ASSERT_EQ(dads::graphs::dijkstra(*G, source).distance, d);
+    ASSERT_EQ(dads::graphs::dijkstra(*G, source, dijkstra_heap::d_ary).distance,
+              d);
+    ASSERT_EQ(dads::graphs::delta_stepping(*G, source, 0, *pool), d);
+    ASSERT_EQ(dads::graphs::delta_stepping(*G, source, 7, *pool), d);
+  }
+}
+
+TEST_F(ShortestPathsGraph, BidirectionalMatchesDijkstra) {  // NOLINT
+  add_random_edges(1000, 4000, 100);
+  const auto reverse = dads::graphs::transpose(*G);
+
+  const auto tree = dads::graphs::dijkstra(*G, 5);
+  for (int target = 0; target < 1000; target += 37) {
+    const auto p =
+        dads::graphs::bidirectional_dijkstra(*G, *reverse, 5, target);
+    ASSERT_EQ(p.distance, tree.distance[target]);
+
+    if (p.distance == infinite_distance) {
+      ASSERT_TRUE(p.path.empty());
+      continue;
+    }
+
+    // the path is made of edges of the graph, and adds up to the distance
+    ASSERT_EQ(p.path.front(), 5);
+    ASSERT_EQ(p.path.back(), target);
+    int64_t length = 0;
+    for (std::size_t i = 0; i + 1 < p.path.size(); i++) {
+      const auto ns = G->neighbours(p.path[i]);
+      ASSERT_NE(std::find(std::begin(ns), std::end(ns), p.path[i + 1]),
+                std::end(ns));
+      length += G->weight(p.path[i], p.path[i + 1]);
+    }
+    ASSERT_EQ(length, p.distance);
+  }
+}
+
+TEST_F(ShortestPathsGraph, BidirectionalHandlesTrivialQueries) {  // NOLINT
+  G->add_edge(0, 1, 4);
+  G->add_edge(2, 3, 4);
+  const auto reverse = dads::graphs::transpose(*G);
+
+  auto same = dads::graphs::bidirectional_dijkstra(*G, *reverse, 1, 1);
+  ASSERT_EQ(same.distance, 0);
+  ASSERT_EQ(same.path, std::vector<int>({1}));
+
+  auto direct = dads::graphs::bidirectional_dijkstra(*G, *reverse, 0, 1);
+  ASSERT_EQ(direct.distance, 4);
+  ASSERT_EQ(direct.path, std::vector<int>({0, 1}));
+
+  auto none = dads::graphs::bidirectional_dijkstra(*G, *reverse, 0, 3);
+  ASSERT_EQ(none.distance, infinite_distance);
+  ASSERT_TRUE(none.path.empty());
+}
+
+TEST_F(ShortestPathsGraph, RejectsNegativeWeights) {  // NOLINT
+  G->add_edge(0, 1, 3);
+  G->add_edge(1, 2, -1);
+
+  ASSERT_THROW(dads::graphs::dijkstra(*G, 0), std::invalid_argument);
+  ASSERT_THROW(dads::graphs::delta_stepping(*G, 0, 0, *pool),
+               std::invalid_argument);
+}
+
+TEST(ShortestPathsCSRGraph, CanSearchCSRGraph) {  // NOLINT
+  graph<dads::graphs::csr_graph> G{
+      dads::graphs::csr_graph({{0, 1, 2}, {1, 2, 2}, {0, 2, 5}, {2, 3, 1}})};
+
+  ASSERT_EQ(dads::graphs::dijkstra(G, 0).distance,
+            std::vector<int64_t>({0, 2, 4, 5}));
+  ASSERT_EQ(dads::graphs::delta_stepping(G, 0),
+            std::vector<int64_t>({0, 2, 4, 5}));
+}
+
+}  // namespace
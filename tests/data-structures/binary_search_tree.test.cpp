@@ -1,14 +1,26 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <data-structures/binary_search_tree.hpp>
+#include <utils/node_allocator.hpp>
 
 using dads::trees::binary_search_tree;
+namespace augment = dads::trees::augment;
+namespace balance = dads::trees::balance;
 
 namespace {
 
@@ -110,6 +122,528 @@ TEST_F(TraversableBinarySearchTree, CanTraversePostorder) {  // NOLINT
   ASSERT_EQ("0214653", s);
 }
 
+TEST_F(TraversableBinarySearchTree, CanRemoveInnerNodes) {  // NOLINT
+  // the root, and both of its children, all have two children
+  ASSERT_TRUE(bst->remove(3));
+  ASSERT_TRUE(bst->remove(1));
+  ASSERT_TRUE(bst->remove(5));
+  ASSERT_EQ(bst->size(), 4);
+
+  std::string s;
+  bst->inorder(
+      [&s](std::tuple<int, int> n) { s += std::to_string(std::get<1>(n)); });
+
+  ASSERT_EQ("0246", s);
+}
+
+TEST_F(TraversableBinarySearchTree, CanRemoveEverything) {  // NOLINT
+  for (int i = 0; i <= 6; i++) {
+    ASSERT_TRUE(bst->remove(i));
+    ASSERT_FALSE(bst->find(i));
+  }
+  ASSERT_EQ(bst->size(), 0);
+  ASSERT_FALSE(bst->min());
+}
+
+TEST_F(TraversableBinarySearchTree, TraversalsHandOutReferences) {  // NOLINT
+  bst->inorder([](const int &k, int &v) { v = 10 * k; });
+  bst->preorder([](auto kv) { std::get<1>(kv) += 1; });
+
+  std::string s;
+  bst->postorder([&s](int k, int v) { s += std::to_string(v - 10 * k); });
+  ASSERT_EQ("1111111", s);
+}
+
+TEST_F(TraversableBinarySearchTree, CanIterate) {  // NOLINT
+  std::string s;
+  for (const auto &[k, v] : *bst) {
+    s += std::to_string(v);
+  }
+  ASSERT_EQ("0123456", s);
+
+  s.clear();
+  for (auto it = bst->end(); it != bst->begin();) {
+    --it;
+    s += std::to_string(it->second);
+  }
+  ASSERT_EQ("6543210", s);
+
+  const auto &const_bst = *bst;
+  ASSERT_EQ(std::distance(const_bst.begin(), const_bst.end()), 7);
+  binary_search_tree<int, int>::const_iterator it = bst->begin();
+  ASSERT_EQ(it, const_bst.cbegin());
+}
+
+TEST_F(TraversableBinarySearchTree, CanFindBounds) {  // NOLINT
+  bst->remove(3);
+
+  ASSERT_EQ(bst->lower_bound(3)->first, 4);
+  ASSERT_EQ(bst->lower_bound(4)->first, 4);
+  ASSERT_EQ(bst->upper_bound(4)->first, 5);
+  ASSERT_EQ(bst->lower_bound(-1), bst->begin());
+  ASSERT_EQ(bst->upper_bound(6), bst->end());
+
+  auto [first, last] = bst->equal_range(2);
+  ASSERT_EQ(first->first, 2);
+  ASSERT_EQ(std::next(first), last);
+
+  auto [missing_first, missing_last] = bst->equal_range(3);
+  ASSERT_EQ(missing_first, missing_last);
+}
+
+TEST_F(TraversableBinarySearchTree, CanScanRange) {  // NOLINT
+  std::string s;
+  bst->range(2, 5, [&s](int k, int &v) {
+    v = -v;
+    s += std::to_string(k);
+  });
+  ASSERT_EQ("234", s);
+  ASSERT_EQ(bst->lower_bound(4)->second, -4);
+
+  s.clear();
+  bst->range(5, 2, [&s](int k, int) { s += std::to_string(k); });
+  bst->range(7, 9, [&s](int k, int) { s += std::to_string(k); });
+  ASSERT_EQ("", s);
+}
+
+TEST_F(TraversableBinarySearchTree, CanScanRangeOfConstTree) {  // NOLINT
+  const auto &const_bst = *bst;
+  std::string s;
+  const_bst.range(2, 5, [&s](int k, const int &v) {
+    s += std::to_string(k) + std::to_string(v);
+  });
+  ASSERT_EQ("223344", s);
+
+  // tuple callbacks, like the other traversals, and keys of another type
+  s.clear();
+  const_bst.range(1.5, 3.5, [&s](std::tuple<const int &, const int &> kv) {
+    s += std::to_string(std::get<0>(kv));
+  });
+  ASSERT_EQ("23", s);
+}
+
+TEST_F(TraversableBinarySearchTree, IteratorsSurviveRemoval) {  // NOLINT
+  auto four = bst->lower_bound(4);
+  auto six = bst->lower_bound(6);
+
+  // 4 is the successor of the root, and takes its place
+  ASSERT_TRUE(bst->remove(3));
+  ASSERT_TRUE(bst->remove(5));
+  ASSERT_EQ(four->first, 4);
+  ASSERT_EQ(six->first, 6);
+  ASSERT_EQ(std::next(four), six);
+  ASSERT_EQ(std::prev(four)->first, 2);
+}
+
+////////////////
+// ALLOCATORS //
+////////////////
+TEST(AllocatorBinarySearchTree, WorksWithHeapAllocator) {  // NOLINT
+  binary_search_tree<int, int, dads::utils::heap_allocator> bst;
+  for (int i = 0; i < 100; i++) {
+    bst.insert((i * 37) % 100, i);
+  }
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_TRUE(bst.remove(i));
+  }
+
+  ASSERT_EQ(bst.size(), 50);
+  ASSERT_TRUE(bst.find(1));
+  ASSERT_FALSE(bst.find(2));
+}
+
+TEST(AllocatorBinarySearchTree, DestroysValues) {  // NOLINT
+  auto value = std::make_shared<int>(42);
+  {
+    binary_search_tree<int, std::shared_ptr<int>> bst;
+    for (int i = 0; i < 1000; i++) {
+      bst.insert(i, value);
+    }
+    bst.remove(500);
+    ASSERT_EQ(value.use_count(), 1000);
+  }
+  ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(AllocatorBinarySearchTree, CanDestroyDegenerateTree) {  // NOLINT
+  // a linked list of strings, which used to be torn down recursively
+  auto bst = std::make_unique<binary_search_tree<int, std::string>>();
+  for (int i = 0; i < 20000; i++) {
+    bst->insert(i, "value");
+  }
+  ASSERT_EQ(bst->height(), 20000);
+  bst.reset();
+}
+
+//////////////
+// BALANCED //
+//////////////
+template <typename Balance>
+class BalancedBinarySearchTree : public ::testing::Test {
+ protected:
+  using tree =
+      binary_search_tree<int, int, dads::utils::pool_allocator, Balance>;
+  std::unique_ptr<tree> bst;
+  void SetUp() override { bst = std::make_unique<tree>(); }
+
+  // the height of the tree, recomputed from its preorder traversal, which
+  // determines the shape of a binary search tree
+  int real_height() {
+    std::vector<int> keys;
+    bst->preorder([&keys](std::tuple<int, int> n) {
+      keys.push_back(std::get<0>(n));
+    });
+    return height_of(keys, 0, keys.size());
+  }
+
+  static int height_of(const std::vector<int> &keys, std::size_t first,
+                       std::size_t last) {
+    if (first == last) {
+      return 0;
+    }
+    std::size_t split = first + 1;
+    while (split < last and keys[split] < keys[first]) {
+      split++;
+    }
+    return 1 + std::max(height_of(keys, first + 1, split),
+                        height_of(keys, split, last));
+  }
+};
+
+using Balances =
+    ::testing::Types<balance::none, balance::avl, balance::red_black>;
+TYPED_TEST_SUITE(BalancedBinarySearchTree, Balances);
+
+TYPED_TEST(BalancedBinarySearchTree, MatchesStdMap) {  // NOLINT
+  std::map<int, int> expected;
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> pick(0, 999);
+
+  for (int i = 0; i < 20000; i++) {
+    const int k = pick(rng);
+    if (rng() % 3 == 0) {
+      ASSERT_EQ(this->bst->remove(k), expected.erase(k) == 1);
+    } else {
+      ASSERT_EQ(this->bst->insert(k, i), expected.emplace(k, i).second);
+    }
+
+    if (i % 1000 == 0) {
+      ASSERT_EQ(this->bst->height(), this->real_height());
+    }
+  }
+
+  ASSERT_EQ(this->bst->size(), static_cast<int>(expected.size()));
+  ASSERT_EQ(this->bst->height(), this->real_height());
+
+  auto it = std::begin(expected);
+  this->bst->inorder([&it](std::tuple<int, int> n) {
+    ASSERT_EQ(std::get<0>(n), it->first);
+    ASSERT_EQ(std::get<1>(n), it->second);
+    ++it;
+  });
+}
+
+TYPED_TEST(BalancedBinarySearchTree, IteratorsMatchStdMap) {  // NOLINT
+  std::map<int, int> expected;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 2000);
+
+  for (int i = 0; i < 5000; i++) {
+    const int k = pick(rng);
+    if (rng() % 3 == 0) {
+      this->bst->remove(k);
+      expected.erase(k);
+    } else {
+      this->bst->insert(k, i);
+      expected.emplace(k, i);
+    }
+  }
+
+  ASSERT_TRUE(std::equal(this->bst->begin(), this->bst->end(),
+                         std::begin(expected), std::end(expected)));
+  ASSERT_TRUE(std::equal(std::make_reverse_iterator(this->bst->end()),
+                         std::make_reverse_iterator(this->bst->begin()),
+                         std::rbegin(expected), std::rend(expected)));
+
+  for (int k = -1; k <= 2001; k++) {
+    const auto lower = this->bst->lower_bound(k);
+    const auto upper = this->bst->upper_bound(k);
+    const auto expected_lower = expected.lower_bound(k);
+    const auto expected_upper = expected.upper_bound(k);
+
+    ASSERT_EQ(lower == this->bst->end(), expected_lower == std::end(expected));
+    ASSERT_EQ(upper == this->bst->end(), expected_upper == std::end(expected));
+    if (lower != this->bst->end()) {
+      ASSERT_EQ(*lower, *expected_lower);
+    }
+    if (upper != this->bst->end()) {
+      ASSERT_EQ(*upper, *expected_upper);
+    }
+  }
+}
+
+TYPED_TEST(BalancedBinarySearchTree, HeightIsKeptUpToDate) {  // NOLINT
+  for (int i = 0; i < 100; i++) {
+    this->bst->insert(i, i);
+    ASSERT_EQ(this->bst->height(), this->real_height());
+  }
+  for (int i = 0; i < 100; i += 3) {
+    this->bst->remove(i);
+    ASSERT_EQ(this->bst->height(), this->real_height());
+  }
+}
+
+TYPED_TEST(BalancedBinarySearchTree, BulkLoadIsPerfectlyBalanced) {  // NOLINT
+  using tree = typename TestFixture::tree;
+
+  for (int n = 0; n < 300; n++) {
+    std::vector<std::pair<int, int>> elements;
+    for (int i = 0; i < n; i++) {
+      elements.emplace_back(2 * i, i);
+    }
+    this->bst = std::make_unique<tree>(
+        dads::trees::sorted_unique, std::begin(elements), std::end(elements));
+
+    ASSERT_EQ(this->bst->size(), n);
+    // the number of bits in n, the height of a complete tree with n nodes
+    int height = 0;
+    while ((1 << height) <= n) {
+      height++;
+    }
+    ASSERT_EQ(this->bst->height(), height);
+    ASSERT_EQ(this->bst->height(), this->real_height());
+
+    auto it = std::begin(elements);
+    this->bst->inorder([&it](std::tuple<int, int> node) {
+      ASSERT_EQ(std::get<0>(node), it->first);
+      ASSERT_EQ(std::get<1>(node), it->second);
+      ++it;
+    });
+  }
+}
+
+TYPED_TEST(BalancedBinarySearchTree, BulkLoadedTreeMatchesStdMap) {  // NOLINT
+  using tree = typename TestFixture::tree;
+
+  std::map<int, int> expected;
+  for (int i = 0; i < 1000; i += 2) {
+    expected.emplace(i, i);
+  }
+  this->bst = std::make_unique<tree>(dads::trees::sorted_unique,
+                                     std::begin(expected), std::end(expected));
+
+  // the tree should keep working, and stay balanced, after it is built
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> pick(0, 999);
+  for (int i = 0; i < 5000; i++) {
+    const int k = pick(rng);
+    if (rng() % 2 == 0) {
+      ASSERT_EQ(this->bst->remove(k), expected.erase(k) == 1);
+    } else {
+      ASSERT_EQ(this->bst->insert(k, i), expected.emplace(k, i).second);
+    }
+  }
+
+  ASSERT_EQ(this->bst->size(), static_cast<int>(expected.size()));
+  ASSERT_EQ(this->bst->height(), this->real_height());
+
+  auto it = std::begin(expected);
+  this->bst->inorder([&it](std::tuple<int, int> n) {
+    ASSERT_EQ(std::get<0>(n), it->first);
+    ASSERT_EQ(std::get<1>(n), it->second);
+    ++it;
+  });
+}
+
+TEST(BulkLoadBinarySearchTree, SortsAndDropsDuplicates) {  // NOLINT
+  const std::vector<std::tuple<int, std::string>> elements = {
+      {5, "five"}, {1, "one"}, {3, "three"}, {1, "uno"}, {4, "four"}};
+  binary_search_tree<int, std::string> bst(std::begin(elements),
+                                           std::end(elements));
+
+  // like insert, the first of the duplicates is kept
+  ASSERT_EQ(bst.size(), 4);
+  ASSERT_EQ(bst.height(), 3);
+  ASSERT_EQ(bst.min(), std::make_tuple(1, std::string("one")));
+  ASSERT_EQ(bst.max(), std::make_tuple(5, std::string("five")));
+}
+
+TEST(BulkLoadBinarySearchTree, DestroysValues) {  // NOLINT
+  auto value = std::make_shared<int>(42);
+  {
+    std::vector<std::pair<int, std::shared_ptr<int>>> elements;
+    for (int i = 0; i < 1000; i++) {
+      elements.emplace_back(i, value);
+    }
+    binary_search_tree<int, std::shared_ptr<int>> bst(
+        dads::trees::sorted_unique,
+        std::make_move_iterator(std::begin(elements)),
+        std::make_move_iterator(std::end(elements)));
+    ASSERT_EQ(value.use_count(), 1001);
+  }
+  ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(BalancedBinarySearchTreeHeight, SortedKeysStayBalanced) {  // NOLINT
+  const int n = 100000;
+  dads::trees::avl_tree<int, int> avl;
+  dads::trees::red_black_tree<int, int> red_black;
+  for (int i = 0; i < n; i++) {
+    avl.insert(i, i);
+    red_black.insert(i, i);
+  }
+
+  // the worst case heights of the two kinds of trees
+  ASSERT_LE(avl.height(), 1.44 * std::log2(n + 2));
+  ASSERT_LE(red_black.height(), 2 * std::log2(n + 1));
+
+  for (int i = 0; i < n; i += 2) {
+    avl.remove(i);
+    red_black.remove(i);
+  }
+  ASSERT_LE(avl.height(), 1.44 * std::log2(n / 2 + 2));
+  ASSERT_LE(red_black.height(), 2 * std::log2(n / 2 + 1));
+  ASSERT_EQ(avl.min(), std::make_tuple(1, 1));
+  ASSERT_EQ(red_black.max(), std::make_tuple(n - 1, n - 1));
+}
+
+///////////////
+// AUGMENTED //
+///////////////
+template <typename Balance>
+class AugmentedBinarySearchTree : public ::testing::Test {
+ protected:
+  using tree =
+      binary_search_tree<int, int, dads::utils::pool_allocator, Balance,
+                         augment::aggregate<augment::sum<long>>>;
+  std::unique_ptr<tree> bst;
+  void SetUp() override { bst = std::make_unique<tree>(); }
+};
+
+TYPED_TEST_SUITE(AugmentedBinarySearchTree, Balances);
+
+TYPED_TEST(AugmentedBinarySearchTree, OrderStatisticsMatchStdMap) {  // NOLINT
+  std::map<int, int> expected;
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<int> pick(0, 999);
+
+  for (int i = 0; i < 20000; i++) {
+    const int k = pick(rng);
+    switch (rng() % 4) {
+      case 0:
+        ASSERT_EQ(this->bst->remove(k), expected.erase(k) == 1);
+        break;
+      case 1:
+        this->bst->insert_or_assign(k, i);
+        expected[k] = i;
+        break;
+      default:
+        ASSERT_EQ(this->bst->insert(k, i), expected.emplace(k, i).second);
+    }
+
+    if (i % 100 == 0) {
+      const int lo = pick(rng);
+      const int hi = pick(rng);
+      const auto first = expected.lower_bound(lo);
+      const auto last = expected.lower_bound(hi);
+
+      ASSERT_EQ(this->bst->rank(lo),
+                std::distance(std::begin(expected), first));
+      const int count = lo < hi ? std::distance(first, last) : 0;
+      ASSERT_EQ(this->bst->count_range(lo, hi), count);
+
+      long sum = 0;
+      for (auto it = first; lo < hi and it != last; ++it) {
+        sum += it->second;
+      }
+      ASSERT_EQ(this->bst->aggregate_range(lo, hi), sum);
+    }
+  }
+
+  int i = 0;
+  for (const auto &[k, v] : expected) {
+    ASSERT_EQ(this->bst->select(i)->first, k);
+    ASSERT_EQ(this->bst->select(i)->second, v);
+    i++;
+  }
+  ASSERT_EQ(this->bst->select(i), std::end(*this->bst));
+  ASSERT_EQ(this->bst->select(-1), std::end(*this->bst));
+}
+
+TYPED_TEST(AugmentedBinarySearchTree, BulkLoadIsAugmented) {  // NOLINT
+  std::vector<std::pair<int, int>> elements;
+  for (int i = 0; i < 1000; i++) {
+    elements.emplace_back(i, 1);
+  }
+  typename TestFixture::tree bst(dads::trees::sorted_unique,
+                                 std::begin(elements), std::end(elements));
+
+  ASSERT_EQ(bst.rank(500), 500);
+  ASSERT_EQ(bst.select(250)->first, 250);
+  ASSERT_EQ(bst.aggregate_range(100, 200), 100);
+  ASSERT_EQ(bst.aggregate_range(-5, 5000), 1000);
+  ASSERT_EQ(bst.aggregate_range(200, 100), 0);
+}
+
+// the values are combined in key order, even when the monoid is not
+// commutative
+struct concat {
+  using value_type = std::string;
+  static std::string identity() { return ""; }
+  static std::string combine(const std::string &a, const std::string &b) {
+    return a + b;
+  }
+};
+
+TEST(AugmentedBinarySearchTrees, CombineInKeyOrder) {  // NOLINT
+  dads::trees::red_black_tree<int, std::string, dads::utils::pool_allocator,
+                              augment::aggregate<concat>>
+      bst;
+  const std::string letters = "thequickbrownfoxjumpsoverthelazydog";
+  std::vector<int> keys(letters.size());
+  std::iota(std::begin(keys), std::end(keys), 0);
+  std::shuffle(std::begin(keys), std::end(keys), std::mt19937(1));
+  for (const int k : keys) {
+    bst.insert(k, std::string(1, letters[k]));
+  }
+
+  ASSERT_EQ(bst.aggregate_range(0, 100), letters);
+  ASSERT_EQ(bst.aggregate_range(3, 8), "quick");
+  ASSERT_EQ(bst.aggregate_range(16, 21), "jumps");
+}
+
+TEST(AugmentedBinarySearchTrees, CanFindMinAndMaxOfRanges) {  // NOLINT
+  dads::trees::avl_tree<int, int, dads::utils::pool_allocator,
+                        augment::aggregate<augment::min<int>>>
+      lowest;
+  dads::trees::avl_tree<int, int, dads::utils::pool_allocator,
+                        augment::aggregate<augment::max<int>>>
+      highest;
+  for (int i = 0; i < 100; i++) {
+    lowest.insert(i, (i * 37) % 101);
+    highest.insert(i, (i * 37) % 101);
+  }
+
+  ASSERT_EQ(lowest.aggregate_range(0, 100), 0);
+  ASSERT_EQ(lowest.aggregate_range(1, 4), 10);
+  ASSERT_EQ(highest.aggregate_range(1, 4), 74);
+  ASSERT_EQ(lowest.aggregate_range(50, 50), std::numeric_limits<int>::max());
+
+  lowest.remove(0);
+  ASSERT_EQ(lowest.aggregate_range(0, 100), 1);
+}
+
+TEST(AugmentedBinarySearchTrees, OrderOnlyTreeRanks) {  // NOLINT
+  binary_search_tree<std::string, int, dads::utils::pool_allocator,
+                     balance::none, augment::order>
+      bst{{"b", 1}, {"d", 2}, {"a", 3}, {"c", 4}};
+
+  ASSERT_EQ(bst.rank("c"), 2);
+  ASSERT_EQ(bst.rank("cc"), 3);
+  ASSERT_EQ(bst.select(3)->first, "d");
+  ASSERT_EQ(bst.count_range("a", "c"), 2);
+}
+
 //////////
 // INTS //
 //////////
@@ -129,7 +663,12 @@ TEST_F(IntBinarySearchTree, CanInsert) {  // NOLINT
 
 TEST_F(IntBinarySearchTree, CanFind) {  // NOLINT
   ASSERT_TRUE(bst->insert(1, 4242));
-  ASSERT_EQ(bst->find(1), 4242);
+  ASSERT_TRUE(bst->find(1));
+  ASSERT_EQ(*bst->find(1), 4242);
+
+  // the value can be changed through find
+  *bst->find(1) = 7;
+  ASSERT_EQ(*bst->find(1), 7);
 }
 
 TEST_F(IntBinarySearchTree, CanRemove) {  // NOLINT
@@ -157,7 +696,93 @@ TEST_F(StringBinarySearchTree, CanInsert) {  // NOLINT
 
 TEST_F(StringBinarySearchTree, CanFind) {  // NOLINT
   ASSERT_TRUE(bst->insert("some key", 4242));
-  ASSERT_EQ(bst->find("some key"), 4242);
+  ASSERT_TRUE(bst->find("some key"));
+  ASSERT_EQ(*bst->find("some key"), 4242);
+}
+
+TEST_F(StringBinarySearchTree, CanFindWithOtherKeyTypes) {  // NOLINT
+  ASSERT_TRUE(bst->insert("b", 2));
+  ASSERT_TRUE(bst->insert("a", 1));
+
+  const std::string_view view = "b";
+  ASSERT_EQ(*bst->find(view), 2);
+  ASSERT_TRUE(bst->contains("a"));
+  ASSERT_FALSE(bst->contains(std::string_view("c")));
+  ASSERT_EQ(bst->lower_bound("aa")->first, "b");
+  ASSERT_TRUE(bst->remove(view));
+  ASSERT_EQ(bst->size(), 1);
+}
+
+TEST_F(StringBinarySearchTree, CanEmplace) {  // NOLINT
+  const auto [it, inserted] = bst->emplace("key", 1);
+  ASSERT_TRUE(inserted);
+  ASSERT_EQ(it->first, "key");
+  ASSERT_EQ(it->second, 1);
+
+  const auto [again, inserted_again] = bst->emplace("key", 2);
+  ASSERT_FALSE(inserted_again);
+  ASSERT_EQ(again, it);
+  ASSERT_EQ(*bst->find("key"), 1);
+}
+
+TEST_F(StringBinarySearchTree, CanInsertOrAssign) {  // NOLINT
+  ASSERT_TRUE(bst->insert_or_assign("key", 1).second);
+  ASSERT_FALSE(bst->insert_or_assign("key", 2).second);
+  ASSERT_EQ(*bst->find("key"), 2);
+  ASSERT_EQ(bst->size(), 1);
+}
+
+// counts the copies and moves made of it
+struct counted {
+  static int copies;
+  static int moves;
+  int value;
+
+  explicit counted(int value) : value(value) {}
+  counted(const counted &o) : value(o.value) { copies++; }
+  counted(counted &&o) noexcept : value(o.value) { moves++; }
+  counted &operator=(const counted &o) {
+    value = o.value;
+    copies++;
+    return *this;
+  }
+  counted &operator=(counted &&o) noexcept {
+    value = o.value;
+    moves++;
+    return *this;
+  }
+};
+int counted::copies = 0;
+int counted::moves = 0;
+
+TEST(CopyFreeBinarySearchTree, DoesNotCopyOnTheHotPath) {  // NOLINT
+  dads::trees::avl_tree<std::string, counted> bst;
+  counted::copies = 0;
+  counted::moves = 0;
+
+  // the value is built in its node, and only when the key is new
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(bst.try_emplace(std::to_string(i), i).second);
+  }
+  ASSERT_FALSE(bst.try_emplace("1", 1000).second);
+  ASSERT_EQ(bst.find("1")->value, 1);
+
+  ASSERT_TRUE(bst.insert_or_assign("1", counted(7)).first != bst.end());
+  ASSERT_EQ(bst.find("1")->value, 7);
+
+  // min and max refer to the elements in the tree
+  ASSERT_EQ(std::get<0>(*bst.min()), "0");
+  ASSERT_EQ(&std::get<1>(*bst.min()), bst.find("0"));
+  std::get<1>(*bst.max()).value = 99;
+  ASSERT_EQ(bst.find("99")->value, 99);
+
+  // removing moves nodes around, not the values in them
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_TRUE(bst.remove(std::to_string(i)));
+  }
+
+  ASSERT_EQ(counted::copies, 0);
+  ASSERT_EQ(counted::moves, 1);
 }
 
 TEST_F(StringBinarySearchTree, CanRemove) {  // NOLINT
@@ -0,0 +1,130 @@
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <data-structures/btree.hpp>
+
+using dads::trees::btree;
+
+namespace {
+
+class BTree : public ::testing::Test {
+ protected:
+  std::unique_ptr<btree<int, int>> tree;
+  void SetUp() override { tree = std::make_unique<btree<int, int>>(); }
+};
+
+TEST_F(BTree, EmptyTreeHasZeroSizeAndHeight) {  // NOLINT
+  ASSERT_EQ(tree->size(), 0);
+  ASSERT_EQ(tree->height(), 0);
+  ASSERT_FALSE(tree->min());
+  ASSERT_FALSE(tree->find(1));
+  ASSERT_FALSE(tree->remove(1));
+}
+
+TEST_F(BTree, DoNotAllowDuplicates) {  // NOLINT
+  ASSERT_TRUE(tree->insert(1, 13));
+  ASSERT_FALSE(tree->insert(1, 14));
+  ASSERT_EQ(tree->find(1), 13);
+}
+
+TEST_F(BTree, StaysShallow) {  // NOLINT
+  for (int i = 0; i < 100000; i++) {
+    tree->insert(i, i);
+  }
+
+  // 64 keys per node, and nodes are at least half full
+  ASSERT_LE(tree->height(), 4);
+  ASSERT_EQ(tree->min(), std::make_tuple(0, 0));
+  ASSERT_EQ(tree->max(), std::make_tuple(99999, 99999));
+}
+
+TEST_F(BTree, CanScanRanges) {  // NOLINT
+  for (int i = 0; i < 1000; i += 2) {
+    tree->insert(i, i * 10);
+  }
+
+  std::vector<int> keys;
+  tree->range(101, 121, [&keys](int k, int v) {
+    ASSERT_EQ(v, k * 10);
+    keys.push_back(k);
+  });
+  ASSERT_EQ(keys, std::vector<int>({102, 104, 106, 108, 110, 112, 114, 116,
+                                    118, 120}));
+
+  keys.clear();
+  tree->range(990, 5000, [&keys](int k, int) { keys.push_back(k); });
+  ASSERT_EQ(keys, std::vector<int>({990, 992, 994, 996, 998}));
+}
+
+// small nodes, so a few thousand keys exercise every split, borrow, and merge
+template <typename Tree>
+void matches_std_map(Tree &tree, unsigned seed) {
+  std::map<int, int> expected;
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> pick(0, 2000);
+
+  for (int i = 0; i < 50000; i++) {
+    const int k = pick(rng);
+    if (rng() % 2 == 0) {
+      ASSERT_EQ(tree.remove(k), expected.erase(k) == 1);
+    } else {
+      ASSERT_EQ(tree.insert(k, i), expected.emplace(k, i).second);
+    }
+  }
+
+  ASSERT_EQ(tree.size(), static_cast<int>(expected.size()));
+  auto it = std::begin(expected);
+  tree.inorder([&it](std::tuple<int, int> n) {
+    ASSERT_EQ(std::get<0>(n), it->first);
+    ASSERT_EQ(std::get<1>(n), it->second);
+    ++it;
+  });
+  ASSERT_EQ(it, std::end(expected));
+
+  for (int k = 0; k <= 2000; k++) {
+    auto e = expected.find(k);
+    ASSERT_EQ(tree.find(k).has_value(), e != std::end(expected));
+  }
+
+  for (const auto &[k, v] : expected) {
+    ASSERT_TRUE(tree.remove(k));
+  }
+  ASSERT_EQ(tree.size(), 0);
+  ASSERT_EQ(tree.height(), 0);
+}
+
+TEST(BTreeFanout, MatchesStdMapWithEvenFanout) {  // NOLINT
+  btree<int, int, 4> tree;
+  matches_std_map(tree, 1);
+}
+
+TEST(BTreeFanout, MatchesStdMapWithOddFanout) {  // NOLINT
+  btree<int, int, 5> tree;
+  matches_std_map(tree, 2);
+}
+
+TEST(BTreeFanout, MatchesStdMapWithDefaultFanout) {  // NOLINT
+  btree<int, int> tree;
+  matches_std_map(tree, 3);
+}
+
+TEST(StringBTree, CanInsertFindAndRemove) {  // NOLINT
+  btree<std::string, int, 4> tree;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(tree.insert("key " + std::to_string(i), i));
+  }
+
+  ASSERT_EQ(tree.find("key 42"), 42);
+  ASSERT_TRUE(tree.remove("key 42"));
+  ASSERT_FALSE(tree.find("key 42"));
+  ASSERT_EQ(tree.min(), std::make_tuple(std::string("key 0"), 0));
+  ASSERT_EQ(tree.max(), std::make_tuple(std::string("key 99"), 99));
+}
+
+}  // namespace
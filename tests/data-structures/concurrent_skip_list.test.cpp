@@ -0,0 +1,160 @@
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <data-structures/concurrent_skip_list.hpp>
+
+using dads::trees::concurrent_skip_list;
+
+namespace {
+
+class ConcurrentSkipList : public ::testing::Test {
+ protected:
+  std::unique_ptr<concurrent_skip_list<int, int>> list;
+  void SetUp() override {
+    list = std::make_unique<concurrent_skip_list<int, int>>();
+  }
+
+  template <typename F>
+  static void on_threads(int threads, F &&work) {
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; t++) {
+      ts.emplace_back(work, t);
+    }
+    for (auto &t : ts) {
+      t.join();
+    }
+  }
+};
+
+TEST_F(ConcurrentSkipList, EmptyListHasNothing) {  // NOLINT
+  ASSERT_EQ(list->size(), 0);
+  ASSERT_FALSE(list->find(1));
+  ASSERT_FALSE(list->remove(1));
+}
+
+TEST_F(ConcurrentSkipList, DoNotAllowDuplicates) {  // NOLINT
+  ASSERT_TRUE(list->insert(1, 1));
+  ASSERT_FALSE(list->insert(1, 2));
+  ASSERT_EQ(list->find(1), 1);
+}
+
+TEST_F(ConcurrentSkipList, MatchesStdMap) {  // NOLINT
+  std::map<int, int> expected;
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> pick(0, 999);
+
+  for (int i = 0; i < 20000; i++) {
+    const int k = pick(rng);
+    switch (rng() % 3) {
+      case 0:
+        ASSERT_EQ(list->remove(k), expected.erase(k) == 1);
+        break;
+      case 1:
+        ASSERT_EQ(list->insert(k, i), expected.emplace(k, i).second);
+        break;
+      default:
+        const auto it = expected.find(k);
+        ASSERT_EQ(list->find(k), it != std::end(expected)
+                                     ? std::optional<int>(it->second)
+                                     : std::nullopt);
+    }
+  }
+
+  ASSERT_EQ(list->size(), static_cast<int>(expected.size()));
+}
+
+TEST_F(ConcurrentSkipList, ThreadsInsertDisjointKeys) {  // NOLINT
+  const int threads = 8;
+  const int per_thread = 5000;
+  on_threads(threads, [this](int t) {
+    for (int i = 0; i < per_thread; i++) {
+      ASSERT_TRUE(list->insert(i * threads + t, t));
+    }
+  });
+
+  ASSERT_EQ(list->size(), threads * per_thread);
+  for (int k = 0; k < threads * per_thread; k++) {
+    ASSERT_EQ(list->find(k), k % threads);
+  }
+}
+
+TEST_F(ConcurrentSkipList, EveryKeyIsInsertedAndRemovedOnce) {  // NOLINT
+  // all threads fight over the same keys, every insert and remove that
+  // succeeds must be matched by one that succeeds on the other side
+  const int keys = 200;
+  std::vector<std::atomic<int>> balance(keys);
+
+  on_threads(8, [this, &balance](int t) {
+    std::mt19937 rng(t);
+    for (int i = 0; i < 20000; i++) {
+      const int k = rng() % keys;
+      if (rng() % 2 == 0) {
+        balance[k] += list->insert(k, k);
+      } else {
+        balance[k] -= list->remove(k);
+      }
+    }
+  });
+
+  int present = 0;
+  for (int k = 0; k < keys; k++) {
+    ASSERT_EQ(balance[k], list->contains(k) ? 1 : 0);
+    present += balance[k];
+  }
+  ASSERT_EQ(list->size(), present);
+}
+
+TEST_F(ConcurrentSkipList, ReadersSeeConsistentValues) {  // NOLINT
+  // writers insert and remove keys with the value derived from the key, so a
+  // reader must either miss the key, or see the right value
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad{0};
+
+  std::thread reader([this, &stop, &bad] {
+    std::mt19937 rng(1);
+    while (!stop) {
+      const int k = rng() % 100;
+      const auto v = list->find(k);
+      if (v and *v != 3 * k) {
+        bad++;
+      }
+    }
+  });
+
+  on_threads(4, [this](int t) {
+    std::mt19937 rng(t);
+    for (int i = 0; i < 20000; i++) {
+      const int k = rng() % 100;
+      if (rng() % 2 == 0) {
+        list->insert(k, 3 * k);
+      } else {
+        list->remove(k);
+      }
+    }
+  });
+  stop = true;
+  reader.join();
+
+  ASSERT_EQ(bad, 0);
+}
+
+TEST(ConcurrentSkipListStrings, OwnsItsValues) {  // NOLINT
+  concurrent_skip_list<std::string, std::string> list;
+  ASSERT_TRUE(list.insert("b", std::string(100, 'b')));
+  ASSERT_TRUE(list.insert("a", "a"));
+  ASSERT_TRUE(list.insert("c", "c"));
+  ASSERT_TRUE(list.remove("b"));
+
+  ASSERT_EQ(list.find("a"), "a");
+  ASSERT_FALSE(list.find("b"));
+  ASSERT_EQ(list.size(), 2);
+}
+
+}  // namespace
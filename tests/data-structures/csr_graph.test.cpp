@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <algorithms/depth_first_search.hpp>
+#include <algorithms/graph_utils.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+
+namespace {
+
+class Graph_CSR : public ::testing::Test {
+ protected:
+  std::unique_ptr<graph<csr_graph>> G;
+  void SetUp() override {
+    G = std::make_unique<graph<csr_graph>>(csr_graph({{0, 2, 1},
+                                                      {0, 1, 5},
+                                                      {1, 0, 3},
+                                                      {2, 3, 7},
+                                                      {3, 0, 2},
+                                                      {0, 2, 4}}));
+  }
+};
+
+TEST_F(Graph_CSR, CanGetNeighboursInOrder) {  // NOLINT
+  ASSERT_EQ(G->neighbours(0), std::vector<int>({1, 2}));
+  ASSERT_EQ(G->neighbours(1), std::vector<int>({0}));
+  ASSERT_EQ(G->neighbours(4), std::vector<int>());
+}
+
+TEST_F(Graph_CSR, CanGetWeights) {  // NOLINT
+  ASSERT_EQ(G->weight(0, 1), 5);
+  ASSERT_EQ(G->weight(1, 0), 3);
+  ASSERT_EQ(G->weight(2, 3), 7);
+}
+
+TEST_F(Graph_CSR, CanIterateEdges) {  // NOLINT
+  std::vector<std::pair<int, int>> es;
+  for (const auto [n, w] : G->edges(0)) {
+    es.emplace_back(n, w);
+  }
+
+  ASSERT_EQ(es, (std::vector<std::pair<int, int>>{{1, 5}, {2, 4}}));
+  ASSERT_TRUE(G->edges(4).empty());
+}
+
+TEST_F(Graph_CSR, LastDuplicateEdgeWins) {  // NOLINT
+  ASSERT_EQ(G->weight(0, 2), 4);
+  ASSERT_EQ(G->neighbours(0).size(), 2);
+}
+
+TEST_F(Graph_CSR, CanGetNodes) {  // NOLINT
+  ASSERT_EQ(G->nodes(), std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST_F(Graph_CSR, IsImmutable) {  // NOLINT
+  ASSERT_THROW(G->add_edge(0, 3, 1), std::logic_error);
+}
+
+TEST_F(Graph_CSR, CanBeSearched) {  // NOLINT
+  std::vector<int> bfs;
+  dads::graphs::breadth_first_search(
+      *G, 0, [&bfs](int /*parent*/, int node) { bfs.push_back(node); });
+  ASSERT_EQ(bfs, std::vector<int>({1, 2, 3}));
+
+  std::vector<int> dfs;
+  dads::graphs::depth_first_search(
+      *G, 0, [&dfs](int /*parent*/, int node) { dfs.push_back(node); });
+  ASSERT_EQ(dfs, std::vector<int>({0, 2, 3, 1}));
+}
+
+TEST(Graph_CSRConversion, CanBuildFromAdjacencyList) {  // NOLINT
+  std::string graph_str = "0,1,1 0,2,1 1,3,2 1,4,2 2,5,2 2,6,2";
+  auto list = dads::graphs::from_csv<graph<adjacency_list>>(graph_str);
+
+  graph<csr_graph> csr{csr_graph(*list)};
+
+  ASSERT_EQ(dads::graphs::to_csv(csr), graph_str);
+}
+
+TEST(Graph_CSRConversion, CanTranspose) {  // NOLINT
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> pick(0, 499);
+  graph<adjacency_list> list;
+  list.keep_in_edges();
+  for (int i = 0; i < 5000; i++) {
+    list.add_edge(pick(rng), pick(rng), pick(rng) - 250);
+  }
+
+  dads::utils::thread_pool pool(4);
+  const auto reverse = dads::graphs::transpose(list, pool);
+
+  // the edges into every node, sorted, with the weights of the edges
+  for (int v = 0; v < 500; v++) {
+    std::vector<std::pair<int, int>> expected;
+    for (const auto [u, w] : list.in_edges(v)) {
+      expected.emplace_back(u, w);
+    }
+    std::sort(std::begin(expected), std::end(expected));
+
+    std::vector<std::pair<int, int>> es;
+    for (const auto [u, w] : reverse->edges(v)) {
+      es.emplace_back(u, w);
+      ASSERT_EQ(reverse->weight(v, u), w);
+    }
+    ASSERT_EQ(es, expected);
+  }
+}
+
+}  // namespace
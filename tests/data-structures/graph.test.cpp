@@ -1,19 +1,36 @@
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <data-structures/graph.hpp>
+#include <utils/thread_pool.hpp>
 
 using dads::graphs::adjacency_list;
 using dads::graphs::adjacency_matrix;
+using dads::graphs::any_node_store;
 using dads::graphs::graph;
+using dads::graphs::is_node_store;
 
 namespace {
 
+static_assert(is_node_store<adjacency_list>::value);
+static_assert(is_node_store<adjacency_matrix<10>>::value);
+static_assert(is_node_store<any_node_store>::value);
+static_assert(!is_node_store<int>::value);
+static_assert(dads::graphs::has_in_edges<adjacency_list>::value);
+static_assert(dads::graphs::has_in_edges<adjacency_matrix<10>>::value);
+static_assert(dads::graphs::has_in_edges<graph<adjacency_list>>::value);
+static_assert(!dads::graphs::has_in_edges<any_node_store>::value);
+
 class Graph_AdjacencyList : public ::testing::Test {
  protected:
   std::unique_ptr<graph<adjacency_list>> G;
@@ -31,6 +48,10 @@ TEST_F(Graph_AdjacencyList, CanAddEdges) {  // NOLINT
   int v = G->neighbours(1)[0];
   ASSERT_EQ(v, 0);
   ASSERT_EQ(G->weight(1, v), 3);
+
+  ASSERT_TRUE(G->has_edge(0, 1));
+  ASSERT_FALSE(G->has_edge(0, 2));
+  ASSERT_FALSE(G->has_edge(2, 0));
 }
 
 TEST_F(Graph_AdjacencyList, CanAddBiEdge) {  // NOLINT
@@ -45,6 +66,21 @@ TEST_F(Graph_AdjacencyList, CanAddBiEdge) {  // NOLINT
   ASSERT_EQ(G->weight(1, v), 5);
 }
 
+TEST_F(Graph_AdjacencyList, CanIterateEdges) {  // NOLINT
+  G->add_edge(0, 1, 5);
+  G->add_edge(0, 2, 3);
+  G->add_edge(1, 2, 7);
+
+  std::vector<std::pair<int, int>> es;
+  for (const auto [n, w] : G->edges(0)) {
+    es.emplace_back(n, w);
+  }
+  std::sort(std::begin(es), std::end(es));
+
+  ASSERT_EQ(es, (std::vector<std::pair<int, int>>{{1, 5}, {2, 3}}));
+  ASSERT_TRUE(G->edges(2).empty());
+}
+
 TEST_F(Graph_AdjacencyList, CanGetNodes) {  // NOLINT
   G->add_bi_edge(0, 1, 10);
   G->add_bi_edge(1, 2, 10);
@@ -90,6 +126,21 @@ TEST_F(Graph_AdjacencyMatrix, CanAddBiEdge) {  // NOLINT
   ASSERT_EQ(G->weight(1, v), 5);
 }
 
+TEST_F(Graph_AdjacencyMatrix, CanIterateEdges) {  // NOLINT
+  G->add_edge(0, 1, 5);
+  G->add_edge(0, 2, 3);
+  G->add_edge(1, 2, 7);
+
+  std::vector<std::pair<int, int>> es;
+  for (const auto [n, w] : G->edges(0)) {
+    es.emplace_back(n, w);
+  }
+  std::sort(std::begin(es), std::end(es));
+
+  ASSERT_EQ(es, (std::vector<std::pair<int, int>>{{1, 5}, {2, 3}}));
+  ASSERT_TRUE(G->edges(2).empty());
+}
+
 TEST_F(Graph_AdjacencyMatrix, CanGetNodes) {  // NOLINT
   G->add_bi_edge(0, 1, 10);
   G->add_bi_edge(1, 2, 10);
@@ -103,4 +154,240 @@ TEST_F(Graph_AdjacencyMatrix, CanGetNodes) {  // NOLINT
   ASSERT_EQ(v[2], 2);
 }
 
+TEST_F(Graph_AdjacencyMatrix, CanStoreNegativeWeights) {  // NOLINT
+  G->add_edge(0, 1, -5);
+  G->add_edge(0, 2, 0);
+
+  ASSERT_EQ(G->neighbours(0), std::vector<int>({1, 2}));
+  ASSERT_EQ(G->weight(0, 1), -5);
+  ASSERT_EQ(G->weight(0, 3), 0);
+  ASSERT_EQ(G->nodes(), std::vector<int>({0}));
+
+  // a missing edge also weighs 0, has_edge tells them apart
+  ASSERT_TRUE(G->has_edge(0, 2));
+  ASSERT_FALSE(G->has_edge(0, 3));
+  ASSERT_FALSE(G->has_edge(1, 0));
+}
+
+TEST(Graph_AdjacencyMatrix_Wide, CanScanRowsOfManyWords) {  // NOLINT
+  // rows of five words, with the edges spread over them
+  graph<adjacency_matrix<300>> G;
+  const std::vector<int> row = {0, 63, 64, 200, 255, 256, 299};
+  for (const int v : row) {
+    G.add_edge(7, v, v - 100);
+  }
+  G.add_edge(299, 0, 1);
+  G.add_edge(130, 129, 1);
+
+  ASSERT_EQ(G.neighbours(7), row);
+  std::vector<std::pair<int, int>> es;
+  for (const auto [n, w] : G.edges(7)) {
+    es.emplace_back(n, w);
+  }
+  ASSERT_EQ(es.size(), row.size());
+  for (std::size_t i = 0; i < row.size(); i++) {
+    ASSERT_EQ(es[i], std::make_pair(row[i], row[i] - 100));
+  }
+
+  ASSERT_TRUE(G.edges(8).empty());
+  ASSERT_EQ(G.neighbours(299), std::vector<int>({0}));
+  ASSERT_EQ(G.nodes(), std::vector<int>({7, 130, 299}));
+}
+
+// the same records, in the same order, as add_edge gets them
+std::vector<std::tuple<int, int, int>> edge_batch() {
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < 2000; i++) {
+    // plenty of repeated edges, with different weights
+    edges.emplace_back((i * 7) % 53, (i * 13) % 97, i);
+  }
+  edges.emplace_back(-3, 5, 1);
+  return edges;
+}
+
+TEST(Graph_AddEdges, MatchesAddingOneAtATime) {  // NOLINT
+  const auto edges = edge_batch();
+
+  graph<adjacency_list> one;
+  one.add_edge(0, 1, -1);
+  for (const auto &[u, v, w] : edges) {
+    one.add_edge(u, v, w);
+  }
+
+  for (const std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+    dads::utils::thread_pool pool(threads);
+    graph<adjacency_list> G;
+    G.add_edge(0, 1, -1);
+    G.add_edges(edges, pool);
+
+    std::vector<int> ns = G.nodes();
+    std::vector<int> expected = one.nodes();
+    std::sort(std::begin(ns), std::end(ns));
+    std::sort(std::begin(expected), std::end(expected));
+    ASSERT_EQ(ns, expected);
+
+    for (const int n : ns) {
+      std::vector<int> a = G.neighbours(n);
+      std::vector<int> b = one.neighbours(n);
+      std::sort(std::begin(a), std::end(a));
+      std::sort(std::begin(b), std::end(b));
+      ASSERT_EQ(a, b);
+      for (const int m : a) {
+        ASSERT_EQ(G.weight(n, m), one.weight(n, m));
+      }
+    }
+    ASSERT_EQ(G.id_bound(), one.id_bound());
+  }
+}
+
+TEST(Graph_AddEdges, KeepsTheIdBound) {  // NOLINT
+  dads::utils::thread_pool pool(3);
+  graph<adjacency_list> G;
+  G.reserve(10, 20);
+
+  G.add_edges(std::vector<std::tuple<int, int, int>>{{0, 4, 1}, {2, 9, 1}},
+              pool);
+  ASSERT_EQ(G.id_bound(), 10);
+
+  G.add_edges(std::vector<std::tuple<int, int, int>>{}, pool);
+  ASSERT_EQ(G.id_bound(), 10);
+}
+
+TEST(Graph_AddEdges, CanAddBiEdges) {  // NOLINT
+  graph<adjacency_matrix<10>> G;
+  G.add_bi_edges(std::vector<std::tuple<int, int, int>>{{0, 1, 5}, {2, 3, 4}});
+
+  ASSERT_EQ(G.weight(0, 1), 5);
+  ASSERT_EQ(G.weight(1, 0), 5);
+  ASSERT_EQ(G.weight(3, 2), 4);
+  ASSERT_EQ(G.neighbours(2), std::vector<int>({3}));
+}
+
+// the (from, weight) pairs of the edges into a node, sorted
+template <typename G>
+std::vector<std::pair<int, int>> sorted_in_edges(const G &g, int n) {
+  std::vector<std::pair<int, int>> es;
+  for (const auto [from, w] : g.in_edges(n)) {
+    es.emplace_back(from, w);
+  }
+  std::sort(std::begin(es), std::end(es));
+  return es;
+}
+
+TEST(Graph_AddEdges, BiEdgesMatchAddingOneAtATime) {  // NOLINT
+  const auto edges = edge_batch();
+
+  graph<adjacency_list> one;
+  for (const auto &[u, v, w] : edges) {
+    one.add_bi_edge(u, v, w);
+  }
+
+  dads::utils::thread_pool pool(4);
+  graph<adjacency_list> G;
+  G.keep_in_edges();
+  G.add_bi_edges(edges, pool);
+
+  for (const int n : one.nodes()) {
+    std::vector<int> a = G.neighbours(n);
+    std::vector<int> b = one.neighbours(n);
+    std::sort(std::begin(a), std::end(a));
+    std::sort(std::begin(b), std::end(b));
+    ASSERT_EQ(a, b);
+    std::vector<std::pair<int, int>> into;
+    for (const int m : a) {
+      ASSERT_EQ(G.weight(n, m), one.weight(n, m));
+      into.emplace_back(m, one.weight(m, n));
+    }
+    ASSERT_EQ(sorted_in_edges(G, n), into);
+  }
+}
+
+TEST(Graph_InEdges, ListKeepsTheEdgesIntoNodes) {  // NOLINT
+  graph<adjacency_list> G;
+  G.add_edge(0, 2, 5);
+  G.add_edge(1, 2, 3);
+  ASSERT_THROW(G.in_edges(2), std::logic_error);
+
+  // the edges already there are indexed, and later ones are kept up to date
+  G.keep_in_edges();
+  G.add_edge(0, 2, 4);
+
+  ASSERT_EQ(sorted_in_edges(G, 2),
+            (std::vector<std::pair<int, int>>{{0, 4}, {1, 3}}));
+  ASSERT_TRUE(G.in_edges(0).empty());
+  ASSERT_TRUE(G.in_edges(7).empty());
+
+  dads::utils::thread_pool pool(3);
+  G.add_edges(std::vector<std::tuple<int, int, int>>{
+                  {3, 2, 1}, {1, 2, 8}, {2, 0, 6}},
+              pool);
+  ASSERT_EQ(sorted_in_edges(G, 2),
+            (std::vector<std::pair<int, int>>{{0, 4}, {1, 8}, {3, 1}}));
+  ASSERT_EQ(sorted_in_edges(G, 0), (std::vector<std::pair<int, int>>{{2, 6}}));
+}
+
+TEST(Graph_InEdges, MatrixKeepsTheEdgesIntoNodes) {  // NOLINT
+  graph<adjacency_matrix<200>> G;
+  G.add_edge(0, 130, 5);
+  G.add_edge(199, 130, -3);
+  G.add_edge(64, 130, 2);
+  G.add_edge(130, 0, 1);
+
+  ASSERT_EQ(sorted_in_edges(G, 130),
+            (std::vector<std::pair<int, int>>{{0, 5}, {64, 2}, {199, -3}}));
+  ASSERT_EQ(sorted_in_edges(G, 0),
+            (std::vector<std::pair<int, int>>{{130, 1}}));
+  ASSERT_TRUE(G.in_edges(64).empty());
+}
+
+class Graph_AnyNodeStore : public ::testing::TestWithParam<bool> {
+ protected:
+  std::unique_ptr<graph<any_node_store>> G;
+  void SetUp() override {
+    // the store is picked at runtime
+    if (GetParam()) {
+      G = std::make_unique<graph<any_node_store>>(
+          any_node_store(adjacency_list()));
+    } else {
+      G = std::make_unique<graph<any_node_store>>(
+          any_node_store(adjacency_matrix<10>()));
+    }
+  }
+};
+
+TEST_P(Graph_AnyNodeStore, CanAddEdges) {  // NOLINT
+  G->add_edge(0, 1, 5);
+  G->add_bi_edge(1, 2, 3);
+
+  ASSERT_EQ(G->neighbours(0), std::vector<int>({1}));
+  ASSERT_EQ(G->weight(0, 1), 5);
+  ASSERT_EQ(G->weight(2, 1), 3);
+
+  std::vector<int> v = G->nodes();
+  std::sort(std::begin(v), std::end(v));
+  ASSERT_EQ(v, std::vector<int>({0, 1, 2}));
+}
+
+TEST_P(Graph_AnyNodeStore, CanIterateEdges) {  // NOLINT
+  G->add_edge(0, 1, 5);
+
+  for (const auto [n, w] : G->edges(0)) {
+    ASSERT_EQ(n, 1);
+    ASSERT_EQ(w, 5);
+  }
+}
+
+TEST_P(Graph_AnyNodeStore, CanAddEdgesInOneGo) {  // NOLINT
+  G->reserve(3, 3);
+  G->add_edges(std::vector<std::tuple<int, int, int>>{
+      {0, 1, 5}, {1, 2, 3}, {0, 1, 6}});
+
+  ASSERT_EQ(G->neighbours(0), std::vector<int>({1}));
+  ASSERT_EQ(G->weight(0, 1), 6);
+  ASSERT_EQ(G->weight(1, 2), 3);
+}
+
+INSTANTIATE_TEST_SUITE_P(ListAndMatrix, Graph_AnyNodeStore,
+                         ::testing::Bool());
+
 }  // namespace
@@ -0,0 +1,57 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <data-structures/graph.hpp>
+#include <data-structures/id_map.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::graph;
+using dads::graphs::id_map;
+
+namespace {
+
+TEST(IdMap, HandsOutDenseIds) {  // NOLINT
+  id_map ids;
+  ASSERT_EQ(ids.insert(1000000), 0);
+  ASSERT_EQ(ids.insert(-5), 1);
+  ASSERT_EQ(ids.insert(1000000), 0);
+  ASSERT_EQ(ids.size(), 2);
+
+  ASSERT_EQ(ids.to_dense(-5), 1);
+  ASSERT_EQ(ids.to_dense(7), -1);
+  ASSERT_EQ(ids.to_original(0), 1000000);
+}
+
+class SparseGraph : public ::testing::Test {
+ protected:
+  std::unique_ptr<graph<adjacency_list>> G;
+  void SetUp() override {
+    G = std::make_unique<graph<adjacency_list>>();
+    G->add_bi_edge(-7, 1000000, 2);
+    G->add_edge(1000000, 123456789, 3);
+    G->add_edge(42, -7, 1);
+  }
+};
+
+TEST_F(SparseGraph, IsNotDense) {  // NOLINT
+  ASSERT_EQ(G->id_bound(), -1);
+  ASSERT_THROW(dads::graphs::bfs_distances(*G, -7), std::invalid_argument);
+}
+
+TEST_F(SparseGraph, CanBeSearchedWithDenseIds) {  // NOLINT
+  auto r = dads::graphs::remap_ids(*G);
+  ASSERT_EQ(r.ids.size(), 4);
+  ASSERT_EQ(r.dense->id_bound(), 4);
+
+  const auto d = dads::graphs::bfs_distances(*r.dense, r.ids.to_dense(-7));
+
+  ASSERT_EQ(d[r.ids.to_dense(-7)], 0);
+  ASSERT_EQ(d[r.ids.to_dense(1000000)], 2);
+  ASSERT_EQ(d[r.ids.to_dense(123456789)], 5);
+  ASSERT_EQ(d[r.ids.to_dense(42)], dads::graphs::unreachable);
+}
+
+}  // namespace
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <algorithms/breadth_first_search.hpp>
+#include <algorithms/depth_first_search.hpp>
+#include <algorithms/graph_utils.hpp>
+#include <data-structures/csr_graph.hpp>
+#include <data-structures/graph.hpp>
+#include <data-structures/mapped_csr_graph.hpp>
+
+using dads::graphs::adjacency_list;
+using dads::graphs::csr_graph;
+using dads::graphs::graph;
+using dads::graphs::mapped_csr_graph;
+using dads::graphs::write_csr_file;
+
+namespace {
+
+class Graph_MappedCSR : public ::testing::Test {
+ protected:
+  std::string path;
+  std::unique_ptr<graph<mapped_csr_graph>> G;
+  void SetUp() override {
+    path = ::testing::TempDir() + "dads_mapped_csr_graph.csr";
+
+    std::string csv = "0,2,1 0,1,5 1,0,3 2,3,7 3,0,2 2,6,4";
+    auto list = dads::graphs::from_csv<graph<adjacency_list>>(csv);
+    write_csr_file(*list, path);
+
+    G = std::make_unique<graph<mapped_csr_graph>>(mapped_csr_graph(path));
+  }
+  void TearDown() override {
+    G.reset();
+    std::remove(path.c_str());
+  }
+
+  // overwrites part of the file
+  template <typename T>
+  void patch(std::size_t at, const T &value) {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(at);
+    f.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+};
+
+TEST_F(Graph_MappedCSR, CanGetNeighboursInOrder) {  // NOLINT
+  ASSERT_EQ(G->neighbours(0), std::vector<int>({1, 2}));
+  ASSERT_EQ(G->neighbours(2), std::vector<int>({3, 6}));
+  ASSERT_EQ(G->neighbours(6), std::vector<int>());
+  ASSERT_EQ(G->neighbours(7), std::vector<int>());
+}
+
+TEST_F(Graph_MappedCSR, CanGetWeights) {  // NOLINT
+  ASSERT_EQ(G->weight(0, 1), 5);
+  ASSERT_EQ(G->weight(2, 6), 4);
+  ASSERT_EQ(G->weight(3, 0), 2);
+  ASSERT_EQ(G->weight(3, 1), 0);
+}
+
+TEST_F(Graph_MappedCSR, CoversEveryNodeId) {  // NOLINT
+  ASSERT_EQ(G->nodes(), std::vector<int>({0, 1, 2, 3}));
+  ASSERT_EQ(G->id_bound(), 7);
+}
+
+TEST_F(Graph_MappedCSR, IsImmutable) {  // NOLINT
+  ASSERT_THROW(G->add_edge(0, 3, 1), std::logic_error);
+}
+
+TEST_F(Graph_MappedCSR, CanBeSearched) {  // NOLINT
+  std::vector<int> bfs;
+  dads::graphs::breadth_first_search(
+      *G, 0, [&bfs](int /*parent*/, int node) { bfs.push_back(node); });
+  ASSERT_EQ(bfs, std::vector<int>({1, 2, 3, 6}));
+
+  std::vector<int> dfs;
+  dads::graphs::depth_first_search(
+      *G, 0, [&dfs](int /*parent*/, int node) { dfs.push_back(node); });
+  ASSERT_EQ(dfs.size(), 5);
+}
+
+TEST_F(Graph_MappedCSR, MatchesTheGraphItWasWrittenFrom) {  // NOLINT
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int u = 0; u < 500; u++) {
+    for (int i = 0; i < u % 7; i++) {
+      edges.emplace_back(u, (u * 31 + i * 17) % 613, u + i);
+    }
+  }
+  graph<csr_graph> csr{csr_graph(edges)};
+  write_csr_file(csr, path);
+  mapped_csr_graph mapped(path);
+
+  ASSERT_EQ(mapped.node_count(), csr.id_bound());
+  ASSERT_EQ(dads::graphs::to_csv(mapped), dads::graphs::to_csv(csr));
+}
+
+TEST_F(Graph_MappedCSR, CanStoreEmptyGraphs) {  // NOLINT
+  write_csr_file(graph<adjacency_list>(), path);
+  mapped_csr_graph empty(path);
+  ASSERT_EQ(empty.node_count(), 0);
+  ASSERT_EQ(empty.edge_count(), 0);
+  ASSERT_TRUE(empty.edges(0).empty());
+}
+
+TEST_F(Graph_MappedCSR, RefusesNegativeNodes) {  // NOLINT
+  graph<adjacency_list> g;
+  g.add_edge(0, -1, 1);
+  ASSERT_THROW(write_csr_file(g, path), std::invalid_argument);
+}
+
+TEST_F(Graph_MappedCSR, RefusesOtherFiles) {  // NOLINT
+  G.reset();
+  ASSERT_THROW(mapped_csr_graph(path + ".missing"), std::system_error);
+
+  patch(8, std::uint32_t{2});
+  ASSERT_THROW(mapped_csr_graph{path}, std::runtime_error);
+  patch(8, dads::graphs::csr_file_version);
+  patch(12, std::uint32_t{0x04030201});
+  ASSERT_THROW(mapped_csr_graph{path}, std::runtime_error);
+  patch(12, dads::graphs::csr_file_byte_order);
+  patch(24, std::uint64_t{1} << 40);
+  ASSERT_THROW(mapped_csr_graph{path}, std::runtime_error);
+
+  std::ofstream(path) << "0,1,1 1,2,1";
+  ASSERT_THROW(mapped_csr_graph{path}, std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,181 @@
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <data-structures/persistent_tree.hpp>
+
+using dads::trees::persistent_tree;
+using dads::trees::versioned_tree;
+
+namespace {
+
+class PersistentTree : public ::testing::Test {
+ protected:
+  std::unique_ptr<persistent_tree<int, int>> tree;
+  void SetUp() override {
+    tree = std::make_unique<persistent_tree<int, int>>();
+  }
+
+  static std::map<int, int> contents(const persistent_tree<int, int> &t) {
+    std::map<int, int> m;
+    t.inorder([&m](int k, int v) { m.emplace(k, v); });
+    return m;
+  }
+};
+
+TEST_F(PersistentTree, EmptyTreeHasNothing) {  // NOLINT
+  ASSERT_EQ(tree->size(), 0);
+  ASSERT_EQ(tree->height(), 0);
+  ASSERT_EQ(tree->find(1), nullptr);
+  ASSERT_FALSE(tree->remove(1));
+  ASSERT_FALSE(tree->min());
+  ASSERT_FALSE(tree->max());
+}
+
+TEST_F(PersistentTree, DoNotAllowDuplicates) {  // NOLINT
+  ASSERT_TRUE(tree->insert(1, 1));
+  ASSERT_FALSE(tree->insert(1, 2));
+  ASSERT_EQ(*tree->find(1), 1);
+  ASSERT_EQ(tree->size(), 1);
+}
+
+TEST_F(PersistentTree, MatchesStdMap) {  // NOLINT
+  std::map<int, int> expected;
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> pick(0, 999);
+
+  for (int i = 0; i < 20000; i++) {
+    const int k = pick(rng);
+    if (rng() % 2 == 0) {
+      ASSERT_EQ(tree->remove(k), expected.erase(k) == 1);
+    } else {
+      ASSERT_EQ(tree->insert(k, i), expected.emplace(k, i).second);
+    }
+  }
+
+  ASSERT_EQ(tree->size(), static_cast<int>(expected.size()));
+  ASSERT_EQ(contents(*tree), expected);
+  ASSERT_EQ(std::get<0>(*tree->min()), std::begin(expected)->first);
+  ASSERT_EQ(std::get<0>(*tree->max()), std::rbegin(expected)->first);
+}
+
+TEST_F(PersistentTree, StaysBalanced) {  // NOLINT
+  for (int i = 0; i < (1 << 12); i++) {
+    tree->insert(i, i);
+  }
+  // an avl tree is at most 1.44 log2(n) high
+  ASSERT_LE(tree->height(), 18);
+
+  for (int i = 0; i < (1 << 12); i += 2) {
+    tree->remove(i);
+  }
+  ASSERT_LE(tree->height(), 17);
+}
+
+TEST_F(PersistentTree, SnapshotsDoNotChange) {  // NOLINT
+  std::map<int, int> expected;
+  std::vector<std::tuple<persistent_tree<int, int>, std::map<int, int>>>
+      versions;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 499);
+
+  for (int i = 0; i < 5000; i++) {
+    const int k = pick(rng);
+    if (rng() % 3 == 0) {
+      tree->remove(k);
+      expected.erase(k);
+    } else {
+      tree->insert(k, i);
+      expected.emplace(k, i);
+    }
+
+    if (i % 250 == 0) {
+      versions.emplace_back(tree->snapshot(), expected);
+    }
+  }
+
+  for (const auto &[snapshot, then] : versions) {
+    ASSERT_EQ(snapshot.size(), static_cast<int>(then.size()));
+    ASSERT_EQ(contents(snapshot), then);
+  }
+}
+
+TEST_F(PersistentTree, UnchangedTreesAreShared) {  // NOLINT
+  for (int i = 0; i < 100; i++) {
+    tree->insert(i, i);
+  }
+
+  auto snapshot = tree->snapshot();
+  ASSERT_TRUE(snapshot.shares_root_with(*tree));
+  ASSERT_FALSE(tree->insert(5, 5));
+  ASSERT_FALSE(tree->remove(500));
+  ASSERT_TRUE(snapshot.shares_root_with(*tree));
+
+  ASSERT_TRUE(tree->insert(500, 500));
+  ASSERT_FALSE(snapshot.shares_root_with(*tree));
+  ASSERT_FALSE(snapshot.contains(500));
+}
+
+TEST(PersistentTreeNodes, AreDeletedWithTheLastVersion) {  // NOLINT
+  auto value = std::make_shared<int>(1);
+  {
+    persistent_tree<int, std::shared_ptr<int>> tree;
+    for (int i = 0; i < 100; i++) {
+      tree.insert(i, value);
+    }
+    auto snapshot = tree.snapshot();
+    for (int i = 0; i < 100; i++) {
+      tree.remove(i);
+    }
+    ASSERT_EQ(tree.size(), 0);
+    ASSERT_EQ(value.use_count(), 101);
+  }
+  ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(VersionedTree, ReadersSeeWholeVersions) {  // NOLINT
+  versioned_tree<int, int> tree;
+  const int keys = 20000;
+  std::atomic<bool> done{false};
+
+  // the writer only ever inserts the next key, so every version holds the
+  // keys [0, size)
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; t++) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        const auto snapshot = tree.snapshot();
+        const int n = snapshot.size();
+        int expected = 0;
+        snapshot.inorder([&expected](int k, int v) {
+          ASSERT_EQ(k, expected);
+          ASSERT_EQ(v, -k);
+          expected++;
+        });
+        ASSERT_EQ(expected, n);
+      }
+    });
+  }
+
+  for (int i = 0; i < keys; i++) {
+    ASSERT_TRUE(tree.insert(i, -i));
+  }
+  done = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+
+  ASSERT_EQ(tree.snapshot().size(), keys);
+  ASSERT_EQ(tree.update([](persistent_tree<int, int> &t) {
+    t.remove(0);
+    return t.size();
+  }), keys - 1);
+}
+
+}  // namespace
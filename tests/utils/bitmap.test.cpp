@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/bitmap.hpp>
+
+using dads::utils::bitmap;
+
+namespace {
+
+class Bitmap : public ::testing::Test {
+ protected:
+  std::unique_ptr<bitmap> bits;
+  void SetUp() override { bits = std::make_unique<bitmap>(200); }
+};
+
+TEST_F(Bitmap, StartsEmpty) {  // NOLINT
+  ASSERT_EQ(bits->size(), 200);
+  ASSERT_EQ(bits->word_count(), 4);
+  ASSERT_EQ(bits->count(), 0);
+}
+
+TEST_F(Bitmap, CanSetAndReset) {  // NOLINT
+  bits->set(0);
+  bits->set(63);
+  bits->set(64);
+  bits->set(199);
+
+  ASSERT_TRUE(bits->test(0));
+  ASSERT_TRUE(bits->test(63));
+  ASSERT_TRUE(bits->test(64));
+  ASSERT_TRUE(bits->test(199));
+  ASSERT_FALSE(bits->test(1));
+  ASSERT_EQ(bits->count(), 4);
+
+  bits->reset(63);
+  ASSERT_FALSE(bits->test(63));
+  ASSERT_EQ(bits->count(), 3);
+}
+
+TEST_F(Bitmap, SetAtomicReportsTheFirstSetter) {  // NOLINT
+  ASSERT_TRUE(bits->set_atomic(100));
+  ASSERT_FALSE(bits->set_atomic(100));
+  ASSERT_TRUE(bits->test(100));
+}
+
+TEST_F(Bitmap, CanIterateSetBits) {  // NOLINT
+  for (const std::size_t i : {3, 70, 71, 150}) {
+    bits->set(i);
+  }
+
+  std::vector<std::size_t> set;
+  bits->for_each_set([&set](std::size_t i) { set.push_back(i); });
+  ASSERT_EQ(set, std::vector<std::size_t>({3, 70, 71, 150}));
+
+  bits->clear();
+  ASSERT_EQ(bits->count(), 0);
+}
+
+}  // namespace
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/d_ary_heap.hpp>
+
+using dads::utils::d_ary_heap;
+
+namespace {
+
+class DAryHeap : public ::testing::Test {
+ protected:
+  std::unique_ptr<d_ary_heap<int>> heap;
+  void SetUp() override { heap = std::make_unique<d_ary_heap<int>>(); }
+};
+
+TEST_F(DAryHeap, StartsEmpty) {  // NOLINT
+  ASSERT_TRUE(heap->empty());
+  ASSERT_EQ(heap->size(), 0);
+}
+
+TEST_F(DAryHeap, PopsSmallestFirst) {  // NOLINT
+  for (const int x : {5, 3, 8, 1, 9, 2, 2}) {
+    heap->push(x);
+  }
+
+  ASSERT_EQ(heap->size(), 7);
+  ASSERT_EQ(heap->top(), 1);
+
+  std::vector<int> out;
+  while (!heap->empty()) {
+    out.push_back(heap->pop());
+  }
+  ASSERT_EQ(out, std::vector<int>({1, 2, 2, 3, 5, 8, 9}));
+}
+
+TEST_F(DAryHeap, SortsRandomInput) {  // NOLINT
+  std::mt19937 rng(1);
+  std::vector<int> xs(10000);
+  for (auto &x : xs) {
+    x = rng() % 1000;
+    heap->push(x);
+  }
+
+  std::sort(std::begin(xs), std::end(xs));
+  for (const int x : xs) {
+    ASSERT_EQ(heap->pop(), x);
+  }
+}
+
+TEST(DAryHeapCompare, CanBeAMaxHeap) {  // NOLINT
+  d_ary_heap<int, 3, std::greater<int>> heap;
+  for (const int x : {5, 3, 8, 1}) {
+    heap.push(x);
+  }
+
+  ASSERT_EQ(heap.pop(), 8);
+  ASSERT_EQ(heap.pop(), 5);
+}
+
+}  // namespace
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/epoch_domain.hpp>
+
+using dads::utils::epoch_domain;
+
+namespace {
+
+// counts how many of them are alive
+struct tracked {
+  static std::atomic<int> alive;
+  tracked() { alive++; }
+  ~tracked() { alive--; }
+};
+std::atomic<int> tracked::alive{0};
+
+class EpochDomain : public ::testing::Test {
+ protected:
+  std::unique_ptr<epoch_domain> domain;
+  void SetUp() override {
+    tracked::alive = 0;
+    domain = std::make_unique<epoch_domain>();
+  }
+};
+
+TEST_F(EpochDomain, DeletesRetiredNodesEventually) {  // NOLINT
+  for (int i = 0; i < 1000; i++) {
+    epoch_domain::guard guard(*domain);
+    guard.retire(new tracked());
+  }
+
+  // pinning moves the epoch along, and cleans up behind it
+  ASSERT_LT(tracked::alive, 1000);
+  domain->collect_all();
+  ASSERT_EQ(tracked::alive, 0);
+}
+
+TEST_F(EpochDomain, KeepsNodesWhilePinned) {  // NOLINT
+  auto reader = std::make_unique<epoch_domain::guard>(*domain);
+  const auto pinned_at = domain->epoch();
+
+  for (int i = 0; i < 1000; i++) {
+    epoch_domain::guard guard(*domain);
+    guard.retire(new tracked());
+  }
+  domain->collect_all();
+
+  // the reader holds the epoch back, so nothing retired after it pinned is
+  // deleted
+  ASSERT_LE(domain->epoch(), pinned_at + 1);
+  ASSERT_EQ(tracked::alive, 1000);
+
+  reader.reset();
+  domain->collect_all();
+  ASSERT_EQ(tracked::alive, 0);
+}
+
+TEST_F(EpochDomain, DeletesEverythingWhenDestroyed) {  // NOLINT
+  {
+    epoch_domain::guard guard(*domain);
+    for (int i = 0; i < 10; i++) {
+      guard.retire(new tracked());
+    }
+  }
+  domain.reset();
+  ASSERT_EQ(tracked::alive, 0);
+}
+
+TEST_F(EpochDomain, WorksAcrossThreads) {  // NOLINT
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([this] {
+      for (int i = 0; i < 10000; i++) {
+        epoch_domain::guard guard(*domain);
+        guard.retire(new tracked());
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  domain->collect_all();
+  ASSERT_EQ(tracked::alive, 0);
+}
+
+}  // namespace
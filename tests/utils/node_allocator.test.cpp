@@ -0,0 +1,94 @@
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/node_allocator.hpp>
+
+using dads::utils::pool_allocator;
+
+namespace {
+
+struct node {
+  long key;
+  node *left;
+  node *right;
+};
+
+class PoolAllocator : public ::testing::Test {
+ protected:
+  std::unique_ptr<pool_allocator<node>> pool;
+  void SetUp() override { pool = std::make_unique<pool_allocator<node>>(); }
+};
+
+TEST_F(PoolAllocator, GivesOutDistinctNodes) {  // NOLINT
+  std::set<node *> nodes;
+  for (int i = 0; i < 10000; i++) {
+    node *n = pool->allocate();
+    n->key = i;
+    ASSERT_TRUE(nodes.insert(n).second);
+  }
+
+  // the chunks grow, so 10000 nodes fit in a handful of them
+  ASSERT_LT(pool->chunk_count(), 10);
+}
+
+TEST_F(PoolAllocator, ReusesFreedNodes) {  // NOLINT
+  node *a = pool->allocate();
+  node *b = pool->allocate();
+  pool->deallocate(a);
+  pool->deallocate(b);
+
+  // the free list is last-in first-out
+  ASSERT_EQ(pool->allocate(), b);
+  ASSERT_EQ(pool->allocate(), a);
+}
+
+TEST_F(PoolAllocator, ReservesContiguousNodes) {  // NOLINT
+  pool->allocate();
+  pool->reserve(100000);
+
+  node *first = pool->allocate();
+  for (int i = 1; i < 100000; i++) {
+    ASSERT_EQ(pool->allocate(), first + i);
+  }
+  ASSERT_EQ(pool->chunk_count(), 2);
+}
+
+TEST_F(PoolAllocator, CanBeReleased) {  // NOLINT
+  for (int i = 0; i < 1000; i++) {
+    pool->allocate();
+  }
+  pool->release();
+  ASSERT_EQ(pool->chunk_count(), 0);
+
+  node *n = pool->allocate();
+  n->key = 1;
+  ASSERT_EQ(pool->chunk_count(), 1);
+}
+
+TEST_F(PoolAllocator, MovesItsChunks) {  // NOLINT
+  node *a = pool->allocate();
+  node *b = pool->allocate();
+  pool->deallocate(a);
+
+  pool_allocator<node> moved(std::move(*pool));
+  ASSERT_EQ(moved.chunk_count(), 1);
+  ASSERT_EQ(moved.allocate(), a);
+
+  // the moved-from allocator starts over with chunks of its own
+  ASSERT_EQ(pool->chunk_count(), 0);
+  node *c = pool->allocate();
+  ASSERT_NE(c, a);
+  ASSERT_NE(c, b);
+  ASSERT_EQ(pool->chunk_count(), 1);
+
+  *pool = std::move(moved);
+  ASSERT_EQ(pool->chunk_count(), 1);
+  ASSERT_EQ(moved.chunk_count(), 0);
+  ASSERT_EQ(pool->allocate(), b + 1);
+}
+
+}  // namespace
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/radix_heap.hpp>
+
+using dads::utils::radix_heap;
+
+namespace {
+
+class RadixHeap : public ::testing::Test {
+ protected:
+  std::unique_ptr<radix_heap<int>> heap;
+  void SetUp() override { heap = std::make_unique<radix_heap<int>>(); }
+};
+
+TEST_F(RadixHeap, PopsSmallestFirst) {  // NOLINT
+  heap->push(7, 70);
+  heap->push(3, 30);
+  heap->push(12, 120);
+  heap->push(3, 31);
+
+  ASSERT_EQ(heap->size(), 4);
+  ASSERT_EQ(heap->top_key(), 3);
+  ASSERT_EQ(heap->pop().first, 3);
+  ASSERT_EQ(heap->pop().first, 3);
+  ASSERT_EQ(heap->pop(), std::make_pair(uint64_t{7}, 70));
+  ASSERT_EQ(heap->pop(), std::make_pair(uint64_t{12}, 120));
+  ASSERT_TRUE(heap->empty());
+}
+
+TEST_F(RadixHeap, HandlesMonotoneInterleaving) {  // NOLINT
+  // like dijkstra, keys pushed after a pop are at least the popped key
+  std::mt19937 rng(3);
+  std::vector<uint64_t> popped;
+  heap->push(0, 0);
+  for (int i = 0; i < 5000; i++) {
+    const uint64_t k = heap->pop().first;
+    popped.push_back(k);
+    heap->push(k + rng() % 100, i);
+    heap->push(k + rng() % 100000, i);
+  }
+
+  ASSERT_TRUE(std::is_sorted(std::begin(popped), std::end(popped)));
+}
+
+TEST_F(RadixHeap, HandlesFullWidthKeys) {  // NOLINT
+  // keys with the top bit set land in the last bucket
+  const uint64_t big = uint64_t{1} << 63;
+  heap->push(big + 1, 1);
+  heap->push(big, 0);
+
+  ASSERT_EQ(heap->top_key(), big);
+  ASSERT_EQ(heap->pop(), std::make_pair(big, 0));
+  ASSERT_EQ(heap->pop(), std::make_pair(big + 1, 1));
+  ASSERT_TRUE(heap->empty());
+}
+
+TEST_F(RadixHeap, RejectsDecreasingKeys) {  // NOLINT
+  heap->push(10, 0);
+  heap->pop();
+  ASSERT_THROW(heap->push(5, 0), std::invalid_argument);
+}
+
+}  // namespace
@@ -0,0 +1,73 @@
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/thread_pool.hpp>
+
+using dads::utils::thread_pool;
+
+namespace {
+
+class ThreadPool : public ::testing::Test {
+ protected:
+  std::unique_ptr<thread_pool> pool;
+  void SetUp() override { pool = std::make_unique<thread_pool>(4); }
+};
+
+TEST_F(ThreadPool, RunsOnEveryWorker) {  // NOLINT
+  ASSERT_EQ(pool->size(), 4);
+
+  std::vector<std::atomic<int>> runs(pool->size());
+  pool->run([&runs](std::size_t worker) { runs[worker]++; });
+
+  for (auto &r : runs) {
+    ASSERT_EQ(r, 1);
+  }
+}
+
+TEST_F(ThreadPool, ParallelForVisitsEveryIndexOnce) {  // NOLINT
+  std::vector<std::atomic<int>> hits(100000);
+  pool->parallel_for(0, hits.size(), [&hits](std::size_t i) { hits[i]++; }, 7);
+
+  for (auto &h : hits) {
+    ASSERT_EQ(h, 1);
+  }
+}
+
+TEST_F(ThreadPool, CanRunManyJobs) {  // NOLINT
+  std::atomic<long> sum{0};
+  for (int job = 0; job < 100; job++) {
+    pool->parallel_for(0, 1000, [&sum](std::size_t i) { sum += i; }, 10);
+  }
+
+  ASSERT_EQ(sum, 100L * 999 * 1000 / 2);
+}
+
+TEST_F(ThreadPool, RethrowsExceptions) {  // NOLINT
+  ASSERT_THROW(pool->run([](std::size_t worker) {
+    if (worker == 2) {
+      throw std::runtime_error("worker failed");
+    }
+  }),
+               std::runtime_error);
+
+  // the pool still works afterwards
+  std::atomic<int> runs{0};
+  pool->run([&runs](std::size_t /*worker*/) { runs++; });
+  ASSERT_EQ(runs, 4);
+}
+
+TEST(ThreadPoolOfOne, RunsOnTheCaller) {  // NOLINT
+  thread_pool pool(1);
+  ASSERT_EQ(pool.size(), 1);
+
+  std::vector<int> order;
+  pool.parallel_for(0, 5, [&order](std::size_t i) { order.push_back(i); }, 2);
+  ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+}  // namespace
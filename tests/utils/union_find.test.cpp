@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/union_find.hpp>
+#include <utils/thread_pool.hpp>
+
+using dads::utils::concurrent_union_find;
+
+namespace {
+
+class UnionFind : public ::testing::Test {
+ protected:
+  std::unique_ptr<concurrent_union_find> sets;
+  void SetUp() override {
+    sets = std::make_unique<concurrent_union_find>(10);
+  }
+};
+
+TEST_F(UnionFind, StartsWithSingletons) {  // NOLINT
+  ASSERT_EQ(sets->size(), 10);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(sets->find(i), i);
+  }
+  ASSERT_FALSE(sets->same(1, 2));
+}
+
+TEST_F(UnionFind, CanUniteSets) {  // NOLINT
+  ASSERT_TRUE(sets->unite(3, 7));
+  ASSERT_TRUE(sets->unite(7, 9));
+  ASSERT_FALSE(sets->unite(9, 3));
+  ASSERT_TRUE(sets->unite(5, 1));
+
+  ASSERT_TRUE(sets->same(3, 9));
+  ASSERT_TRUE(sets->same(5, 1));
+  ASSERT_FALSE(sets->same(1, 3));
+
+  // the smallest element names the set
+  ASSERT_EQ(sets->find(9), 3);
+  ASSERT_EQ(sets->find(5), 1);
+}
+
+TEST_F(UnionFind, CompressPointsAtTheRoots) {  // NOLINT
+  for (int i = 9; i > 0; i--) {
+    sets->unite(i, i - 1);
+  }
+  sets->compress();
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(sets->parent_of(i), 0);
+  }
+}
+
+TEST(UnionFind_Concurrent, AgreesOnTheSets) {  // NOLINT
+  // every thread joins the same pairs, in a different order, so the sets
+  // end up as the numbers with the same remainder mod 7
+  constexpr int n = 20000;
+  concurrent_union_find sets(n);
+  dads::utils::thread_pool pool(4);
+
+  pool.run([&sets](std::size_t worker) {
+    for (int i = 0; i + 7 < n; i++) {
+      const int a = (i * 13 + worker * 101) % (n - 7);
+      sets.unite(a + 7, a);
+    }
+  });
+
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(sets.find(i), i % 7);
+  }
+}
+
+}  // namespace